@@ -0,0 +1,137 @@
+//- -----------------------------------------------------------------------------------------------------------------------
+// AskSin driver implementation
+// 2013-08-03 <trilu@gmx.de> Creative Commons - http://creativecommons.org/licenses/by-nc-sa/3.0/de/
+//- -----------------------------------------------------------------------------------------------------------------------
+//- AskSin AES-128 functions ----------------------------------------------------------------------------------------------
+//- -----------------------------------------------------------------------------------------------------------------------
+
+#include "AES.h"
+
+s_aesStat aesStat;
+
+static const uint8_t sBox[256] PROGMEM = {
+	0x63,0x7c,0x77,0x7b,0xf2,0x6b,0x6f,0xc5,0x30,0x01,0x67,0x2b,0xfe,0xd7,0xab,0x76,
+	0xca,0x82,0xc9,0x7d,0xfa,0x59,0x47,0xf0,0xad,0xd4,0xa2,0xaf,0x9c,0xa4,0x72,0xc0,
+	0xb7,0xfd,0x93,0x26,0x36,0x3f,0xf7,0xcc,0x34,0xa5,0xe5,0xf1,0x71,0xd8,0x31,0x15,
+	0x04,0xc7,0x23,0xc3,0x18,0x96,0x05,0x9a,0x07,0x12,0x80,0xe2,0xeb,0x27,0xb2,0x75,
+	0x09,0x83,0x2c,0x1a,0x1b,0x6e,0x5a,0xa0,0x52,0x3b,0xd6,0xb3,0x29,0xe3,0x2f,0x84,
+	0x53,0xd1,0x00,0xed,0x20,0xfc,0xb1,0x5b,0x6a,0xcb,0xbe,0x39,0x4a,0x4c,0x58,0xcf,
+	0xd0,0xef,0xaa,0xfb,0x43,0x4d,0x33,0x85,0x45,0xf9,0x02,0x7f,0x50,0x3c,0x9f,0xa8,
+	0x51,0xa3,0x40,0x8f,0x92,0x9d,0x38,0xf5,0xbc,0xb6,0xda,0x21,0x10,0xff,0xf3,0xd2,
+	0xcd,0x0c,0x13,0xec,0x5f,0x97,0x44,0x17,0xc4,0xa7,0x7e,0x3d,0x64,0x5d,0x19,0x73,
+	0x60,0x81,0x4f,0xdc,0x22,0x2a,0x90,0x88,0x46,0xee,0xb8,0x14,0xde,0x5e,0x0b,0xdb,
+	0xe0,0x32,0x3a,0x0a,0x49,0x06,0x24,0x5c,0xc2,0xd3,0xac,0x62,0x91,0x95,0xe4,0x79,
+	0xe7,0xc8,0x37,0x6d,0x8d,0xd5,0x4e,0xa9,0x6c,0x56,0xf4,0xea,0x65,0x7a,0xae,0x08,
+	0xba,0x78,0x25,0x2e,0x1c,0xa6,0xb4,0xc6,0xe8,0xdd,0x74,0x1f,0x4b,0xbd,0x8b,0x8a,
+	0x70,0x3e,0xb5,0x66,0x48,0x03,0xf6,0x0e,0x61,0x35,0x57,0xb9,0x86,0xc1,0x1d,0x9e,
+	0xe1,0xf8,0x98,0x11,0x69,0xd9,0x8e,0x94,0x9b,0x1e,0x87,0xe9,0xce,0x55,0x28,0xdf,
+	0x8c,0xa1,0x89,0x0d,0xbf,0xe6,0x42,0x68,0x41,0x99,0x2d,0x0f,0xb0,0x54,0xbb,0x16,
+};
+static const uint8_t rBox[256] PROGMEM = {													// inverse of sBox
+	0x52,0x09,0x6a,0xd5,0x30,0x36,0xa5,0x38,0xbf,0x40,0xa3,0x9e,0x81,0xf3,0xd7,0xfb,
+	0x7c,0xe3,0x39,0x82,0x9b,0x2f,0xff,0x87,0x34,0x8e,0x43,0x44,0xc4,0xde,0xe9,0xcb,
+	0x54,0x7b,0x94,0x32,0xa6,0xc2,0x23,0x3d,0xee,0x4c,0x95,0x0b,0x42,0xfa,0xc3,0x4e,
+	0x08,0x2e,0xa1,0x66,0x28,0xd9,0x24,0xb2,0x76,0x5b,0xa2,0x49,0x6d,0x8b,0xd1,0x25,
+	0x72,0xf8,0xf6,0x64,0x86,0x68,0x98,0x16,0xd4,0xa4,0x5c,0xcc,0x5d,0x65,0xb6,0x92,
+	0x6c,0x70,0x48,0x50,0xfd,0xed,0xb9,0xda,0x5e,0x15,0x46,0x57,0xa7,0x8d,0x9d,0x84,
+	0x90,0xd8,0xab,0x00,0x8c,0xbc,0xd3,0x0a,0xf7,0xe4,0x58,0x05,0xb8,0xb3,0x45,0x06,
+	0xd0,0x2c,0x1e,0x8f,0xca,0x3f,0x0f,0x02,0xc1,0xaf,0xbd,0x03,0x01,0x13,0x8a,0x6b,
+	0x3a,0x91,0x11,0x41,0x4f,0x67,0xdc,0xea,0x97,0xf2,0xcf,0xce,0xf0,0xb4,0xe6,0x73,
+	0x96,0xac,0x74,0x22,0xe7,0xad,0x35,0x85,0xe2,0xf9,0x37,0xe8,0x1c,0x75,0xdf,0x6e,
+	0x47,0xf1,0x1a,0x71,0x1d,0x29,0xc5,0x89,0x6f,0xb7,0x62,0x0e,0xaa,0x18,0xbe,0x1b,
+	0xfc,0x56,0x3e,0x4b,0xc6,0xd2,0x79,0x20,0x9a,0xdb,0xc0,0xfe,0x78,0xcd,0x5a,0xf4,
+	0x1f,0xdd,0xa8,0x33,0x88,0x07,0xc7,0x31,0xb1,0x12,0x10,0x59,0x27,0x80,0xec,0x5f,
+	0x60,0x51,0x7f,0xa9,0x19,0xb5,0x4a,0x0d,0x2d,0xe5,0x7a,0x9f,0x93,0xc9,0x9c,0xef,
+	0xa0,0xe0,0x3b,0x4d,0xae,0x2a,0xf5,0xb0,0xc8,0xeb,0xbb,0x3c,0x83,0x53,0x99,0x61,
+	0x17,0x2b,0x04,0x7e,0xba,0x77,0xd6,0x26,0xe1,0x69,0x14,0x63,0x55,0x21,0x0c,0x7d,
+};
+
+static inline uint8_t xtime(uint8_t x) {													// multiply by 2 in GF(2^8)
+	return (x << 1) ^ ((x & 0x80) ? 0x1b : 0x00);
+}
+static void addRoundKey(uint8_t *b, const uint8_t *k) {
+	for (uint8_t i = 0; i < aesBlockLen; i++) b[i] ^= k[i];
+}
+static void subShift(uint8_t *b) {
+	// sub bytes and shift rows in one go, the state is column wise, b[row + 4*col]
+	uint8_t t;
+	for (uint8_t i = 0; i < aesBlockLen; i++) b[i] = _pgmB(sBox[b[i]]);
+	t = b[1];  b[1]  = b[5];  b[5]  = b[9];  b[9]  = b[13]; b[13] = t;						// row 1, one to the left
+	t = b[2];  b[2]  = b[10]; b[10] = t;    t = b[6];  b[6]  = b[14]; b[14] = t;			// row 2, two to the left
+	t = b[15]; b[15] = b[11]; b[11] = b[7];  b[7]  = b[3];  b[3]  = t;						// row 3, three to the left
+}
+static void invSubShift(uint8_t *b) {
+	uint8_t t;
+	t = b[13]; b[13] = b[9];  b[9]  = b[5];  b[5]  = b[1];  b[1]  = t;
+	t = b[2];  b[2]  = b[10]; b[10] = t;    t = b[6];  b[6]  = b[14]; b[14] = t;
+	t = b[3];  b[3]  = b[7];  b[7]  = b[11]; b[11] = b[15]; b[15] = t;
+	for (uint8_t i = 0; i < aesBlockLen; i++) b[i] = _pgmB(rBox[b[i]]);
+}
+static void mixColumns(uint8_t *b) {
+	for (uint8_t c = 0; c < aesBlockLen; c += 4) {
+		uint8_t a0 = b[c], a1 = b[c+1], a2 = b[c+2], a3 = b[c+3];
+		uint8_t x = a0 ^ a1 ^ a2 ^ a3;
+		b[c]   ^= x ^ xtime(a0 ^ a1);
+		b[c+1] ^= x ^ xtime(a1 ^ a2);
+		b[c+2] ^= x ^ xtime(a2 ^ a3);
+		b[c+3] ^= x ^ xtime(a3 ^ a0);
+	}
+}
+static void invMixColumns(uint8_t *b) {
+	// the inverse matrix is the forward one times {04 00 05 00}, so a cheap pre step and mixColumns do the job. no
+	// multiplication by 9, 11, 13 or 14 and no tables for it
+	for (uint8_t c = 0; c < aesBlockLen; c += 4) {
+		uint8_t u = xtime(xtime(b[c]   ^ b[c+2]));
+		uint8_t v = xtime(xtime(b[c+1] ^ b[c+3]));
+		b[c]   ^= u;
+		b[c+1] ^= v;
+		b[c+2] ^= u;
+		b[c+3] ^= v;
+	}
+	mixColumns(b);
+}
+
+// public:		//---------------------------------------------------------------------------------------------------------
+void aesKey(const uint8_t *key, uint8_t *rk) {
+	memcpy(rk, key, aesBlockLen);
+
+	uint8_t rcon = 0x01;
+	for (uint8_t i = aesBlockLen; i < aesKeyLen; i += 4) {
+		uint8_t t0 = rk[i-4], t1 = rk[i-3], t2 = rk[i-2], t3 = rk[i-1];
+		if ((i & 0x0f) == 0) {																// first word of a round key, rotate, sub and rcon
+			uint8_t t = t0;
+			t0 = _pgmB(sBox[t1]) ^ rcon;
+			t1 = _pgmB(sBox[t2]);
+			t2 = _pgmB(sBox[t3]);
+			t3 = _pgmB(sBox[t]);
+			rcon = xtime(rcon);
+		}
+		rk[i]   = rk[i-16] ^ t0;
+		rk[i+1] = rk[i-15] ^ t1;
+		rk[i+2] = rk[i-14] ^ t2;
+		rk[i+3] = rk[i-13] ^ t3;
+	}
+	aesStat.keys++;
+}
+void aesEncrypt(const uint8_t *rk, uint8_t *b) {
+	addRoundKey(b, rk);
+	for (uint8_t r = 1; r < 10; r++) {
+		subShift(b);
+		mixColumns(b);
+		addRoundKey(b, rk + (r << 4));
+	}
+	subShift(b);
+	addRoundKey(b, rk + 160);
+	aesStat.blocks++;
+}
+void aesDecrypt(const uint8_t *rk, uint8_t *b) {
+	addRoundKey(b, rk + 160);
+	for (uint8_t r = 9; r > 0; r--) {
+		invSubShift(b);
+		addRoundKey(b, rk + (r << 4));
+		invMixColumns(b);
+	}
+	invSubShift(b);
+	addRoundKey(b, rk);
+	aesStat.blocks++;
+}
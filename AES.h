@@ -0,0 +1,30 @@
+//- -----------------------------------------------------------------------------------------------------------------------
+// AskSin driver implementation
+// 2013-08-03 <trilu@gmx.de> Creative Commons - http://creativecommons.org/licenses/by-nc-sa/3.0/de/
+//- -----------------------------------------------------------------------------------------------------------------------
+//- AskSin AES-128 functions ----------------------------------------------------------------------------------------------
+//- byte wise AES-128 for the HomeMatic signature, small enough for an ATmega. the key schedule is expanded once into a
+//- buffer of aesKeyLen bytes, encrypt and decrypt work on that buffer and never expand the key again. AS keeps only the
+//- 16 byte temp key of a challenge, the schedule lives on the stack while the challenge or the answer is worked on.
+//- the s-boxes live in PROGMEM.
+//- -----------------------------------------------------------------------------------------------------------------------
+
+#ifndef _AES_H
+#define _AES_H
+
+#include "HAL.h"
+
+#define aesBlockLen   16						// bytes of a block and of the key
+#define aesKeyLen     176						// bytes of the expanded key, 11 round keys
+
+struct s_aesStat {
+	uint32_t keys;								// key expansions
+	uint32_t blocks;							// encrypted or decrypted blocks
+};
+extern s_aesStat aesStat;
+
+extern void aesKey(const uint8_t *key, uint8_t *rk);	// expand a 16 byte key into rk, aesKeyLen bytes
+extern void aesEncrypt(const uint8_t *rk, uint8_t *b);	// encrypt one block in place
+extern void aesDecrypt(const uint8_t *rk, uint8_t *b);	// decrypt one block in place
+
+#endif
@@ -7,12 +7,15 @@
 //- -----------------------------------------------------------------------------------------------------------------------
 
 #define AS_DBG
-#define RV_DBG_EX
+#define AS_TRC 1																			// trace level, see Trace.h
+#define RV_DBG_EX																			// explainMessage, used by the trace decoder on the host
 
 #include "AS.h"
 
 waitTimer cnfTmr;																			// config timer functionality
 waitTimer pairTmr;																			// pair timer functionality
+waitTimer stsTmr;																			// status window of sendStatList
+s_stsStat stsStat;
 
 // public:		//---------------------------------------------------------------------------------------------------------
 AS::AS() {
@@ -26,12 +29,14 @@ void AS::init(void) {
 	initLeds();																				// initialize the leds
 	initConfKey();																			// initialize the port for getting config key interrupts
 
+	rg.init(this);																			// module registrar, before ee.init() as everyTimeStart() registers the modules
 	ee.init();																				// eeprom init
 	cc.init();																				// init the rf module
+	initGroups();																			// group ids out of the peer table, for the receive filter
+	memcpy(aes.key, HMKEY, aesBlockLen);													// whitens the first challenge, see sendAES_REQ
 
 	sn.init(this);																			// send module
 	rv.init(this);																			// receive module
-	rg.init(this);																			// module registrar
 	confButton.init(this);																	// config button
 	pw.init(this);																			// power management
 	bt.init(this);																			// battery check
@@ -44,10 +49,12 @@ void AS::init(void) {
 void AS::poll(void) {
 
 	// check if something received
-	if (ccGetGDO0()) {																		// check if something was received
-		cc.rcvData(rv.buf);																	// copy the data into the receiver module
-		if (rv.hasData) decode(rv.buf);														// decode the string
+	if ((cc.txStat == CC_TX_IDLE) && (ccGetGDO0())) {										// interrupt found the cc1101 busy, read the fifo now
+		ccSetBusy(1);																		// a new end of packet waits for the next loop
+		rv.rcvISR();
+		ccSetBusy(0);
 	}
+	if (!rv.hasData) rv.pop();																// take the next frame from the ring, it is decoded already
 
 	// handle send and receive buffer
 	if (rv.hasData) rv.poll();																// check if there is something in the received buffer
@@ -56,6 +63,7 @@ void AS::poll(void) {
 	// handle the slice send functions
 	if (stcSlice.active) sendSliceList();													// poll the slice list send function
 	if (stcPeer.active) sendPeerMsg();														// poll the peer message sender
+	if (stcStat.active) sendStatList();														// poll the collected actuator status
 	
 	// time out the config flag
 	if (cFlag.active) {																		// check only if we are still in config mode
@@ -75,6 +83,8 @@ void AS::poll(void) {
 	confButton.poll();																		// poll the config button
 	ld.poll();																				// poll the led's
 	bt.poll();																				// poll the battery check
+	flushEEProm(0);																			// write the next buffered eeprom byte
+	if ((!rv.hasData) && (cc.txStat == CC_TX_IDLE)) trcPoll();								// the trace goes out while nothing else is to do
 		
 	// check if we could go to standby
 	pw.poll();																				// poll the power management
@@ -106,7 +116,7 @@ void AS::sendDEVICE_INFO(void) {
 	memcpy_P(sn.buf+10,devDef.devIdnt,3);
 	memcpy(sn.buf+13,HMSR,10);
 	memcpy_P(sn.buf+23,devDef.devIdnt+3,4);
-	sn.active = 1;																			// fire the message
+	sn.push(sndPrioConfig);																	// fire the message
 
 	pairActive = 1;																			// set pairing flag
 	pairTmr.set(20000);
@@ -123,11 +133,14 @@ void AS::sendACK(void) {
 
 	sn.mBdy.mLen = 0x0a;
 	sn.mBdy.mCnt = rv.mBdy.mCnt;
+	sn.mBdy.mFlg.BIDI = 0;																	// an ACK never asks for an ACK
 	sn.mBdy.mTyp = 0x02;
 	memcpy(sn.mBdy.reID, HMID, 3);
 	memcpy(sn.mBdy.toID, rv.mBdy.reID, 3);
 	sn.mBdy.by10 = 0x00;
-	sn.active = 1;																			// fire the message
+	addAuth();																				// signed command, the ACK proves it
+	setReplySlot();																			// group frame, members answer one after the other
+	sn.push(sndPrioACK);																	// fire the message
 	// --------------------------------------------------------------------
 }
 void AS::sendACK_STATUS(uint8_t cnl, uint8_t stat, uint8_t dul) {
@@ -153,8 +166,10 @@ void AS::sendACK_STATUS(uint8_t cnl, uint8_t stat, uint8_t dul) {
 	sn.mBdy.by11 = cnl;
 	sn.mBdy.pyLd[0] = stat;
 	sn.mBdy.pyLd[1] = dul | (bt.getStatus() << 7);
-	sn.mBdy.pyLd[2] = cc.rssi;
-	sn.active = 1;																			// fire the message
+	sn.mBdy.pyLd[2] = rv.rssi;
+	addAuth();																				// signed command, the ACK proves it
+	setReplySlot();																			// group frame, members answer one after the other
+	sn.push(sndPrioACK);																	// fire the message
 	// --------------------------------------------------------------------
 }
 void AS::sendNACK(void) {
@@ -165,11 +180,12 @@ void AS::sendNACK(void) {
 
 	sn.mBdy.mLen = 0x0a;
 	sn.mBdy.mCnt = rv.mBdy.mLen;
+	sn.mBdy.mFlg.BIDI = 0;																	// an ACK never asks for an ACK
 	sn.mBdy.mTyp = 0x02;
 	memcpy(sn.mBdy.reID,HMID,3);
 	memcpy(sn.mBdy.toID,rv.mBdy.reID,3);
 	sn.mBdy.by10 = 0x80;
-	sn.active = 1;																			// fire the message
+	sn.push(sndPrioACK);																	// fire the message
 	// --------------------------------------------------------------------
 }
 void AS::sendNACK_TARGET_INVALID(void) {
@@ -180,11 +196,12 @@ void AS::sendNACK_TARGET_INVALID(void) {
 
 	sn.mBdy.mLen = 0x0a;
 	sn.mBdy.mCnt = rv.mBdy.mLen;
+	sn.mBdy.mFlg.BIDI = 0;																	// an ACK never asks for an ACK
 	sn.mBdy.mTyp = 0x02;
 	memcpy(sn.mBdy.reID,HMID,3);
 	memcpy(sn.mBdy.toID,rv.mBdy.reID,3);
 	sn.mBdy.by10 = 0x84;
-	sn.active = 1;																			// fire the message
+	sn.push(sndPrioACK);																	// fire the message
 	// --------------------------------------------------------------------
 }
 void AS::sendINFO_ACTUATOR_STATUS(uint8_t cnl, uint8_t stat, uint8_t cng) {
@@ -195,12 +212,26 @@ void AS::sendINFO_ACTUATOR_STATUS(uint8_t cnl, uint8_t stat, uint8_t cng) {
 	// l> 0A 40 80 02 63 19 63 1F B7 4A 00 (148804)
 	// do something with the information ----------------------------------
 
-	sn.mBdy.mLen = 0x0e;
+	// an answer to a status request goes out right now, a change of the channel waits in modTbl for the ones of the
+	// other channels, see sendStatList
 	if ((rv.mBdy.mTyp == 0x01) && (rv.mBdy.by11 == 0x0e)) {
-		sn.mBdy.mCnt = rv.mBdy.mCnt;
-	} else {
-		sn.mBdy.mCnt = sn.msgCnt++;
+		pushStatus(cnl, stat, cng, rv.mBdy.mCnt);
+		return;
 	}
+	if ((!cnl) || (cnl > devDef.cnlNbr)) return;
+
+	RG::s_modTable *m = &modTbl[cnl-1];
+	m->stsStat = stat;																		// a status which still waits is replaced
+	m->stsDul = cng;
+	m->stsPend = 1;
+	stsStat.in++;
+	if (!stcStat.active) stsTmr.set(stsWindow);												// first one opens the window
+	stcStat.active = 1;
+	// --------------------------------------------------------------------
+}
+void AS::pushStatus(uint8_t cnl, uint8_t stat, uint8_t cng, uint8_t cnt) {
+	sn.mBdy.mLen = 0x0e;
+	sn.mBdy.mCnt = cnt;
 	sn.mBdy.mFlg.BIDI = (isEmpty(MAID,3))?0:1;
 	
 	sn.mBdy.mTyp = 0x10;
@@ -211,9 +242,8 @@ void AS::sendINFO_ACTUATOR_STATUS(uint8_t cnl, uint8_t stat, uint8_t cng) {
 	sn.mBdy.by11 = cnl;
 	sn.mBdy.pyLd[0] = stat;
 	sn.mBdy.pyLd[1] = cng; // | (bt.getStatus() << 7);
-	sn.mBdy.pyLd[2] = cc.rssi;
-	sn.active = 1;																			// fire the message
-	// --------------------------------------------------------------------
+	sn.mBdy.pyLd[2] = rv.rssi;
+	sn.push(sndPrioStatus);																	// fire the message
 }
 void AS::sendINFO_TEMP(void) {
 	//"10;p01=0A"   => { txt => "INFO_TEMP", params => {
@@ -358,29 +388,29 @@ void AS::sendWeatherEvent(void) {
 // private:		//---------------------------------------------------------------------------------------------------------
 // - poll functions --------------------------------
 void AS::sendSliceList(void) {
-	if (sn.active) return;																	// check if send function has a free slot, otherwise return
+	if (!sn.hasSlot(sndPrioConfig)) return;													// check if send function has a free slot, otherwise return
 
 	uint8_t cnt;
 
 	if        (stcSlice.peer) {			// INFO_PEER_LIST
-		cnt = ee.getPeerListSlc(stcSlice.cnl, stcSlice.curSlc, sn.buf+11);					// get the slice and the amount of bytes
+		cnt = ee.getPeerListSlc(stcSlice.cnl, &stcSlice.pos, sn.buf+11);					// get the slice and the amount of bytes
 		sendINFO_PEER_LIST(cnt);															// create the body
-		stcSlice.curSlc++;																	// increase slice counter
 		//dbg << "peer slc: " << _HEX(sn.buf,sn.buf[0]+1) << '\n';							// write to send buffer
 
 	} else if (stcSlice.reg2) {			// INFO_PARAM_RESPONSE_PAIRS
-		cnt = ee.getRegListSlc(stcSlice.cnl, stcSlice.lst, stcSlice.idx, stcSlice.curSlc, sn.buf+11); // get the slice and the amount of bytes
+		cnt = ee.getRegListSlc(stcSlice.cnl, stcSlice.lst, stcSlice.idx, &stcSlice.pos, sn.buf+11); // get the slice and the amount of bytes
 		//dbg << "cnt: " << cnt << '\n';
 		sendINFO_PARAM_RESPONSE_PAIRS(cnt);
-		stcSlice.curSlc++;																	// increase slice counter
 		//dbg << "reg2 slc: " << _HEX(sn.buf,sn.buf[0]+1) << '\n';							// write to send buffer
 		
 	} else if (stcSlice.reg3) {			// INFO_PARAM_RESPONSE_SEQ
+		cnt = ee.getRegListSeq(stcSlice.cnl, stcSlice.lst, stcSlice.idx, &stcSlice.pos, sn.buf+11); // get the slice and the amount of bytes
+		sendINFO_PARAM_RESPONSE_SEQ(cnt);
 
 	}
 
-	if (stcSlice.curSlc == stcSlice.totSlc) {												// if everything is send, we could empty the struct
-		memset((void*)&stcSlice, 0, 10);													// by memset
+	if (stcSlice.pos == 0xff) {																// if everything is send, we could empty the struct
+		memset((void*)&stcSlice, 0, sizeof(stcSlice));										// by memset
 		//dbg << "end: " << stcSlice.active << stcSlice.peer << stcSlice.reg2 << stcSlice.reg3 << '\n';
 	}
 }
@@ -390,7 +420,7 @@ void AS::sendPeerMsg(void) {
 	if (stcPeer.bidi) maxRetries = 3;
 	else maxRetries = 1;
 	
-	if (sn.active) return;																	// check if send function has a free slot, otherwise return
+	if (!sn.hasSlot(sndPrioPeer)) return;													// check if send function has a free slot, otherwise return
 	
 	// first run, prepare amount of slots
 	if (!stcPeer.maxIdx) {
@@ -404,11 +434,17 @@ void AS::sendPeerMsg(void) {
 		}
 	}
 	
+	// the frame before is through, also the one of the last slot, before the round ends
+	if ((stcPeer.curIdx) && (!(sn.timeOut & _BV(sndPrioPeer)))) {							// peer index is >0, first round done and no timeout
+		uint8_t idx = stcPeer.curIdx-1;
+		stcPeer.slt[idx >> 3] &=  ~(1 << (idx & 0x07));										// clear bit, because message got an ACK
+	}
+
 	// all slots of channel processed, start next round or end processing
 	if (stcPeer.curIdx >= stcPeer.maxIdx) {													// check if all peer slots are done
 		stcPeer.rnd++;																		// increase the round counter
 		
-		if ((stcPeer.rnd >= maxRetries) || (isEmpty(stcPeer.slt,8))) {						// all rounds done or all peers reached
+		if ((stcPeer.rnd >= maxRetries) || (isEmpty(stcPeer.slt, sizeof(stcPeer.slt)))) {	// all rounds done or all peers reached
 			//dbg << "through\n";
 			sn.msgCnt++;																	// increase the send message counter
 			memset((void*)&stcPeer, 0, sizeof(s_stcPeer));									// clean out and return
@@ -419,10 +455,6 @@ void AS::sendPeerMsg(void) {
 
 		}
 		return;
-
-	} else if ((stcPeer.curIdx) && (!sn.timeOut)) {											// peer index is >0, first round done and no timeout
-		uint8_t idx = stcPeer.curIdx-1;
-		stcPeer.slt[idx >> 3] &=  ~(1 << (idx & 0x07));										// clear bit, because message got an ACK
 	}
 	
 	// set respective bit to check if ACK was received
@@ -430,7 +462,7 @@ void AS::sendPeerMsg(void) {
 
 
 	// exit while bit is not set
-	if (!stcPeer.slt[stcPeer.curIdx >> 3] & (1<<(stcPeer.curIdx & 0x07))) {
+	if (!(stcPeer.slt[stcPeer.curIdx >> 3] & (1<<(stcPeer.curIdx & 0x07)))) {
 		stcPeer.curIdx++;																	// increase counter for next time
 		return;
 	}
@@ -438,8 +470,8 @@ void AS::sendPeerMsg(void) {
 	uint8_t tPeer[4];																		// get the respective peer
 	ee.getPeerByIdx(stcPeer.cnl, stcPeer.curIdx, tPeer);
 	
-	#ifdef AS_DBG
-		dbg << "a: " << stcPeer.curIdx << " m " << stcPeer.maxIdx << '\n';
+	#if AS_TRC
+		trcEvent(TRC_AS_PEER, 0, &stcPeer.curIdx, 2);										// curIdx and maxIdx
 	#endif
 
 	if (isEmpty(tPeer,4)) {																	// if peer is 0, set done bit in slt and skip
@@ -456,8 +488,11 @@ void AS::sendPeerMsg(void) {
 	// expectAES       =>{a=>  1.7,s=>0.1,l=>4,min=>0  ,max=>1       ,c=>'lit'      ,f=>''      ,u=>''    ,d=>1,t=>"expect AES"        ,lit=>{off=>0,on=>1}},
 	// fillLvlUpThr    =>{a=>  4.0,s=>1  ,l=>4,min=>0  ,max=>255     ,c=>''         ,f=>''      ,u=>''    ,d=>1,t=>"fill level upper threshold"},
 	// fillLvlLoThr    =>{a=>  5.0,s=>1  ,l=>4,min=>0  ,max=>255     ,c=>''         ,f=>''      ,u=>''    ,d=>1,t=>"fill level lower threshold"},
-	l4_0x01 = *(s_l4_0x01*)ee.getRegAddr(stcPeer.cnl, 4, stcPeer.curIdx, 0x01);
-	
+	*(uint8_t*)&l4_0x01 = ee.getRegAddr(stcPeer.cnl, 4, stcPeer.curIdx, 0x01);
+
+	// a group entry holds the number of members instead of the peer channel, one frame reaches all of them and the
+	// members answer in their reply slots. the slot bit is cleared like for a single peer, when all ACKs came in
+	if (tPeer[3] & grpMark) sn.grpN = tPeer[3] & ~grpMark;
 	prepPeerMsg(tPeer, 1);
 	
 	if (!sn.mBdy.mFlg.BIDI)
@@ -465,6 +500,37 @@ void AS::sendPeerMsg(void) {
 
 	stcPeer.curIdx++;																		// increase counter for next time
 }
+void AS::sendStatList(void) {
+	// the status of every channel which changed within the window goes into the send queue in one pass, a channel
+	// which changed twice sends only its newest status. stsRate limits the frames per second, what is over the limit
+	// waits for the next token and could be replaced again meanwhile
+	if (!stsTmr.done()) return;																// window is still open
+
+	uint16_t per = 1000 / stsRate;															// ms per token
+	uint32_t past = getMillis() - stcStat.refill;
+	if (past >= per) {
+		uint32_t add = past / per;
+		stcStat.tokens = ((uint32_t)stcStat.tokens + add > stsRate) ? stsRate : stcStat.tokens + add;
+		stcStat.refill += add * per;
+	}
+
+	for (uint8_t i = 0; i < devDef.cnlNbr; i++) {
+		RG::s_modTable *m = &modTbl[i];
+		if (!m->stsPend) continue;
+		if (sn.queDepth >= sndQueSize) return;												// queue is full, next loop again
+
+		if (!stcStat.tokens) {																// over the limit, wait for the next token
+			stsStat.held++;
+			stsTmr.set(per - (getMillis() - stcStat.refill));
+			return;
+		}
+		stcStat.tokens--;
+		m->stsPend = 0;
+		stsStat.out++;
+		pushStatus(i+1, m->stsStat, m->stsDul, sn.msgCnt++);
+	}
+	stcStat.active = 0;																		// all out
+}
 void AS::prepPeerMsg(uint8_t *xPeer, uint8_t retr) {
 
 	// description --------------------------------------------------------
@@ -495,386 +561,483 @@ void AS::prepPeerMsg(uint8_t *xPeer, uint8_t retr) {
 	memcpy(sn.buf+11, stcPeer.pL, stcPeer.lenPL);											// payload
 	
 	sn.maxRetr = retr;																		// send only one time
-	sn.active = 1;																			// make send active
+	sn.push(sndPrioPeer);																	// make send active
 }
 
 // - receive functions -----------------------------
+// message table, sorted by message type. within a message type the more specific entry has to come first, because
+// getMsgIdx takes the first matching one. the MSG_ enum below reflects the order of the table and is used by
+// explainMessage to print the parameters of a message.
+#define MSG_BY10     0x01																	// byte 10 has to match
+#define MSG_BY11     0x02																	// byte 11 has to match
+
+#ifdef RV_DBG_EX																			// message names are only needed by explainMessage
+	#define _mn(x)   mn##x
+	static const char mnDEVICE_INFO[]               PROGMEM = "DEVICE_INFO";
+	static const char mnCONFIG_PEER_ADD[]           PROGMEM = "CONFIG_PEER_ADD";
+	static const char mnCONFIG_PEER_REMOVE[]        PROGMEM = "CONFIG_PEER_REMOVE";
+	static const char mnCONFIG_PEER_LIST_REQ[]      PROGMEM = "CONFIG_PEER_LIST_REQ";
+	static const char mnCONFIG_PARAM_REQ[]          PROGMEM = "CONFIG_PARAM_REQ";
+	static const char mnCONFIG_START[]              PROGMEM = "CONFIG_START";
+	static const char mnCONFIG_END[]                PROGMEM = "CONFIG_END";
+	static const char mnCONFIG_WRITE_INDEX[]        PROGMEM = "CONFIG_WRITE_INDEX";
+	static const char mnCONFIG_SERIAL_REQ[]         PROGMEM = "CONFIG_SERIAL_REQ";
+	static const char mnPAIR_SERIAL[]               PROGMEM = "PAIR_SERIAL";
+	static const char mnCONFIG_STATUS_REQUEST[]     PROGMEM = "CONFIG_STATUS_REQUEST";
+	static const char mnACK[]                       PROGMEM = "ACK";
+	static const char mnACK_STATUS[]                PROGMEM = "ACK_STATUS";
+	static const char mnACK2[]                      PROGMEM = "ACK2";
+	static const char mnACK_PROC[]                  PROGMEM = "ACK_PROC";
+	static const char mnNACK[]                      PROGMEM = "NACK";
+	static const char mnNACK_TARGET_INVALID[]       PROGMEM = "NACK_TARGET_INVALID";
+	static const char mnAES_REPLY[]                 PROGMEM = "AES_REPLY";
+	static const char mnTOpHMLAN_SEND_AES_CODE[]    PROGMEM = "TOpHMLAN:SEND_AES_CODE";
+	static const char mnTO_ACTOR_SEND_AES_CODE[]    PROGMEM = "TO_ACTOR:SEND_AES_CODE";
+	static const char mnINFO_SERIAL[]               PROGMEM = "INFO_SERIAL";
+	static const char mnINFO_PEER_LIST[]            PROGMEM = "INFO_PEER_LIST";
+	static const char mnINFO_PARAM_RESPONSE_PAIRS[] PROGMEM = "INFO_PARAM_RESPONSE_PAIRS";
+	static const char mnINFO_PARAM_RESPONSE_SEQ[]   PROGMEM = "INFO_PARAM_RESPONSE_SEQ";
+	static const char mnINFO_PARAMETER_CHANGE[]     PROGMEM = "INFO_PARAMETER_CHANGE";
+	static const char mnINFO_ACTUATOR_STATUS[]      PROGMEM = "INFO_ACTUATOR_STATUS";
+	static const char mnSET[]                       PROGMEM = "SET";
+	static const char mnSTOP_CHANGE[]               PROGMEM = "STOP_CHANGE";
+	static const char mnRESET[]                     PROGMEM = "RESET";
+	static const char mnLED[]                       PROGMEM = "LED";
+	static const char mnLED_ALL[]                   PROGMEM = "LED_ALL";
+	static const char mnLEVEL[]                     PROGMEM = "LEVEL";
+	static const char mnSLEEPMODE[]                 PROGMEM = "SLEEPMODE";
+	static const char mnHAVE_DATA[]                 PROGMEM = "HAVE_DATA";
+	static const char mnSWITCH[]                    PROGMEM = "SWITCH";
+	static const char mnTIMESTAMP[]                 PROGMEM = "TIMESTAMP";
+	static const char mnREMOTE[]                    PROGMEM = "REMOTE";
+	static const char mnSENSOR_EVENT[]              PROGMEM = "SENSOR_EVENT";
+	static const char mnSENSOR_DATA[]               PROGMEM = "SENSOR_DATA";
+	static const char mnCLIMATE_EVENT[]             PROGMEM = "CLIMATE_EVENT";
+	static const char mnWEATHER_EVENT[]             PROGMEM = "WEATHER_EVENT";
+#else
+	#define _mn(x)   NULL
+#endif
+
+enum {
+	MSG_DEVICE_INFO, MSG_CONFIG_PEER_ADD, MSG_CONFIG_PEER_REMOVE, MSG_CONFIG_PEER_LIST_REQ, MSG_CONFIG_PARAM_REQ,
+	MSG_CONFIG_START, MSG_CONFIG_END, MSG_CONFIG_WRITE_INDEX, MSG_CONFIG_SERIAL_REQ, MSG_PAIR_SERIAL,
+	MSG_CONFIG_STATUS_REQUEST, MSG_ACK, MSG_ACK_STATUS, MSG_ACK2, MSG_ACK_PROC, MSG_NACK, MSG_NACK_TARGET_INVALID,
+	MSG_AES_REPLY, MSG_TOpHMLAN_SEND_AES_CODE, MSG_TO_ACTOR_SEND_AES_CODE, MSG_INFO_SERIAL, MSG_INFO_PEER_LIST,
+	MSG_INFO_PARAM_RESPONSE_PAIRS, MSG_INFO_PARAM_RESPONSE_SEQ, MSG_INFO_PARAMETER_CHANGE, MSG_INFO_ACTUATOR_STATUS,
+	MSG_SET, MSG_STOP_CHANGE, MSG_RESET, MSG_LED, MSG_LED_ALL, MSG_LEVEL, MSG_SLEEPMODE, MSG_HAVE_DATA,
+	MSG_SWITCH, MSG_TIMESTAMP, MSG_REMOTE, MSG_SENSOR_EVENT, MSG_SENSOR_DATA, MSG_CLIMATE_EVENT, MSG_WEATHER_EVENT
+};
+
+const AS::s_msgTbl AS::msgTbl[] PROGMEM = {
+	// mTyp, flg,                 by10, by11, name,                               receive handler
+	{ 0x00, 0,                    0x00, 0x00, _mn(DEVICE_INFO),                   NULL,                                 },
+	{ 0x01, MSG_BY11,             0x00, 0x01, _mn(CONFIG_PEER_ADD),               &AS::recvCONFIG_PEER_ADD,             },
+	{ 0x01, MSG_BY11,             0x00, 0x02, _mn(CONFIG_PEER_REMOVE),            &AS::recvCONFIG_PEER_REMOVE,          },
+	{ 0x01, MSG_BY11,             0x00, 0x03, _mn(CONFIG_PEER_LIST_REQ),          &AS::recvCONFIG_PEER_LIST_REQ,        },
+	{ 0x01, MSG_BY11,             0x00, 0x04, _mn(CONFIG_PARAM_REQ),              &AS::recvCONFIG_PARAM_REQ,            },
+	{ 0x01, MSG_BY11,             0x00, 0x05, _mn(CONFIG_START),                  &AS::recvCONFIG_START,                },
+	{ 0x01, MSG_BY11,             0x00, 0x06, _mn(CONFIG_END),                    &AS::recvCONFIG_END,                  },
+	{ 0x01, MSG_BY11,             0x00, 0x08, _mn(CONFIG_WRITE_INDEX),            &AS::recvCONFIG_WRITE_INDEX,          },
+	{ 0x01, MSG_BY11,             0x00, 0x09, _mn(CONFIG_SERIAL_REQ),             &AS::sendINFO_SERIAL,                 },
+	{ 0x01, MSG_BY11,             0x00, 0x0A, _mn(PAIR_SERIAL),                   &AS::recvPAIR_SERIAL,                 },
+	{ 0x01, MSG_BY11,             0x00, 0x0E, _mn(CONFIG_STATUS_REQUEST),         &AS::recvCONFIG_STATUS_REQUEST,       },
+	{ 0x02, MSG_BY10,             0x00, 0x00, _mn(ACK),                           &AS::recvACK,                         },
+	{ 0x02, MSG_BY10,             0x01, 0x00, _mn(ACK_STATUS),                    &AS::recvACK_STATUS,                  },
+	{ 0x02, MSG_BY10,             0x02, 0x00, _mn(ACK2),                          NULL,                                 },
+	{ 0x02, MSG_BY10,             0x04, 0x00, _mn(ACK_PROC),                      NULL,                                 },
+	{ 0x02, MSG_BY10,             0x80, 0x00, _mn(NACK),                          &AS::recvNACK,                        },
+	{ 0x02, MSG_BY10,             0x84, 0x00, _mn(NACK_TARGET_INVALID),           NULL,                                 },
+	{ 0x03, 0,                    0x00, 0x00, _mn(AES_REPLY),                     &AS::recvAES_REPLY,                   },
+	{ 0x04, MSG_BY10,             0x01, 0x00, _mn(TOpHMLAN_SEND_AES_CODE),        NULL,                                 },
+	{ 0x04, 0,                    0x00, 0x00, _mn(TO_ACTOR_SEND_AES_CODE),        NULL,                                 },
+	{ 0x10, MSG_BY10,             0x00, 0x00, _mn(INFO_SERIAL),                   NULL,                                 },
+	{ 0x10, MSG_BY10,             0x01, 0x00, _mn(INFO_PEER_LIST),                NULL,                                 },
+	{ 0x10, MSG_BY10,             0x02, 0x00, _mn(INFO_PARAM_RESPONSE_PAIRS),     NULL,                                 },
+	{ 0x10, MSG_BY10,             0x03, 0x00, _mn(INFO_PARAM_RESPONSE_SEQ),       NULL,                                 },
+	{ 0x10, MSG_BY10,             0x04, 0x00, _mn(INFO_PARAMETER_CHANGE),         NULL,                                 },
+	{ 0x10, MSG_BY10,             0x06, 0x00, _mn(INFO_ACTUATOR_STATUS),          NULL,                                 },
+	{ 0x11, MSG_BY10,             0x02, 0x00, _mn(SET),                           &AS::recvSET,                         },
+	{ 0x11, MSG_BY10,             0x03, 0x00, _mn(STOP_CHANGE),                   NULL,                                 },
+	{ 0x11, MSG_BY10 | MSG_BY11,  0x04, 0x00, _mn(RESET),                         &AS::recvRESET,                       },
+	{ 0x11, MSG_BY10,             0x80, 0x00, _mn(LED),                           NULL,                                 },
+	{ 0x11, MSG_BY10 | MSG_BY11,  0x81, 0x00, _mn(LED_ALL),                       NULL,                                 },
+	{ 0x11, MSG_BY10,             0x81, 0x00, _mn(LEVEL),                         NULL,                                 },
+	{ 0x11, MSG_BY10,             0x82, 0x00, _mn(SLEEPMODE),                     NULL,                                 },
+	{ 0x12, 0,                    0x00, 0x00, _mn(HAVE_DATA),                     NULL,                                 },
+	{ 0x3E, 0,                    0x00, 0x00, _mn(SWITCH),                        &AS::recvPEER_EVENT,                  },
+	{ 0x3F, 0,                    0x00, 0x00, _mn(TIMESTAMP),                     &AS::recvPEER_EVENT,                  },
+	{ 0x40, 0,                    0x00, 0x00, _mn(REMOTE),                        &AS::recvPEER_EVENT,                  },
+	{ 0x41, 0,                    0x00, 0x00, _mn(SENSOR_EVENT),                  &AS::recvPEER_EVENT,                  },
+	{ 0x53, 0,                    0x00, 0x00, _mn(SENSOR_DATA),                   &AS::recvPEER_EVENT,                  },
+	{ 0x58, 0,                    0x00, 0x00, _mn(CLIMATE_EVENT),                 &AS::recvPEER_EVENT,                  },
+	{ 0x70, 0,                    0x00, 0x00, _mn(WEATHER_EVENT),                 &AS::recvPEER_EVENT,                  },
+};
+
+uint8_t AS::getMsgIdx(uint8_t mTyp, uint8_t by10, uint8_t by11) {
+	// binary search for the first entry of the message type, afterwards step through the entries of this message type
+	// and check the subtype bytes. returns the index in msgTbl or 0xff if the message is not known
+	const uint8_t cnt = sizeof(msgTbl) / sizeof(msgTbl[0]);
+	uint8_t lo = 0, hi = cnt;
+	while (lo < hi) {
+		uint8_t mid = (lo + hi) >> 1;
+		if (_pgmB(msgTbl[mid].mTyp) < mTyp) lo = mid + 1;
+		else hi = mid;
+	}
+
+	for ( ; (lo < cnt) && (_pgmB(msgTbl[lo].mTyp) == mTyp); lo++) {
+		uint8_t flg = _pgmB(msgTbl[lo].flg);
+		if ((flg & MSG_BY10) && (_pgmB(msgTbl[lo].by10) != by10)) continue;
+		if ((flg & MSG_BY11) && (_pgmB(msgTbl[lo].by11) != by11)) continue;
+		return lo;
+	}
+	return 0xff;
+}
+
+AS::s_recvFunc AS::getRecvFunc(void) {
+	s_recvFunc recv = NULL;
+
+	uint8_t idx = getMsgIdx(rv.mBdy.mTyp, rv.mBdy.by10, rv.mBdy.by11);						// search the message in the table
+	if (idx != 0xff) memcpy_P(&recv, &msgTbl[idx].recv, sizeof(recv));						// get the handler out of flash
+	else if (rv.mBdy.mTyp >= 0x3E) recv = &AS::recvPEER_EVENT;								// all peer messages go to the channel modules, also unknown ones
+	return recv;
+}
 void AS::recvMessage(void) {
+	s_recvFunc recv = getRecvFunc();
+
+	aes.signd = 0;																			// a new frame, the auth bytes of the last command are gone
+	if (recv) (this->*recv)();																// call the handler, if there is one
+}
+void AS::recvCONFIG_PEER_ADD(void) {
+	// description --------------------------------------------------------
+	//                                  Cnl      PeerID    PeerCnl_A  PeerCnl_B
+	// l> 10 55 A0 01 63 19 63 01 02 04 01   01  1F A6 5C  06         05
+	// do something with the information ----------------------------------
+
 	uint8_t by10 = rv.mBdy.by10 -1;
-	uint8_t cnl1 = cFlag.cnl-1;
 
-	// check which type of message was received
-	if         (rv.mBdy.mTyp == 0x00) {										// DEVICE_INFO
-		// description --------------------------------------------------------
-		//
-		//
-		// do something with the information ----------------------------------
+	ee.remPeer(rv.mBdy.by10, rv.buf+12);													// first call remPeer to avoid doubles
+	uint8_t ret = ee.addPeer(rv.mBdy.by10, rv.buf+12);										// send to addPeer function
+	initGroups();																			// the peer could be a group
 
-		// --------------------------------------------------------------------
+	// let module registrations know of the change
+	if ((ret) && (modTbl[by10].cnl)) {
+		modTbl[by10].mDlgt(rv.mBdy.mTyp, rv.mBdy.by10, rv.mBdy.by11, rv.buf+15, 4);
+	}
 
-	} else if ((rv.mBdy.mTyp == 0x01) && (rv.mBdy.by11 == 0x01)) {			// CONFIG_PEER_ADD
-		// description --------------------------------------------------------
-		//                                  Cnl      PeerID    PeerCnl_A  PeerCnl_B
-		// l> 10 55 A0 01 63 19 63 01 02 04 01   01  1F A6 5C  06         05
-		// do something with the information ----------------------------------
+	if ((ret) && (rv.ackRq)) sendACK();														// send appropriate answer
+	else if (rv.ackRq) sendNACK();
+	// --------------------------------------------------------------------
+}
+void AS::recvCONFIG_PEER_REMOVE(void) {
+	// description --------------------------------------------------------
+	//                                  Cnl      PeerID    PeerCnl_A  PeerCnl_B
+	// l> 10 55 A0 01 63 19 63 01 02 04 01   02  1F A6 5C  06         05
+	// do something with the information ----------------------------------
 
-		ee.remPeer(rv.mBdy.by10, rv.buf+12);												// first call remPeer to avoid doubles
-		uint8_t ret = ee.addPeer(rv.mBdy.by10, rv.buf+12);									// send to addPeer function
+	uint8_t ret = ee.remPeer(rv.mBdy.by10,rv.buf+12);										// call the remPeer function
+	initGroups();																			// the peer could be a group
+	if (rv.ackRq) sendACK();																// send appropriate answer
+	// --------------------------------------------------------------------
+}
+void AS::recvCONFIG_PEER_LIST_REQ(void) {
+	// description --------------------------------------------------------
+	//                                  Cnl
+	// l> 0B 05 A0 01 63 19 63 01 02 04 01  03
+	// do something with the information ----------------------------------
 
-		// let module registrations know of the change
-		if ((ret) && (modTbl[by10].cnl)) {
-			modTbl[by10].mDlgt(rv.mBdy.mTyp, rv.mBdy.by10, rv.mBdy.by11, rv.buf+15, 4);
-		}
+	stcSlice.pos = 0;																		// the slices follow the peer slots in one pass
+	stcSlice.mCnt = rv.mBdy.mCnt;															// remember the message count
+	memcpy(stcSlice.toID, rv.mBdy.reID, 3);
+	stcSlice.cnl = rv.mBdy.by10;															// send input to the send peer function
+	stcSlice.peer = 1;																		// set the type of answer
+	stcSlice.active = 1;																	// start the send function
+	// answer will send from sendsList(void)
+	// --------------------------------------------------------------------
+}
+void AS::recvCONFIG_PARAM_REQ(void) {
+	// description --------------------------------------------------------
+	//                                  Cnl    PeerID    PeerCnl  ParmLst
+	// l> 10 04 A0 01 63 19 63 01 02 04 01  04 00 00 00  00       01
+	// do something with the information ----------------------------------
 
-		if ((ret) && (rv.ackRq)) sendACK();													// send appropriate answer
-		else if (rv.ackRq) sendNACK();
-		// --------------------------------------------------------------------
+	if ((rv.buf[16] == 3) || (rv.buf[16] == 4)) {											// only list 3 and list 4 needs an peer id and idx
+		stcSlice.idx = ee.getIdxByPeer(rv.mBdy.by10, rv.buf+12);							// get peer index
+	} else stcSlice.idx = 0;																// otherwise peer index is 0
+
+	stcSlice.pos = 0;																		// start with the first register
+	stcSlice.totSlc = ee.countRegListSlc(rv.mBdy.by10, rv.buf[16]);							// how many slices are need
+	stcSlice.mCnt = rv.mBdy.mCnt;															// remember the message count
+	memcpy(stcSlice.toID, rv.mBdy.reID, 3);
+	stcSlice.cnl = rv.mBdy.by10;															// send input to the send peer function
+	stcSlice.lst = rv.buf[16];																// send input to the send peer function
+
+	uint8_t seqSlc = ee.countRegListSeq(rv.mBdy.by10, rv.buf[16]);							// lists with runs of registers are shorter
+	if ((seqSlc) && (seqSlc < stcSlice.totSlc)) {											// as offset and data
+		stcSlice.totSlc = seqSlc;
+		stcSlice.reg3 = 1;
+	} else stcSlice.reg2 = 1;																// set the type of answer
+
+	#if AS_TRC
+		uint8_t trc[] = { rv.mBdy.by10, stcSlice.idx, stcSlice.totSlc };
+		trcEvent(TRC_AS_SLICE, 0, trc, sizeof(trc));
+	#endif
 
-	} else if ((rv.mBdy.mTyp == 0x01) && (rv.mBdy.by11 == 0x02)) {			// CONFIG_PEER_REMOVE
-		// description --------------------------------------------------------
-		//                                  Cnl      PeerID    PeerCnl_A  PeerCnl_B
-		// l> 10 55 A0 01 63 19 63 01 02 04 01   02  1F A6 5C  06         05
-		// do something with the information ----------------------------------
-	
-		uint8_t ret = ee.remPeer(rv.mBdy.by10,rv.buf+12);									// call the remPeer function
-		if (rv.ackRq) sendACK();															// send appropriate answer
-		// --------------------------------------------------------------------
-
-	} else if ((rv.mBdy.mTyp == 0x01) && (rv.mBdy.by11 == 0x03)) {			// CONFIG_PEER_LIST_REQ
-		// description --------------------------------------------------------
-		//                                  Cnl
-		// l> 0B 05 A0 01 63 19 63 01 02 04 01  03
-		// do something with the information ----------------------------------
-	
-		stcSlice.totSlc = ee.countPeerSlc(rv.mBdy.by10);									// how many slices are need
-		stcSlice.mCnt = rv.mBdy.mCnt;														// remember the message count
-		memcpy(stcSlice.toID, rv.mBdy.reID, 3);
-		stcSlice.cnl = rv.mBdy.by10;														// send input to the send peer function
-		stcSlice.peer = 1;																	// set the type of answer
-		stcSlice.active = 1;																// start the send function
-		// answer will send from sendsList(void)
-		// --------------------------------------------------------------------
-
-	} else if ((rv.mBdy.mTyp == 0x01) && (rv.mBdy.by11 == 0x04)) {			// CONFIG_PARAM_REQ
-		// description --------------------------------------------------------
-		//                                  Cnl    PeerID    PeerCnl  ParmLst
-		// l> 10 04 A0 01 63 19 63 01 02 04 01  04 00 00 00  00       01
-		// do something with the information ----------------------------------
-		
-		if ((rv.buf[16] == 3) || (rv.buf[16] == 4)) {										// only list 3 and list 4 needs an peer id and idx	
-			stcSlice.idx = ee.getIdxByPeer(rv.mBdy.by10, rv.buf+12);						// get peer index
-		} else stcSlice.idx = 0;															// otherwise peer index is 0
- 
-		stcSlice.totSlc = ee.countRegListSlc(rv.mBdy.by10, rv.buf[16]);						// how many slices are need
-		stcSlice.mCnt = rv.mBdy.mCnt;														// remember the message count
-		memcpy(stcSlice.toID, rv.mBdy.reID, 3);
-		stcSlice.cnl = rv.mBdy.by10;														// send input to the send peer function
-		stcSlice.lst = rv.buf[16];															// send input to the send peer function
-		stcSlice.reg2 = 1;																	// set the type of answer
-		
-		#ifdef AS_DBG
-			dbg << "cnl: " << rv.mBdy.by10 << " s: " << stcSlice.idx << '\n';
-			dbg << "totSlc: " << stcSlice.totSlc << '\n';
-		#endif
+	if ((stcSlice.idx != 0xff) && (stcSlice.totSlc > 0)) stcSlice.active = 1;				// only send register content if something is to send															// start the send function
+	else memset((void*)&stcSlice, 0, sizeof(stcSlice));										// otherwise empty variable
+	// --------------------------------------------------------------------
+}
+void AS::recvCONFIG_START(void) {
+	// description --------------------------------------------------------
+	//                                  Cnl    PeerID    PeerCnl  ParmLst
+	// l> 10 01 A0 01 63 19 63 01 02 04 00  05 00 00 00  00       00
+	// do something with the information ----------------------------------
 
-		if ((stcSlice.idx != 0xff) && (stcSlice.totSlc > 0)) stcSlice.active = 1;			// only send register content if something is to send															// start the send function
-		else memset((void*)&stcSlice, 0, 10);												// otherwise empty variable
-		// --------------------------------------------------------------------
+	cFlag.cnl = rv.mBdy.by10;																// fill structure to remember where to write
+	cFlag.lst = rv.buf[16];
+	if ((cFlag.lst == 3) || (cFlag.lst == 4)) cFlag.idx = ee.getIdxByPeer(rv.mBdy.by10, rv.buf+12);
+	else cFlag.idx = 0;
 
-	} else if ((rv.mBdy.mTyp == 0x01) && (rv.mBdy.by11 == 0x05)) {			// CONFIG_START
-		// description --------------------------------------------------------
-		//                                  Cnl    PeerID    PeerCnl  ParmLst
-		// l> 10 01 A0 01 63 19 63 01 02 04 00  05 00 00 00  00       00
-		// do something with the information ----------------------------------
+	if (cFlag.idx != 0xff) {
+		cFlag.active = 1;																	// set active if there is no error on index
+		cnfTmr.set(20000);																	// set timeout time, will be checked in poll function
+		// todo: set message id flag to config in send module
 
-		cFlag.cnl = rv.mBdy.by10;															// fill structure to remember where to write
-		cFlag.lst = rv.buf[16];
-		if ((cFlag.lst == 3) || (cFlag.lst == 4)) cFlag.idx = ee.getIdxByPeer(rv.mBdy.by10, rv.buf+12);
-		else cFlag.idx = 0;
-		
-		if (cFlag.idx != 0xff) {
-			cFlag.active = 1;																// set active if there is no error on index
-			cnfTmr.set(20000);																// set timeout time, will be checked in poll function
-			// todo: set message id flag to config in send module
-			
-		}
-	
-		if (rv.ackRq) sendACK();															// send appropriate answer
-		// --------------------------------------------------------------------
-
-	} else if ((rv.mBdy.mTyp == 0x01) && (rv.mBdy.by11 == 0x06)) {			// CONFIG_END
-		// description --------------------------------------------------------
-		//                                  Cnl
-		// l> 0B 01 A0 01 63 19 63 01 02 04 00  06
-		// do something with the information ----------------------------------
-
-		cFlag.active = 0;																	// set inactive
-		if ((cFlag.cnl == 0) && (cFlag.idx == 0)) ee.getMasterID();
-		// remove message id flag to config in send module
-
-		if ((cFlag.cnl > 0) && (modTbl[cnl1].cnl)) {
-			// check if a new list1 was written and reload, no need for reload list3/4 because they will be loaded on an peer event
-			if (cFlag.lst == 1) ee.getList(cFlag.cnl, 1, cFlag.idx, modTbl[cnl1].lstCnl); // load list1 in the respective buffer
-			modTbl[cnl1].mDlgt(0x01, 0, 0x06, NULL, 0);								// inform the module of the change
-		}
-		
-		if (rv.ackRq) sendACK();															// send appropriate answer
-		// --------------------------------------------------------------------
+	}
+
+	if (rv.ackRq) sendACK();																// send appropriate answer
+	// --------------------------------------------------------------------
+}
+void AS::recvCONFIG_END(void) {
+	// description --------------------------------------------------------
+	//                                  Cnl
+	// l> 0B 01 A0 01 63 19 63 01 02 04 00  06
+	// do something with the information ----------------------------------
 
-	} else if ((rv.mBdy.mTyp == 0x01) && (rv.mBdy.by11 == 0x08)) {			// CONFIG_WRITE_INDEX
-		// description --------------------------------------------------------
-		//                                  Cnl    Data
-		// l> 13 02 A0 01 63 19 63 01 02 04 00  08 02 01 0A 63 0B 19 0C 63
-		// do something with the information ----------------------------------
+	uint8_t cnl1 = cFlag.cnl-1;
 
-		if ((cFlag.active) && (cFlag.cnl == rv.mBdy.by10)) {								// check if we are in config mode and if the channel fit
-			ee.setListArray(cFlag.cnl, cFlag.lst, cFlag.idx, rv.buf[0]+1-11, rv.buf+12);	// write the string to eeprom
-			
-			if ((cFlag.cnl == 0) && (cFlag.lst == 0)) {										// check if we got somewhere in the string a 0x0a, as indicator for a new masterid
-				uint8_t maIdFlag = 0;				
-				for (uint8_t i = 0; i < (rv.buf[0]+1-11); i+=2) {
-					if (rv.buf[12+i] == 0x0a) maIdFlag = 1;
-					#ifdef AS_DBG
-						dbg << "x" << i << " :" << _HEXB(rv.buf[12+i]) << '\n';
-					#endif
-				}
-				if (maIdFlag) {
-					ee.getMasterID();
-					#ifdef AS_DBG
-						dbg << "new masterid\n" << '\n';
-					#endif
-				}
-				
+	cFlag.active = 0;																		// set inactive
+	if ((cFlag.cnl == 0) && (cFlag.idx == 0)) ee.getMasterID();
+	// remove message id flag to config in send module
+
+	if ((cFlag.cnl > 0) && (modTbl[cnl1].cnl)) {
+		// check if a new list1 was written and reload, no need for reload list3/4 because they will be loaded on an peer event
+		if (cFlag.lst == 1) ee.getList(cFlag.cnl, 1, cFlag.idx, modTbl[cnl1].lstCnl);		// load list1 in the respective buffer
+		modTbl[cnl1].mDlgt(0x01, 0, 0x06, NULL, 0);											// inform the module of the change
+	}
+
+	if (rv.ackRq) sendACK();																// send appropriate answer
+	// --------------------------------------------------------------------
+}
+void AS::recvCONFIG_WRITE_INDEX(void) {
+	// description --------------------------------------------------------
+	//                                  Cnl    Data
+	// l> 13 02 A0 01 63 19 63 01 02 04 00  08 02 01 0A 63 0B 19 0C 63
+	// do something with the information ----------------------------------
+
+	if ((cFlag.active) && (cFlag.cnl == rv.mBdy.by10)) {									// check if we are in config mode and if the channel fit
+		ee.setListArray(cFlag.cnl, cFlag.lst, cFlag.idx, rv.buf[0]+1-11, rv.buf+12);		// write the string to eeprom
+
+		if ((cFlag.cnl == 0) && (cFlag.lst == 0)) {											// check if we got somewhere in the string a 0x0a, as indicator for a new masterid
+			uint8_t maIdFlag = 0;
+			for (uint8_t i = 0; i < (rv.buf[0]+1-11); i+=2) {
+				if (rv.buf[12+i] == 0x0a) maIdFlag = 1;
+				#ifdef AS_DBG
+					dbg << "x" << i << " :" << _HEXB(rv.buf[12+i]) << '\n';
+				#endif
+			}
+			if (maIdFlag) {
+				ee.getMasterID();
+				#ifdef AS_DBG
+					dbg << "new masterid\n" << '\n';
+				#endif
 			}
-		}
-		if (rv.ackRq) sendACK();															// send appropriate answer
-		// --------------------------------------------------------------------
-
-	} else if ((rv.mBdy.mTyp == 0x01) && (rv.mBdy.by11 == 0x09)) {			// CONFIG_SERIAL_REQ
-		// description --------------------------------------------------------
-		//
-		// l> 0B 77 A0 01 63 19 63 01 02 04 00 09
-		// do something with the information ----------------------------------
-		sendINFO_SERIAL();																	// jump to create the answer
-		// --------------------------------------------------------------------
-
-	} else if ((rv.mBdy.mTyp == 0x01) && (rv.mBdy.by11 == 0x0A)) {			// PAIR_SERIAL
-		// description --------------------------------------------------------
-		//                                         serial
-		// b> 15 93 B4 01 63 19 63 00 00 00 01 0A  4B 45 51 30 32 33 37 33 39 36
-		// do something with the information ----------------------------------
-		if (compArray(rv.buf+12,HMSR,10)) sendDEVICE_INFO();								// compare serial and send device info
-		// --------------------------------------------------------------------
-
-	} else if ((rv.mBdy.mTyp == 0x01) && (rv.mBdy.by11 == 0x0E)) {			// CONFIG_STATUS_REQUEST
-		// description --------------------------------------------------------
-		//                 reID      toID      cnl 
-		// l> 0B 40 B0 01  63 19 63  1F B7 4A  01  0E (148552)
-		// l> 0E 40 A4 10 1F B7 4A 63 19 63 06 01 00 00 48 (148679)
-		// l> 0A 40 80 02 63 19 63 1F B7 4A 00 (148804)
-		// do something with the information ----------------------------------
-
-		// check if a module is registered and send the information, otherwise report an empty status
-		if (modTbl[by10].cnl) {
-			modTbl[by10].mDlgt(rv.mBdy.mTyp, rv.mBdy.by10, rv.mBdy.by11, rv.mBdy.pyLd, rv.mBdy.mLen-11);
-		} else {
-			sendINFO_ACTUATOR_STATUS(rv.mBdy.by10, 0, 0);	
-		}
-		// --------------------------------------------------------------------
 
-	} else if ((rv.mBdy.mTyp == 0x02) && (rv.mBdy.by10 == 0x00)) {			// ACK
-		// description --------------------------------------------------------
-		//
-		// l> 0A 05 80 02 63 19 63 01 02 04 00
-		// do something with the information ----------------------------------
-	
-		if ((sn.active) && (rv.mBdy.mCnt == sn.lastMsgCnt)) sn.retrCnt = 0xff;				// was an ACK to an active message, message counter is similar - set retrCnt to 255
-		//dbg << "act:" << sn.active << " rC:" << rv.mBdy.mLen << " sC:" << sn.lastMsgCnt << " cntr:" << sn.retrCnt << '\n';
-		// --------------------------------------------------------------------
-
-	} else if ((rv.mBdy.mTyp == 0x02) && (rv.mBdy.by10 == 0x01)) {			// ACK_STATUS
-		// description --------------------------------------------------------
-		// <- 0B 08 B4 40 23 70 D8 1F B7 4A 02 08
-		//                                      cnl stat DUL RSSI
-		// l> 0E 08 80 02 1F B7 4A 23 70 D8 01  01  C8   80  27
-		// do something with the information ----------------------------------
-		// DUL = UP 10, DOWN 20, LOWBAT 80
-	
-		if ((sn.active) && (rv.mBdy.mLen == sn.lastMsgCnt)) sn.retrCnt = 0xff;				// was an ACK to an active message, message counter is similar - set retrCnt to 255
-		// --------------------------------------------------------------------
-
-	} else if ((rv.mBdy.mTyp == 0x02) && (rv.mBdy.by10 == 0x02)) {			// ACK2
-		// description --------------------------------------------------------
-		//
-		// b>
-		// do something with the information ----------------------------------
-
-		// --------------------------------------------------------------------
-
-	} else if ((rv.mBdy.mTyp == 0x02) && (rv.mBdy.by10 == 0x04)) {			// ACK_PROC
-		// description --------------------------------------------------------
-		//
-		// b>
-		// do something with the information ----------------------------------
-
-		// --------------------------------------------------------------------
-		//Para1          => "02,4",
-		//Para2          => "06,4",
-		//Para3          => "10,4",
-		//Para4          => "14,2",}}, # remote?
-
-	} else if ((rv.mBdy.mTyp == 0x02) && (rv.mBdy.by10 == 0x80)) {			// NACK
-		// description --------------------------------------------------------
-		//
-		// b>
-		// do something with the information ----------------------------------
-
-		// for test
-		static uint8_t x2[2];
-		x2[0] = 0x02;
-		x2[1] += 1;
-		sendREMOTE(1,1,x2);
-
-		// --------------------------------------------------------------------
-
-	} else if ((rv.mBdy.mTyp == 0x02) && (rv.mBdy.by10 == 0x84)) {			// NACK_TARGET_INVALID
-		// description --------------------------------------------------------
-		//
-		// b>
-		// do something with the information ----------------------------------
-
-		// --------------------------------------------------------------------
-
-
-	} else if ((rv.mBdy.mTyp == 0x11) && (rv.mBdy.by10 == 0x02)) {			// SET
-		// description --------------------------------------------------------
-		//                                      cnl  stat  ramp   dura
-		// l> 0E 5E B0 11 63 19 63 1F B7 4A 02  01   C8    00 00  00 00
-		// l> 0E 5E 80 02 1F B7 4A 63 19 63 01 01 C8 80 41 
-		// do something with the information ----------------------------------
-
-		if (modTbl[rv.mBdy.by11-1].cnl) {
-			modTbl[rv.mBdy.by11-1].mDlgt(rv.mBdy.mTyp, rv.mBdy.by10, rv.mBdy.by11, rv.buf+12, rv.mBdy.mLen-11);
 		}
-		// --------------------------------------------------------------------
-
-	} else if ((rv.mBdy.mTyp == 0x11) && (rv.mBdy.by10 == 0x03)) {			// STOP_CHANGE
-		// description --------------------------------------------------------
-		//
-		// b>
-		// do something with the information ----------------------------------
-
-		// --------------------------------------------------------------------
-
-	} else if ((rv.mBdy.mTyp == 0x11) && (rv.mBdy.by10 == 0x04) && (rv.mBdy.by11 == 0x00)) {	// RESET
-		// description --------------------------------------------------------
-		//
-		// l> 0B 1C B0 11 63 19 63 1F B7 4A 04 00 (234116)
-		// l> 0E 1C 80 02 1F B7 4A 63 19 63 01 01 00 80 14 (234243)
-		// do something with the information ----------------------------------
-
-		ee.clearPeers();
-		ee.clearRegs();
-		ee.getMasterID();
-		ld.set(defect);
-
-		uint8_t xI = ee.getRegListIdx(1,3);
-		if (rv.ackRq) {
-			if (xI == 0xff) sendACK();
-			else sendACK_STATUS(0, 0, 0);
-		}
-		// --------------------------------------------------------------------
+	}
+	if (rv.ackRq) sendACK();																// send appropriate answer
+	// --------------------------------------------------------------------
+}
+void AS::recvPAIR_SERIAL(void) {
+	// description --------------------------------------------------------
+	//                                         serial
+	// b> 15 93 B4 01 63 19 63 00 00 00 01 0A  4B 45 51 30 32 33 37 33 39 36
+	// do something with the information ----------------------------------
 
-	} else if ((rv.mBdy.mTyp == 0x11) && (rv.mBdy.by10 == 0x80)) {			// LED
-		// description --------------------------------------------------------
-		//
-		// b>
-		// do something with the information ----------------------------------
+	if (compArray(rv.buf+12,HMSR,10)) sendDEVICE_INFO();									// compare serial and send device info
+	// --------------------------------------------------------------------
+}
+void AS::recvCONFIG_STATUS_REQUEST(void) {
+	// description --------------------------------------------------------
+	//                 reID      toID      cnl
+	// l> 0B 40 B0 01  63 19 63  1F B7 4A  01  0E (148552)
+	// l> 0E 40 A4 10 1F B7 4A 63 19 63 06 01 00 00 48 (148679)
+	// l> 0A 40 80 02 63 19 63 1F B7 4A 00 (148804)
+	// do something with the information ----------------------------------
 
-		// --------------------------------------------------------------------
+	uint8_t by10 = rv.mBdy.by10 -1;
 
-	} else if ((rv.mBdy.mTyp == 0x11) && (rv.mBdy.by10 == 0x81) && (rv.mBdy.by11 == 0x00)) {	// LEDALL
-		// description --------------------------------------------------------
-		//
-		// b>
-		// do something with the information ----------------------------------
+	// check if a module is registered and send the information, otherwise report an empty status
+	if (modTbl[by10].cnl) {
+		modTbl[by10].mDlgt(rv.mBdy.mTyp, rv.mBdy.by10, rv.mBdy.by11, rv.mBdy.pyLd, rv.mBdy.mLen-11);
+	} else {
+		sendINFO_ACTUATOR_STATUS(rv.mBdy.by10, 0, 0);
+	}
+	// --------------------------------------------------------------------
+}
+void AS::recvACK(void) {
+	// description --------------------------------------------------------
+	//
+	// l> 0A 05 80 02 63 19 63 01 02 04 00
+	// do something with the information ----------------------------------
 
-		// --------------------------------------------------------------------
+	if (sn.active) sn.rcvACK(rv.mBdy.mCnt);													// was an ACK to an active message, finish the one with the same message counter
+	// --------------------------------------------------------------------
+}
+void AS::recvACK_STATUS(void) {
+	// description --------------------------------------------------------
+	// <- 0B 08 B4 40 23 70 D8 1F B7 4A 02 08
+	//                                      cnl stat DUL RSSI
+	// l> 0E 08 80 02 1F B7 4A 23 70 D8 01  01  C8   80  27
+	// do something with the information ----------------------------------
+	// DUL = UP 10, DOWN 20, LOWBAT 80
 
-	} else if ((rv.mBdy.mTyp == 0x11) && (rv.mBdy.by10 == 0x81)) {			// LEVEL
-		// description --------------------------------------------------------
-		//
-		// b>
-		// do something with the information ----------------------------------
+	if (sn.active) sn.rcvACK(rv.mBdy.mCnt);													// was an ACK to an active message, finish the one with the same message counter
+	// --------------------------------------------------------------------
+}
+void AS::recvNACK(void) {
+	// description --------------------------------------------------------
+	//
+	// b>
+	// do something with the information ----------------------------------
 
-		// --------------------------------------------------------------------
+	// for test
+	static uint8_t x2[2];
+	x2[0] = 0x02;
+	x2[1] += 1;
+	sendREMOTE(1,1,x2);
+	// --------------------------------------------------------------------
+}
+void AS::recvAES_REPLY(void) {
+	// description --------------------------------------------------------
+	//                 reID      toID      encrypted answer of the central
+	// l> 19 5E A0 03  63 19 63  1F B7 4A  xx xx xx xx xx xx xx xx xx xx xx xx xx xx xx xx
+	// do something with the information ----------------------------------
+	// the central encrypts 6 byte of its own and byte 1 to 10 of the command with the temp key, xors the payload of the
+	// command and encrypts again. both steps are undone here, the bytes 1 to 10 have to come back unchanged
 
-	} else if ((rv.mBdy.mTyp == 0x11) && (rv.mBdy.by10 == 0x82)) {			// SLEEPMODE
-		// description --------------------------------------------------------
-		//
-		// b>
-		// do something with the information ----------------------------------
+	if ((!aes.active) || (rv.mBdy.mLen != 0x19) || (!compArray(rv.mBdy.reID, aes.msg+4, 3))) return;
+	aes.active = 0;
+	sn.rcvACK(rv.mBdy.mCnt);																// the reply answers the challenge
 
-		// --------------------------------------------------------------------
+	uint8_t *p = rv.buf+10;
+	uint8_t ok = ((tMillis)(getMillis() - aes.time) < aesTimeOut);
 
+	uint8_t rk[aesKeyLen];																	// expanded on the stack, it's only needed here
+	aesKey(aes.key, rk);
+	aesDecrypt(rk, p);
+	for (uint8_t i = 0; i < aesBlockLen; i++) {												// payload of the command, padded with 0
+		if ((11+i) <= aes.msg[0]) p[i] ^= aes.msg[11+i];
+	}
+	aesDecrypt(rk, p);
+	if (memcmp(p+6, aes.msg+1, 10)) ok = 0;
 
-	} else if  (rv.mBdy.mTyp == 0x12) {										// HAVE_DATA
-		// description --------------------------------------------------------
-		//
-		// b> 
-		// do something with the information ----------------------------------
+	#if AS_TRC
+		trcEvent(TRC_AS_AES, ok, NULL, 0);
+	#endif
+	if (!ok) return;																		// wrong key or too late, the command is dropped
 
-		// --------------------------------------------------------------------
+	memcpy(aes.auth, p, 4);
+	memcpy(rv.buf, aes.msg, aes.msg[0]+1);													// the command takes the place of the reply
+	memcpy(rv.peerId, rv.mBdy.reID, 3);														// as RV::poll does it
+	rv.peerId[3] = rv.buf[10] & 0x3f;
 
-	} else if  (rv.mBdy.mTyp >= 0x3E) {										// 3E SWITCH, 3F TIMESTAMP, 40 REMOTE, 41 SENSOR_EVENT, 53 SENSOR_DATA, 58 CLIMATE_EVENT, 70 WEATHER_EVENT
-		// description --------------------------------------------------------
-		//                 from      to        cnl  cnt
-		// p> 0B 2D B4 40  23 70 D8  01 02 05  06   05 - Remote
-		// do something with the information ----------------------------------
+	s_recvFunc recv = getRecvFunc();
+	aes.signd = 1;																			// checkAES lets it pass, addAuth adds the auth bytes
+	if (recv) (this->*recv)();
+	// --------------------------------------------------------------------
+}
+void AS::recvSET(void) {
+	// description --------------------------------------------------------
+	//                                      cnl  stat  ramp   dura
+	// l> 0E 5E B0 11 63 19 63 1F B7 4A 02  01   C8    00 00  00 00
+	// l> 0E 5E 80 02 1F B7 4A 63 19 63 01 01 C8 80 41
+	// do something with the information ----------------------------------
 
-		//                 from      to        dst       na  cnl  cnt
-		// m> 0F 18 B0 3E  FD 24 BE  01 02 05  23 70 D8  40  06   00 - Switch
-		//"3E"          => { txt => "SWITCH"      , params => {
-		//				DST      => "00,6",
-		//				UNKNOWN  => "06,2",
-		//				CHANNEL  => "08,2",
-		//				COUNTER  => "10,2", } },
+	if (checkAES(rv.mBdy.by11)) return;														// command runs later, when the signature is checked
 
-		uint8_t cnl = 0, pIdx, tmp;
-		
-		// check if we have the peer in the database to get the channel
-		if ((rv.mBdy.mTyp == 0x3E) && (rv.mBdy.mLen == 0x0f)) {
-			tmp = rv.buf[13];																// save byte13, because we will replace it
-			rv.buf[13] = rv.buf[14];														// copy the channel byte to the peer
-			cnl = ee.isPeerValid(rv.buf+10);												// check with the right part of the string
-			if (cnl) pIdx = ee.getIdxByPeer(cnl, rv.buf+10);								// get the index of the respective peer in the channel store
-			rv.buf[13] = tmp;																// get it back
-
-		} else {
-			cnl = ee.isPeerValid(rv.peerId);
-			if (cnl) pIdx = ee.getIdxByPeer(cnl, rv.peerId);								// get the index of the respective peer in the channel store
-			
-		}
-		//dbg << "cnl: " << cnl << " pIdx: " << pIdx << " mTyp: " << _HEXB(rv.mBdy.mTyp) << " by10: " << _HEXB(rv.mBdy.by10)  << " by11: " << _HEXB(rv.mBdy.by11) << " data: " << _HEX((rv.buf+10),(rv.mBdy.mLen-9)) << '\n'; _delay_ms(100);
-		if (cnl == 0) return;
-		
-		// check if a module is registered and send the information, otherwise report an empty status
-		if (modTbl[cnl-1].cnl) {
+	if (modTbl[rv.mBdy.by11-1].cnl) {
+		modTbl[rv.mBdy.by11-1].mDlgt(rv.mBdy.mTyp, rv.mBdy.by10, rv.mBdy.by11, rv.buf+12, rv.mBdy.mLen-11);
+	}
+	// --------------------------------------------------------------------
+}
+void AS::recvRESET(void) {
+	// description --------------------------------------------------------
+	//
+	// l> 0B 1C B0 11 63 19 63 1F B7 4A 04 00 (234116)
+	// l> 0E 1C 80 02 1F B7 4A 63 19 63 01 01 00 80 14 (234243)
+	// do something with the information ----------------------------------
 
-			//dbg << "pIdx:" << pIdx << ", cnl:" << cnl << '\n';
-			ee.getList(cnl, modTbl[cnl-1].lst, pIdx, modTbl[cnl-1].lstPeer);				// get list3 or list4 loaded into the user module
-			
-			// call the user module
-			modTbl[cnl-1].mDlgt(rv.mBdy.mTyp, rv.mBdy.by10, rv.mBdy.by11, rv.buf+10, rv.mBdy.mLen-9);
+	ee.clearPeers();
+	ee.clearRegs();
+	initGroups();
+	ee.getMasterID();
+	ld.set(defect);
 
-		} else {
-			sendACK();
+	uint8_t xI = ee.getRegListIdx(1,3);
+	if (rv.ackRq) {
+		if (xI == 0xff) sendACK();
+		else sendACK_STATUS(0, 0, 0);
+	}
+	// --------------------------------------------------------------------
+}
+void AS::recvPEER_EVENT(void) {
+	// 3E SWITCH, 3F TIMESTAMP, 40 REMOTE, 41 SENSOR_EVENT, 53 SENSOR_DATA, 58 CLIMATE_EVENT, 70 WEATHER_EVENT
+	// description --------------------------------------------------------
+	//                 from      to        cnl  cnt
+	// p> 0B 2D B4 40  23 70 D8  01 02 05  06   05 - Remote
+	// do something with the information ----------------------------------
 
-		}
-		// --------------------------------------------------------------------
+	//                 from      to        dst       na  cnl  cnt
+	// m> 0F 18 B0 3E  FD 24 BE  01 02 05  23 70 D8  40  06   00 - Switch
+	//"3E"          => { txt => "SWITCH"      , params => {
+	//				DST      => "00,6",
+	//				UNKNOWN  => "06,2",
+	//				CHANNEL  => "08,2",
+	//				COUNTER  => "10,2", } },
+
+	uint8_t cnl = 0, pIdx, tmp;
+
+	// check if we have the peer in the database to get the channel
+	if ((rv.mBdy.mTyp == 0x3E) && (rv.mBdy.mLen == 0x0f)) {
+		tmp = rv.buf[13];																	// save byte13, because we will replace it
+		rv.buf[13] = rv.buf[14];															// copy the channel byte to the peer
+		cnl = ee.isPeerValid(rv.buf+10);													// check with the right part of the string
+		if (cnl) pIdx = ee.getIdxByPeer(cnl, rv.buf+10);									// get the index of the respective peer in the channel store
+		rv.buf[13] = tmp;																	// get it back
+
+	} else {
+		cnl = ee.isPeerValid(rv.peerId);
+		if (cnl) pIdx = ee.getIdxByPeer(cnl, rv.peerId);									// get the index of the respective peer in the channel store
 
 	}
+	//dbg << "cnl: " << cnl << " pIdx: " << pIdx << " mTyp: " << _HEXB(rv.mBdy.mTyp) << " by10: " << _HEXB(rv.mBdy.by10)  << " by11: " << _HEXB(rv.mBdy.by11) << " data: " << _HEX((rv.buf+10),(rv.mBdy.mLen-9)) << '\n'; _delay_ms(100);
+	if (cnl == 0) return;
+	if (checkAES(cnl)) return;																// command runs later, when the signature is checked
+
+	// check if a module is registered and send the information, otherwise report an empty status
+	if (modTbl[cnl-1].cnl) {
+
+		//dbg << "pIdx:" << pIdx << ", cnl:" << cnl << '\n';
+		ee.getList(cnl, modTbl[cnl-1].lst, pIdx, modTbl[cnl-1].lstPeer);					// get list3 or list4 loaded into the user module
+
+		// call the user module
+		modTbl[cnl-1].mDlgt(rv.mBdy.mTyp, rv.mBdy.by10, rv.mBdy.by11, rv.buf+10, rv.mBdy.mLen-9);
+
+	} else {
+		sendACK();
 
+	}
+	// --------------------------------------------------------------------
 }
 
 // - send functions --------------------------------
@@ -892,7 +1055,7 @@ void AS::sendINFO_SERIAL(void) {
 	memcpy(sn.mBdy.toID,rv.mBdy.reID,3);
 	sn.mBdy.by10 = 0x00;
 	memcpy(sn.buf+11,HMSR,10);
-	sn.active = 1;																			// fire the message
+	sn.push(sndPrioConfig);																	// fire the message
 	// --------------------------------------------------------------------
 }
 void AS::sendINFO_PEER_LIST(uint8_t len) {
@@ -922,7 +1085,7 @@ void AS::sendINFO_PEER_LIST(uint8_t len) {
 	memcpy(sn.mBdy.toID, stcSlice.toID, 3);
 	sn.mBdy.by10 = 0x01; //stcSlice.cnl;
 	//dbg << "x: " << _HEX(sn.buf, sn.mBdy.mLen+1) << '\n';
-	sn.active = 1;																			// fire the message
+	sn.push(sndPrioConfig);																	// fire the message
 	// --------------------------------------------------------------------
 }
 void AS::sendINFO_PARAM_RESPONSE_PAIRS(uint8_t len) {
@@ -942,8 +1105,8 @@ void AS::sendINFO_PARAM_RESPONSE_PAIRS(uint8_t len) {
 	sn.mBdy.mTyp = 0x10;
 	memcpy(sn.mBdy.reID, HMID, 3);
 	memcpy(sn.mBdy.toID, stcSlice.toID, 3);
-	sn.mBdy.by10 = (len < 3)?0x03:0x02;														// on end of the message we send a 0x03 message for homegear only
-	sn.active = 1;																			// fire the message
+	sn.mBdy.by10 = (stcSlice.pos == 0xff)?0x03:0x02;										// 0x03 only for the terminating slice, a last one with one register is data
+	sn.push(sndPrioConfig);																	// fire the message
 	// --------------------------------------------------------------------
 }
 void AS::sendINFO_PARAM_RESPONSE_SEQ(uint8_t len) {
@@ -959,6 +1122,14 @@ void AS::sendINFO_PARAM_RESPONSE_SEQ(uint8_t len) {
 	// l> 0A 92 80 02 63 19 63 01 02 04 00
 	// do something with the information ----------------------------------
 
+	sn.mBdy.mLen = 10+len;
+	sn.mBdy.mCnt = stcSlice.mCnt++;
+	sn.mBdy.mFlg.BIDI = 1;
+	sn.mBdy.mTyp = 0x10;
+	memcpy(sn.mBdy.reID, HMID, 3);
+	memcpy(sn.mBdy.toID, stcSlice.toID, 3);
+	sn.mBdy.by10 = 0x03;																	// ends with 00 00, lists with register 00 go as pairs, see countRegListSeq
+	sn.push(sndPrioConfig);																	// fire the message
 	// --------------------------------------------------------------------
 }
 void AS::sendINFO_PARAMETER_CHANGE(void) {
@@ -969,6 +1140,88 @@ void AS::sendINFO_PARAMETER_CHANGE(void) {
 	//DATA => '14,,$val =~ s/(..)(..)/ $1:$2/g', } },
 	// --------------------------------------------------------------------
 }
+void AS::sendAES_REQ(void) {
+	// description --------------------------------------------------------
+	//                 reID      toID      ACK_PROC  challenge           keyIdx
+	// l> 11 5E A0 02  1F B7 4A  63 19 63  04        xx xx xx xx xx xx   00
+	// do something with the information ----------------------------------
+	// the challenge is the start of an AES block out of the last state, the time and the command. it is encrypted with
+	// the key in aes.key, HMKEY from init or the temp key of the challenge before, both are secret. the temp key is HMKEY
+	// with the challenge xored in the first 6 byte, only these 16 byte are kept. the expanded keys live on the stack
+
+	for (uint8_t i = 0; i < 10; i++) aes.rnd[i] ^= rv.buf[i+1];								// counter, sender and receiver of the command
+	*(tMillis*)(aes.rnd+10) ^= getMillis();
+	aes.rnd[14] ^= rv.rssi;
+	uint8_t rk[aesKeyLen];
+	aesKey(aes.key, rk);
+	aesEncrypt(rk, aes.rnd);
+
+	memcpy(aes.msg, rv.buf, rv.buf[0]+1);													// keep the command for the reply
+	aes.time = getMillis();
+	aes.active = 1;
+
+	sn.mBdy.mLen = 0x11;
+	sn.mBdy.mCnt = rv.mBdy.mCnt;
+	sn.mBdy.mFlg.BIDI = 1;																	// the AES_REPLY counts as answer
+	sn.mBdy.mTyp = 0x02;
+	memcpy(sn.mBdy.reID, HMID, 3);
+	memcpy(sn.mBdy.toID, rv.mBdy.reID, 3);
+	sn.mBdy.by10 = 0x04;
+	memcpy(sn.buf+11, aes.rnd, 6);
+	sn.buf[17] = 0x00;																		// index of the key, HMKEY is the only one
+	sn.push(sndPrioACK);																	// fire the message
+
+	memcpy(aes.key, HMKEY, aesBlockLen);													// temp key of this challenge
+	for (uint8_t i = 0; i < 6; i++) aes.key[i] ^= aes.rnd[i];
+	// --------------------------------------------------------------------
+}
+
+// - signature -------------------------------------
+uint8_t AS::checkAES(uint8_t cnl) {
+	// a channel asks for signed commands with the sign bit in list1 register 0x08. devices without this register in
+	// register.h never sign. returns 1 if the challenge was sent, the command is handled again by recvAES_REPLY
+	if ((aes.signd) || (!cnl)) return 0;													// already signed, or not a channel command
+	if (!(ee.getRegAddr(cnl, 1, 0, 0x08) & 0x01)) return 0;									// sign is off
+
+	if (rv.buf[0] >= sizeof(aes.msg)) return 1;												// too long to keep, dropped
+	sendAES_REQ();
+	return 1;
+}
+void AS::addAuth(void) {
+	if ((!aes.signd) || (sn.mBdy.mCnt != aes.msg[1])) return;								// not the signed command
+	memcpy(sn.buf + sn.mBdy.mLen + 1, aes.auth, 4);
+	sn.mBdy.mLen += 4;
+}
+
+// - groups ----------------------------------------
+void AS::initGroups(void) {
+	// a group entry in the peer table has grpMark in the peer channel byte. in a channel which sends to the group the low
+	// bits hold the number of members, in the channel of a member they hold the reply slot. a member needs the sender as
+	// normal peer as well, the group entry only lets the frames pass the receive filter
+	uint8_t tPeer[4];
+
+	grp.cnt = cc.rxGrpCnt = 0;
+	for (uint8_t cnl = 1; cnl <= devDef.cnlNbr; cnl++) {
+		for (uint8_t i = 0; i < ee.getPeerSlots(cnl); i++) {
+			ee.getPeerByIdx(cnl, i, tPeer);
+			if ((!(tPeer[3] & grpMark)) || (grp.cnt >= grpMax) || (getGroup(tPeer) != 0xff)) continue;
+			memcpy(grp.id[grp.cnt], tPeer, 3);
+			grp.slot[grp.cnt++] = tPeer[3] & ~grpMark;
+		}
+	}
+	cc.rxGrp = grp.id[0];
+	cc.rxGrpCnt = grp.cnt;
+}
+uint8_t AS::getGroup(uint8_t *id) {
+	for (uint8_t i = 0; i < grp.cnt; i++) {
+		if (compArray(id, grp.id[i], 3)) return i;
+	}
+	return 0xff;
+}
+void AS::setReplySlot(void) {
+	uint8_t idx = getGroup(rv.mBdy.toID);
+	if (idx != 0xff) sn.hold = grp.slot[idx] * grpSlotTime;
+}
 
 // - homematic specific functions ------------------
 void AS::decode(uint8_t *buf) {
@@ -1002,138 +1255,122 @@ void AS::encode(uint8_t *buf) {
 	void AS::explainMessage(uint8_t *buf) {
 		dbg << F("   ");																		// save some byte and send 3 blanks once, instead of having it in every if
 
-		if        ((buf[3] == 0x00)) {
-			dbg << F("DEVICE_INFO; fw: ") << _HEX((buf+10),1) << F(", type: ") << _HEX((buf+11),2) << F(", serial: ") << _HEX((buf+13),10) << '\n';
-			dbg << F("              , class: ") << _HEXB(buf[23]) << F(", pCnlA: ") << _HEXB(buf[24]) << F(", pCnlB: ") << _HEXB(buf[25]) << F(", na: ") << _HEXB(buf[26]);
-
-		} else if ((buf[3] == 0x01) && (buf[11] == 0x01)) {
-			dbg << F("CONFIG_PEER_ADD; cnl: ") << _HEXB(buf[10]) << F(", peer: ") << _HEX((buf+12),3) << F(", pCnlA: ") << _HEXB(buf[15]) << F(", pCnlB: ") << _HEXB(buf[16]);
-
-		} else if ((buf[3] == 0x01) && (buf[11] == 0x02)) {
-			dbg << F("CONFIG_PEER_REMOVE; cnl: ") << _HEXB(buf[10]) << F(", peer: ") << _HEX((buf+12),3) << F(", pCnlA: ") << _HEXB(buf[15]) << F(", pCnlB: ") << _HEXB(buf[16]);
-
-		} else if ((buf[3] == 0x01) && (buf[11] == 0x03)) {
-			dbg << F("CONFIG_PEER_LIST_REQ; cnl: ") << _HEXB(buf[10]);
-
-		} else if ((buf[3] == 0x01) && (buf[11] == 0x04)) {
-			dbg << F("CONFIG_PARAM_REQ; cnl: ") << _HEXB(buf[10]) << F(", peer: ") << _HEX((buf+12),3) << F(", pCnl: ") << _HEXB(buf[15]) << F(", lst: ") << _HEXB(buf[16]);
-
-		} else if ((buf[3] == 0x01) && (buf[11] == 0x05)) {
-			dbg << F("CONFIG_START; cnl: ") << _HEXB(buf[10]) << F(", peer: ") << _HEX((buf+12),3) << F(", pCnl: ") << _HEXB(buf[15]) << F(", lst: ") << _HEXB(buf[16]);
-
-		} else if ((buf[3] == 0x01) && (buf[11] == 0x06)) {
-			dbg << F("CONFIG_END; cnl: ") << _HEXB(buf[10]);
-
-		} else if ((buf[3] == 0x01) && (buf[11] == 0x08)) {
-			dbg << F("CONFIG_WRITE_INDEX; cnl: ") << _HEXB(buf[10]) << F(", data: ") << _HEX((buf+12),(buf[0]-11));
-
-		} else if ((buf[3] == 0x01) && (buf[11] == 0x09)) {
-			dbg << F("CONFIG_SERIAL_REQ");
-
-		} else if ((buf[3] == 0x01) && (buf[11] == 0x0A)) {
-			dbg << F("PAIR_SERIAL, serial: ") << _HEX((buf+12),10);
-
-		} else if ((buf[3] == 0x01) && (buf[11] == 0x0E)) {
-			dbg << F("CONFIG_STATUS_REQUEST, cnl: ") << _HEXB(buf[10]);
+		uint8_t idx = getMsgIdx(buf[3], buf[10], buf[11]);									// message name comes out of the message table
+		if (idx == 0xff) {
+			dbg << F("Unknown Message, please report!\n\n");
+			return;
+		}
 
-		} else if ((buf[3] == 0x02) && (buf[10] == 0x00)) {
-			if (buf[0] == 0x0A) dbg << F("ACK");
-			else dbg << F("ACK; data: ") << _HEX((buf+11),buf[0]-10);
+		const char *name;
+		memcpy_P(&name, &msgTbl[idx].name, sizeof(name));
+		dbg << (const __FlashStringHelper*)name;
 
-		} else if ((buf[3] == 0x02) && (buf[10] == 0x01)) {
-			dbg << F("ACK_STATUS; cnl: ") << _HEXB(buf[11]) << F(", status: ") << _HEXB(buf[12]) << F(", down/up/loBat: ") << _HEXB(buf[13]);
+		switch (idx) {
+		case MSG_DEVICE_INFO:
+			dbg << F("; fw: ") << _HEX((buf+10),1) << F(", type: ") << _HEX((buf+11),2) << F(", serial: ") << _HEX((buf+13),10) << '\n';
+			dbg << F("              , class: ") << _HEXB(buf[23]) << F(", pCnlA: ") << _HEXB(buf[24]) << F(", pCnlB: ") << _HEXB(buf[25]) << F(", na: ") << _HEXB(buf[26]);
+			break;
+		case MSG_CONFIG_PEER_ADD:
+		case MSG_CONFIG_PEER_REMOVE:
+			dbg << F("; cnl: ") << _HEXB(buf[10]) << F(", peer: ") << _HEX((buf+12),3) << F(", pCnlA: ") << _HEXB(buf[15]) << F(", pCnlB: ") << _HEXB(buf[16]);
+			break;
+		case MSG_CONFIG_PEER_LIST_REQ:
+		case MSG_CONFIG_END:
+			dbg << F("; cnl: ") << _HEXB(buf[10]);
+			break;
+		case MSG_CONFIG_PARAM_REQ:
+		case MSG_CONFIG_START:
+			dbg << F("; cnl: ") << _HEXB(buf[10]) << F(", peer: ") << _HEX((buf+12),3) << F(", pCnl: ") << _HEXB(buf[15]) << F(", lst: ") << _HEXB(buf[16]);
+			break;
+		case MSG_CONFIG_WRITE_INDEX:
+			dbg << F("; cnl: ") << _HEXB(buf[10]) << F(", data: ") << _HEX((buf+12),(buf[0]-11));
+			break;
+		case MSG_PAIR_SERIAL:
+			dbg << F(", serial: ") << _HEX((buf+12),10);
+			break;
+		case MSG_CONFIG_STATUS_REQUEST:
+			dbg << F(", cnl: ") << _HEXB(buf[10]);
+			break;
+		case MSG_ACK:
+			if (buf[0] > 0x0A) dbg << F("; data: ") << _HEX((buf+11),buf[0]-10);
+			break;
+		case MSG_ACK_STATUS:
+			dbg << F("; cnl: ") << _HEXB(buf[11]) << F(", status: ") << _HEXB(buf[12]) << F(", down/up/loBat: ") << _HEXB(buf[13]);
 			if (buf[0] > 13) dbg << F(", rssi: ") << _HEXB(buf[14]);
-
-		} else if ((buf[3] == 0x02) && (buf[10] == 0x02)) {
-			dbg << F("ACK2");
-
-		} else if ((buf[3] == 0x02) && (buf[10] == 0x04)) {
-			dbg << F("ACK_PROC; para1: ") << _HEX((buf+11),2) << F(", para2: ") << _HEX((buf+13),2) << F(", para3: ") << _HEX((buf+15),2) << F(", para4: ") << _HEXB(buf[17]);
-
-		} else if ((buf[3] == 0x02) && (buf[10] == 0x80)) {
-			dbg << F("NACK");
-
-		} else if ((buf[3] == 0x02) && (buf[10] == 0x84)) {
-			dbg << F("NACK_TARGET_INVALID");
-
-		} else if ((buf[3] == 0x03)) {
-			dbg << F("AES_REPLY; data: ") << _HEX((buf+10),buf[0]-9);
-
-		} else if ((buf[3] == 0x04) && (buf[10] == 0x01)) {
-			dbg << F("TOpHMLAN:SEND_AES_CODE; cnl: ") << _HEXB(buf[11]);
-
-		} else if ((buf[3] == 0x04)) {
-			dbg << F("TO_ACTOR:SEND_AES_CODE; code: ") << _HEXB(buf[11]);
-
-		} else if ((buf[3] == 0x10) && (buf[10] == 0x00)) {
-			dbg << F("INFO_SERIAL; serial: ") << _HEX((buf+11),10);
-
-		} else if ((buf[3] == 0x10) && (buf[10] == 0x01)) {
-			dbg << F("INFO_PEER_LIST; peer1: ") << _HEX((buf+11),4);
+			break;
+		case MSG_ACK_PROC:
+			dbg << F("; para1: ") << _HEX((buf+11),2) << F(", para2: ") << _HEX((buf+13),2) << F(", para3: ") << _HEX((buf+15),2) << F(", para4: ") << _HEXB(buf[17]);
+			break;
+		case MSG_AES_REPLY:
+			dbg << F("; data: ") << _HEX((buf+10),buf[0]-9);
+			break;
+		case MSG_TOpHMLAN_SEND_AES_CODE:
+			dbg << F("; cnl: ") << _HEXB(buf[11]);
+			break;
+		case MSG_TO_ACTOR_SEND_AES_CODE:
+			dbg << F("; code: ") << _HEXB(buf[11]);
+			break;
+		case MSG_INFO_SERIAL:
+			dbg << F("; serial: ") << _HEX((buf+11),10);
+			break;
+		case MSG_INFO_PEER_LIST:
+			dbg << F("; peer1: ") << _HEX((buf+11),4);
 			if (buf[0] >= 19) dbg << F(", peer2: ") << _HEX((buf+15),4);
 			if (buf[0] >= 23) dbg << F(", peer3: ") << _HEX((buf+19),4);
 			if (buf[0] >= 27) dbg << F(", peer4: ") << _HEX((buf+23),4);
-
-		} else if ((buf[3] == 0x10) && (buf[10] == 0x02)) {
-			dbg << F("INFO_PARAM_RESPONSE_PAIRS; data: ") << _HEX((buf+11),buf[0]-10);
-
-		} else if ((buf[3] == 0x10) && (buf[10] == 0x03)) {
-			dbg << F("INFO_PARAM_RESPONSE_SEQ; offset: ") << _HEXB(buf[11]) << F(", data: ") << _HEX((buf+12),buf[0]-11);
-
-		} else if ((buf[3] == 0x10) && (buf[10] == 0x04)) {
-			dbg << F("INFO_PARAMETER_CHANGE; cnl: ") << _HEXB(buf[11]) << F(", peer: ") << _HEX((buf+12),4) << F(", pLst: ") << _HEXB(buf[16]) << F(", data: ") << _HEX((buf+17),buf[0]-16);
-
-		} else if ((buf[3] == 0x10) && (buf[10] == 0x06)) {
-			dbg << F("INFO_ACTUATOR_STATUS; cnl: ") << _HEXB(buf[11]) << F(", status: ") << _HEXB(buf[12]) << F(", na: ") << _HEXB(buf[13]);
+			break;
+		case MSG_INFO_PARAM_RESPONSE_PAIRS:
+			dbg << F("; data: ") << _HEX((buf+11),buf[0]-10);
+			break;
+		case MSG_INFO_PARAM_RESPONSE_SEQ:
+			dbg << F("; offset: ") << _HEXB(buf[11]) << F(", data: ") << _HEX((buf+12),buf[0]-11);
+			break;
+		case MSG_INFO_PARAMETER_CHANGE:
+			dbg << F("; cnl: ") << _HEXB(buf[11]) << F(", peer: ") << _HEX((buf+12),4) << F(", pLst: ") << _HEXB(buf[16]) << F(", data: ") << _HEX((buf+17),buf[0]-16);
+			break;
+		case MSG_INFO_ACTUATOR_STATUS:
+			dbg << F("; cnl: ") << _HEXB(buf[11]) << F(", status: ") << _HEXB(buf[12]) << F(", na: ") << _HEXB(buf[13]);
 			if (buf[0] > 13) dbg << F(", rssi: ") << _HEXB(buf[14]);
-
-		} else if ((buf[3] == 0x11) && (buf[10] == 0x02)) {
-			dbg << F("SET; cnl: ") << _HEXB(buf[11]) << F(", value: ") << _HEXB(buf[12]) << F(", rampTime: ") << _HEX((buf+13),2) << F(", duration: ") << _HEX((buf+15),2);
-
-		} else if ((buf[3] == 0x11) && (buf[10] == 0x03)) {
-			dbg << F("STOP_CHANGE; cnl: ") << _HEXB(buf[11]);
-
-		} else if ((buf[3] == 0x11) && (buf[10] == 0x04) && (buf[11] == 0x00)) {
-			dbg << F("RESET");
-
-		} else if ((buf[3] == 0x11) && (buf[10] == 0x80)) {
-			dbg << F("LED; cnl: ") << _HEXB(buf[11]) << F(", color: ") << _HEXB(buf[12]);
-
-		} else if ((buf[3] == 0x11) && (buf[10] == 0x81) && (buf[11] == 0x00)) {
-			dbg << F("LED_ALL; Led1To16: ") << _HEX((buf+12),4);
-
-		} else if ((buf[3] == 0x11) && (buf[10] == 0x81)) {
-			dbg << F("LED; cnl: ") << _HEXB(buf[11]) << F(", time: ") << _HEXB(buf[12]) << F(", speed: ") << _HEXB(buf[13]);
-
-		} else if ((buf[3] == 0x11) && (buf[10] == 0x82)) {
-			dbg << F("SLEEPMODE; cnl: ") << _HEXB(buf[11]) << F(", mode: ") << _HEXB(buf[12]);
-
-		} else if ((buf[3] == 0x12)) {
-			dbg << F("HAVE_DATA");
-
-		} else if ((buf[3] == 0x3E)) {
-			dbg << F("SWITCH; dst: ") << _HEX((buf+10),3) << F(", na: ") << _HEXB(buf[13]) << F(", cnl: ") << _HEXB(buf[14]) << F(", counter: ") << _HEXB(buf[15]);
-
-		} else if ((buf[3] == 0x3F)) {
-			dbg << F("TIMESTAMP; na: ") << _HEX((buf+10),2) << F(", time: ") << _HEX((buf+12),2);
-
-		} else if ((buf[3] == 0x40)) {
-			dbg << F("REMOTE; button: ") << _HEXB((buf[10] & 0x3F)) << F(", long: ") << (buf[10] & 0x40 ? 1:0) << F(", lowBatt: ") << (buf[10] & 0x80 ? 1:0) << F(", counter: ") << _HEXB(buf[11]);
-
-		} else if ((buf[3] == 0x41)) {
-			dbg << F("SENSOR_EVENT; button: ") <<_HEXB((buf[10] & 0x3F)) << F(", long: ") << (buf[10] & 0x40 ? 1:0) << F(", lowBatt: ") << (buf[10] & 0x80 ? 1:0) << F(", value: ") << _HEXB(buf[11]) << F(", next: ") << _HEXB(buf[12]);
-
-		} else if ((buf[3] == 0x53)) {
-			dbg << F("SENSOR_DATA; cmd: ") << _HEXB(buf[10]) << F(", fld1: ") << _HEXB(buf[11]) << F(", val1: ") << _HEX((buf+12),2) << F(", fld2: ") << _HEXB(buf[14]) << F(", val2: ") << _HEX((buf+15),2) << F(", fld3: ") << _HEXB(buf[17]) << F(", val3: ") << _HEX((buf+18),2) << F(", fld4: ") << _HEXB(buf[20]) << F(", val4: ") << _HEX((buf+21),2);
-
-		} else if ((buf[3] == 0x58)) {
-			dbg << F("CLIMATE_EVENT; cmd: ") << _HEXB(buf[10]) << F(", valvePos: ") << _HEXB(buf[11]);
-
-		} else if ((buf[3] == 0x70)) {
-			dbg << F("WEATHER_EVENT; temp: ") << _HEX((buf+10),2) << F(", hum: ") << _HEXB(buf[12]);
-
-		} else {
-			dbg << F("Unknown Message, please report!");
+			break;
+		case MSG_SET:
+			dbg << F("; cnl: ") << _HEXB(buf[11]) << F(", value: ") << _HEXB(buf[12]) << F(", rampTime: ") << _HEX((buf+13),2) << F(", duration: ") << _HEX((buf+15),2);
+			break;
+		case MSG_STOP_CHANGE:
+			dbg << F("; cnl: ") << _HEXB(buf[11]);
+			break;
+		case MSG_LED:
+			dbg << F("; cnl: ") << _HEXB(buf[11]) << F(", color: ") << _HEXB(buf[12]);
+			break;
+		case MSG_LED_ALL:
+			dbg << F("; Led1To16: ") << _HEX((buf+12),4);
+			break;
+		case MSG_LEVEL:
+			dbg << F("; cnl: ") << _HEXB(buf[11]) << F(", time: ") << _HEXB(buf[12]) << F(", speed: ") << _HEXB(buf[13]);
+			break;
+		case MSG_SLEEPMODE:
+			dbg << F("; cnl: ") << _HEXB(buf[11]) << F(", mode: ") << _HEXB(buf[12]);
+			break;
+		case MSG_SWITCH:
+			dbg << F("; dst: ") << _HEX((buf+10),3) << F(", na: ") << _HEXB(buf[13]) << F(", cnl: ") << _HEXB(buf[14]) << F(", counter: ") << _HEXB(buf[15]);
+			break;
+		case MSG_TIMESTAMP:
+			dbg << F("; na: ") << _HEX((buf+10),2) << F(", time: ") << _HEX((buf+12),2);
+			break;
+		case MSG_REMOTE:
+			dbg << F("; button: ") << _HEXB((buf[10] & 0x3F)) << F(", long: ") << (buf[10] & 0x40 ? 1:0) << F(", lowBatt: ") << (buf[10] & 0x80 ? 1:0) << F(", counter: ") << _HEXB(buf[11]);
+			break;
+		case MSG_SENSOR_EVENT:
+			dbg << F("; button: ") <<_HEXB((buf[10] & 0x3F)) << F(", long: ") << (buf[10] & 0x40 ? 1:0) << F(", lowBatt: ") << (buf[10] & 0x80 ? 1:0) << F(", value: ") << _HEXB(buf[11]) << F(", next: ") << _HEXB(buf[12]);
+			break;
+		case MSG_SENSOR_DATA:
+			dbg << F("; cmd: ") << _HEXB(buf[10]) << F(", fld1: ") << _HEXB(buf[11]) << F(", val1: ") << _HEX((buf+12),2) << F(", fld2: ") << _HEXB(buf[14]) << F(", val2: ") << _HEX((buf+15),2) << F(", fld3: ") << _HEXB(buf[17]) << F(", val3: ") << _HEX((buf+18),2) << F(", fld4: ") << _HEXB(buf[20]) << F(", val4: ") << _HEX((buf+21),2);
+			break;
+		case MSG_CLIMATE_EVENT:
+			dbg << F("; cmd: ") << _HEXB(buf[10]) << F(", valvePos: ") << _HEXB(buf[11]);
+			break;
+		case MSG_WEATHER_EVENT:
+			dbg << F("; temp: ") << _HEX((buf+10),2) << F(", hum: ") << _HEXB(buf[12]);
+			break;
 		}
 		dbg << F("\n\n");
 	}
@@ -1150,8 +1387,14 @@ void AS::encode(uint8_t *buf) {
  */
 uint8_t  waitTimer::done(void) {
 	if (!armed) return 1;							// not armed, so nothing to do
-	if ( (getMillis() - startTime) < checkTime ) return 0;			// not ready yet
+	uint32_t past = getMillis() - startTime;
+	if ( past < checkTime ) return 0;				// not ready yet
 
+	past -= checkTime;								// time since the deadline
+	if (past > tmrLate) tmrStat.late++;
+	if (past > tmrStat.lateMax) tmrStat.lateMax = past;
+
+	unlink();
 	checkTime = armed = 0;							// if we are here, timeout was happened, next loop status 1 will indicated
 	return 1;
 }
@@ -1162,21 +1405,76 @@ uint8_t  waitTimer::done(void) {
  * @param ms Time until timer is done() (unit: ms)
  */
 void     waitTimer::set(uint32_t ms) {
+	unlink();
 	armed = ms?1:0;
 	if (armed) {
 		startTime = getMillis();
 		checkTime = ms;
+		link();
 	}
 }
 
 /**
  * @brief Query the remaing time until the timer is done
  *
- * @return Time until timer is done() (unit: ms)
+ * @return Time until timer is done() (unit: ms), 0 if the timer is not armed or due already
  */
 uint32_t waitTimer::remain(void) {
 	if (!armed) return 0;
-	return (checkTime - (getMillis() - startTime));
+	uint32_t past = getMillis() - startTime;
+	return (past < checkTime) ? checkTime - past : 0;
+}
+
+/**
+ * @brief Query if the timer is armed
+ *
+ * @return 1 from set() until done() has reported the timeout, also while the timer is due already
+ */
+uint8_t  waitTimer::running(void) {
+	return armed;
+}
+
+/**
+ * @brief Query the time until the next armed timer is due
+ *
+ * Timers which are due already are taken out of the list, they stay armed until done()
+ * is called for them.
+ *
+ * @return Time until the earliest deadline (unit: ms), 0xffffffff if no timer is armed
+ */
+uint32_t waitTimer::next(void) {
+	while (firstTmr) {
+		uint32_t past = getMillis() - firstTmr->startTime;
+		if (past < firstTmr->checkTime) return firstTmr->checkTime - past;
+		firstTmr->unlink();							// due already, whoever waits for it gets it with done()
+	}
+	return 0xffffffff;
+}
+
+waitTimer *waitTimer::firstTmr;
+s_tmrStat tmrStat;
+
+void     waitTimer::link(void) {
+	uint32_t due = startTime + checkTime;
+
+	waitTimer **p = &firstTmr;						// find the first timer with a later deadline
+	while ((*p) && ((int32_t)(((*p)->startTime + (*p)->checkTime) - due) <= 0)) p = &(*p)->nextTmr;
+	nextTmr = *p;
+	*p = this;
+	queued = 1;
+
+	if (++tmrStat.armed > tmrStat.armedMax) tmrStat.armedMax = tmrStat.armed;
+}
+void     waitTimer::unlink(void) {
+	if (!queued) return;
+
+	waitTimer **p = &firstTmr;
+	while ((*p) && (*p != this)) p = &(*p)->nextTmr;
+	if (*p) {
+		*p = nextTmr;
+		tmrStat.armed--;
+	}
+	queued = 0;
 }
 
 uint32_t byteTimeCvt(uint8_t tTime) {
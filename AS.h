@@ -19,8 +19,26 @@
 #include "StatusLed.h"
 #include "Power.h"
 #include "Battery.h"
+#include "Trace.h"
+#include "AES.h"
 #include "Version.h"
 
+#ifndef aesTimeOut
+	#define aesTimeOut 1000					// ms the central has for the AES_REPLY
+#endif
+
+#ifndef stsWindow
+	#define stsWindow 50						// ms a status change waits for the ones of the other channels
+#endif
+#ifndef stsRate
+	#define stsRate   5							// actuator status frames per second
+#endif
+
+#define grpMark       0x80						// peer channel byte of a group entry, a real peer channel never sets bit 7
+#ifndef grpMax
+	#define grpMax    2							// groups the device can be member of
+#endif
+
 /**
  * @short Main class for implementation of the AskSin protocol stack.
  * Every device needs exactly one instance of this class.
@@ -50,29 +68,17 @@ class AS {
 	LD ld;			///< status led
 	PW pw;			///< power management
 	CC cc;			///< load communication module
+	RV rv;			///< receive module
 	BT bt;
 
   protected:	//---------------------------------------------------------------------------------------------------------
-  private:		//---------------------------------------------------------------------------------------------------------
-
-	//CC cc;		///< load communication module
-	RV rv;			///< receive module
-
-	/** @brief Helper structure for keeping track of active config mode */
-	struct s_confFlag {					// - remember that we are in config mode, for config start message receive
-		uint8_t  active   :1;	//< indicates status, 1 if config mode is active
-		uint8_t  cnl;		//< channel
-		uint8_t  lst;		//< list
-		uint8_t  idx;		//< peer index
-	} cFlag;
-
 	struct s_stcSlice {						// - send peers or reg in slices, store for send slice function
 		uint8_t active   :1;				// indicates status of poll routine, 1 is active
 		uint8_t peer     :1;				// is it a peer list message
 		uint8_t reg2     :1;				// or a register send
-		uint8_t reg3     :1;				// not implemented at the moment
+		uint8_t reg3     :1;				// or a register send as offset and data, for lists with runs of registers
 		uint8_t totSlc;						// amount of necessary slices to send content
-		uint8_t curSlc;						// counter for slices which are already send
+		uint8_t pos;						// cursor of the slice functions in EE, 0xff after the last slice
 		uint8_t cnl;						// indicates channel
 		uint8_t lst;						// the respective list
 		uint8_t idx;						// the peer index
@@ -80,6 +86,29 @@ class AS {
 		uint8_t toID[3];					// to whom to send
 	} stcSlice;
 
+	struct s_aes {							// - signature of a received command, challenge and answer
+		uint8_t  active   :1;				// challenge is out, waiting for the AES_REPLY
+		uint8_t  signd    :1;				// frame in rv.buf passed the check, the ACK carries the auth bytes
+		uint8_t  msg[27];					// the command which waits for its signature, up to 16 byte payload
+		uint8_t  auth[4];					// auth bytes for the ACK
+		uint8_t  rnd[16];					// state of the challenge generator
+		tMillis  time;						// time of the challenge
+		uint8_t  key[aesBlockLen];			// temp key of the challenge, HMKEY before the first one
+	} aes;
+
+  private:		//---------------------------------------------------------------------------------------------------------
+
+	//CC cc;		///< load communication module
+	//RV rv;		///< receive module
+
+	/** @brief Helper structure for keeping track of active config mode */
+	struct s_confFlag {					// - remember that we are in config mode, for config start message receive
+		uint8_t  active   :1;	//< indicates status, 1 if config mode is active
+		uint8_t  cnl;		//< channel
+		uint8_t  lst;		//< list
+		uint8_t  idx;		//< peer index
+	} cFlag;
+
 	struct s_stcPeer {
 		uint8_t active   :1;				// indicates status of poll routine, 1 is active
 		uint8_t rnd      :3;				// send retries
@@ -91,7 +120,7 @@ class AS {
 		uint8_t cnl;						// which channel is the sender
 		uint8_t curIdx;						// current peer slots
 		uint8_t maxIdx;						// amount of peer slots
-		uint8_t slt[8];						// slot measure, all filled in a first step, if ACK was received, one is taken away by slot
+		uint8_t slt[(maxPeerSlots+7)/8];	// slot measure, all filled in a first step, if ACK was received, one is taken away by slot
 	} stcPeer;
 
 	struct s_l4_0x01 {
@@ -100,6 +129,18 @@ class AS {
 		uint8_t  expectAES           :1;     // 0x01, s:7, e:8
 	} l4_0x01;
 
+	struct s_grp {							// - groups we are member of, collected out of the peer table by initGroups
+		uint8_t  cnt;						// valid entries in id and slot
+		uint8_t  id[grpMax][3];				// group ids, the cc1101 lets frames to them pass like the ones to HMID
+		uint8_t  slot[grpMax];				// our reply slot in the respective group
+	} grp;
+
+	struct s_stcStat {						// - actuator status of the channels, collected per window, see sendStatList
+		uint8_t  active   :1;				// a status waits in modTbl
+		uint8_t  tokens;					// frames which may go out now, up to stsRate
+		tMillis  refill;					// time of the last token
+	} stcStat;
+
 	uint8_t pairActive    :1;
 
   public:		//---------------------------------------------------------------------------------------------------------
@@ -139,6 +180,11 @@ class AS {
 	void sendSetTeamTemp(void);
 	void sendWeatherEvent(void);
 	void send_generic_event(uint8_t cnl, uint8_t burst, uint8_t mTyp, uint8_t len, uint8_t *pL);
+
+	// - homematic specific functions ------------------
+	static void decode(uint8_t *buf);														// decodes the message
+	static void encode(uint8_t *buf);														// encodes the message
+	void explainMessage(uint8_t *buf);														// explains message content, part of debug functions
 	
   private:		//---------------------------------------------------------------------------------------------------------
 
@@ -146,9 +192,37 @@ class AS {
 	void sendSliceList(void);																// scheduler to send config messages, peers and regs
 	void sendPeerMsg(void);																	// scheduler for peer messages
 	void prepPeerMsg(uint8_t *xPeer, uint8_t retr);
+	void sendStatList(void);																// collected actuator status into the send queue
 			
 	// - receive functions -----------------------------
-	void recvMessage(void);
+	typedef void (AS::*s_recvFunc)(void);													// receive handler, called out of the message table
+	struct s_msgTbl {
+		uint8_t    mTyp;																	// message type
+		uint8_t    flg;																		// MSG_BY10, MSG_BY11 - which of the subtype bytes has to match
+		uint8_t    by10;
+		uint8_t    by11;
+		const char *name;																	// message name in flash, only filled with RV_DBG_EX
+		s_recvFunc recv;																	// receive handler, NULL if nothing is to do
+	};
+	static const s_msgTbl msgTbl[];															// sorted by mTyp, lives in PROGMEM
+
+	uint8_t getMsgIdx(uint8_t mTyp, uint8_t by10, uint8_t by11);							// index in msgTbl or 0xff
+	s_recvFunc getRecvFunc(void);															// handler of the frame in rv.buf or NULL
+	void recvCONFIG_PEER_ADD(void);
+	void recvCONFIG_PEER_REMOVE(void);
+	void recvCONFIG_PEER_LIST_REQ(void);
+	void recvCONFIG_PARAM_REQ(void);
+	void recvCONFIG_START(void);
+	void recvCONFIG_END(void);
+	void recvCONFIG_WRITE_INDEX(void);
+	void recvPAIR_SERIAL(void);
+	void recvCONFIG_STATUS_REQUEST(void);
+	void recvACK(void);
+	void recvACK_STATUS(void);
+	void recvNACK(void);
+	void recvSET(void);
+	void recvRESET(void);
+	void recvPEER_EVENT(void);
 
 	// - send functions --------------------------------
 	void sendINFO_SERIAL(void);
@@ -156,13 +230,23 @@ class AS {
 	void sendINFO_PARAM_RESPONSE_PAIRS(uint8_t len);
 	void sendINFO_PARAM_RESPONSE_SEQ(uint8_t len);
 	void sendINFO_PARAMETER_CHANGE(void);
+	void pushStatus(uint8_t cnl, uint8_t stat, uint8_t cng, uint8_t cnt);					// INFO_ACTUATOR_STATUS frame into the send queue
+
+	// - signature -------------------------------------
+	uint8_t checkAES(uint8_t cnl);															// 1 if the command waits for a signature now
+	void addAuth(void);																		// auth bytes into an ACK, if the command was signed
+
+	// - groups ----------------------------------------
+	void initGroups(void);																	// search the peer table for group entries, after every peer change
+	uint8_t getGroup(uint8_t *id);															// index in grp or 0xff if id is none of our groups
+	void setReplySlot(void);																// an answer to a group frame waits for our reply slot
 
 	
   protected:	//---------------------------------------------------------------------------------------------------------
-	// - homematic specific functions ------------------
-	void decode(uint8_t *buf);																// decodes the message
-	void encode(uint8_t *buf);																// encodes the message
-	void explainMessage(uint8_t *buf);														// explains message content, part of debug functions
+	// - hot paths of receive and signature ------------
+	void recvMessage(void);																	// dispatch the frame in rv.buf
+	void recvAES_REPLY(void);
+	void sendAES_REQ(void);
 
 	// - some helpers ----------------------------------
 
@@ -195,20 +279,51 @@ extern AS hm;
  * actions, more time may pass. Also, actual delay times strongly depend 
  * on the behaviour of the system clock.
  *
+ * Armed timers are kept in a list sorted by their deadline. waitTimer::next() reports the time
+ * until the earliest one is due, PW::poll() uses it to sleep until then.
+ *
  * @see http://www.gammon.com.au/forum/?id=12127
  */
 class waitTimer {
 
   private:		//---------------------------------------------------------------------------------------------------------
-	uint8_t  armed;
+	uint8_t  armed  :1;
+	uint8_t  queued :1;																		// timer is linked into the deadline list
 	uint32_t checkTime;
 	uint32_t startTime;
+	waitTimer *nextTmr;																		// next timer in the deadline list
+
+	static waitTimer *firstTmr;																// timer with the earliest deadline
+
+	void     link(void);																	// sort the timer into the deadline list
+	void     unlink(void);																	// and take it out again
 
   public:		//---------------------------------------------------------------------------------------------------------
 	uint8_t  done(void);
 	void     set(uint32_t ms);
 	uint32_t remain(void);
+	uint8_t  running(void);																	// 1 while armed, done() was not asked since the timeout
+
+	static uint32_t next(void);																// ms until the next armed timer is due, 0xffffffff if none
+};
+
+#ifndef tmrLate
+	#define tmrLate 10																		// a timer noticed later than this (ms) counts as late
+#endif
+struct s_tmrStat {
+	uint8_t  armed;																			// timers in the deadline list
+	uint8_t  armedMax;																		// ...and the most at a time
+	uint16_t late;																			// timers noticed more than tmrLate ms after their deadline
+	uint32_t lateMax;																		// biggest delay between deadline and done() in ms
+};
+extern s_tmrStat tmrStat;
+
+struct s_stsStat {
+	uint16_t in;																			// spontaneous status reports of the channels
+	uint16_t out;																			// INFO_ACTUATOR_STATUS frames out of them
+	uint16_t held;																			// rounds the rate limit held a status back
 };
+extern s_stsStat stsStat;
 
 
 
@@ -67,9 +67,7 @@ void    CC::init(void) {																// initialize CC1101
 		CC1101_MCSM0,    0x18,
 		CC1101_FOCCFG,   0x16,
 		CC1101_AGCCTRL2, 0x43,
-		//CC1101_WOREVT1, 0x28,													// tEVENT0 = 50 ms, RX timeout = 390 us
-		//7CC1101_WOREVT0, 0xA0,
-		//CC1101_WORCTRL, 0xFB,													//EVENT1 = 3, WOR_RES = 0
+		// WOREVT1, WOREVT0 and WORCTRL keep their reset values, setWOR loads the wake on radio ones
 		CC1101_FREND1,  0x56,
 		CC1101_FSCAL1,  0x00,
 		CC1101_FSCAL0,  0x11,
@@ -105,7 +103,14 @@ void    CC::init(void) {																// initialize CC1101
 	dbg << F(" - ready\n");
 	#endif
 }
-uint8_t CC::sndData(uint8_t *buf, uint8_t burst) {										// send data packet via RF
+uint8_t CC::startTx(uint8_t *buf, uint8_t burst) {										// start sending a data packet via RF
+	// the frame is copied, so the caller is free to reuse buf. while the burst preamble or the frame is on air, txDone has
+	// to be polled, it writes the fifo when the preamble is over and switches back to receive mode at the end
+	if ((txStat != CC_TX_IDLE) || (buf[0] >= CC1101_TX_LEN)) return 0;					// busy, or frame too long
+	memcpy(txBuf, buf, buf[0]+1);
+
+	disableGDO0Int();																	// GDO0 follows the sent frame as well
+	worExit();
 
 	// Going from RX to TX does not work if there was a reception less than 0.5
 	// sec ago. Due to CCA? Using IDLE helps to shorten this period(?)
@@ -117,64 +122,100 @@ uint8_t CC::sndData(uint8_t *buf, uint8_t burst) {										// send data packet
 
 	if (burst) {																		// BURST-bit set?
 		strobe(CC1101_STX  );															// send a burst
-		_delay_ms(360);																	// according to ELV, devices get activated every 300ms, so send burst for 360ms
+		txWait = 360;																	// according to ELV, devices get activated every 300ms, so send burst for 360ms
 		//dbg << "send burst\n";
 	} else {
-		_delay_ms(1);																	// wait a short time to set TX mode
+		txWait = 1;																		// wait a short time to set TX mode
 	}
 
-	writeBurst(CC1101_TXFIFO, buf, buf[0]+1);											// write in TX FIFO
+	txTime = getMillis();
+	txStat = CC_TX_SETUP;
+	return 1;
+}
+uint8_t CC::txDone(void) {																// drives the transmitter, 1 if nothing is on the way
+	if (txStat == CC_TX_IDLE) return 1;
 
-	strobe(CC1101_SFRX);																// flush the RX buffer
-	strobe(CC1101_STX);																	// send a burst
+	if (txStat == CC_TX_SETUP) {
+		if ((getMillis() - txTime) < txWait) return 0;									// preamble still on air
+		writeBurst(CC1101_TXFIFO, txBuf, txBuf[0]+1);									// write in TX FIFO
 
-	for(uint8_t i = 0; i < 200; i++) {													// after sending out all bytes the chip should go automatically in RX mode
-		if( readReg(CC1101_MARCSTATE, CC1101_STATUS) == MARCSTATE_RX)
-			break;																		//now in RX mode, good
-		if( readReg(CC1101_MARCSTATE, CC1101_STATUS) != MARCSTATE_TX) {
-			break;																		//neither in RX nor TX, probably some error
-		}
-		_delay_us(10);
+		strobe(CC1101_SFRX);															// flush the RX buffer
+		strobe(CC1101_STX);																// send a burst
+
+		txTime = getMillis();
+		txWait = txBuf[0] + 11 + 10;													// air time is 0.8ms per byte plus preamble, sync and crc, some extra
+		txStat = CC_TX_DATA;
+		return 0;
 	}
 
+	// after sending out all bytes the chip should go automatically in RX mode. if it went idle instead, or the air time is
+	// over without leaving TX, the receiver is restarted
+	uint8_t marc = readReg(CC1101_MARCSTATE, CC1101_STATUS);
+	if ((marc != MARCSTATE_RX) && (marc != MARCSTATE_IDLE) && ((getMillis() - txTime) < txWait)) return 0;	// frame still on air
+	txStat = CC_TX_IDLE;
+	ccSetBusy(1);																		// an end of packet from now on waits for the restart below
+	enableGDO0Int();
+
+	// a frame which ended between the chip going back to RX and now has not raised the interrupt. GDO0 is low again once
+	// it is complete, it goes to the receive path like an end of packet which found the spi bus busy. a frame which is
+	// still coming in raises the interrupt by itself
+	if (marc != MARCSTATE_RX) rcvRestart();
+	else if ((readReg(CC1101_RXBYTES, CC1101_STATUS) & 0x7F) && !(readReg(CC1101_PKTSTATUS, CC1101_STATUS) & 0x01)) ccSetGDO0();
+	ccSetBusy(0);
+
 	#ifdef CC_DBG																		// only if cc debug is set
-	dbg << F("<- ") << _HEXB(buf[0]) << _HEXB(buf[1]) << '\n';//pTime();
+	dbg << F("<- ") << _HEXB(txBuf[0]) << _HEXB(txBuf[1]) << '\n';//pTime();
 	#endif
 
 	//dbg << "rx\n";
-	return true;
+	return 1;
 }
-uint8_t CC::rcvData(uint8_t *buf) {														// read data packet from RX FIFO
+uint8_t CC::rcvData(uint8_t *buf, uint8_t *ownID) {										// read data packet from RX FIFO
+	// the frame is decoded while it comes off the spi bus, a byte only depends on the encoded byte before. like that the
+	// receiver id is known after byte 9 and frames which are neither for ownID, one of the groups in rxGrp nor broadcast
+	// are dropped at this point. ownID NULL reads everything
 	uint8_t rxBytes = readReg(CC1101_RXBYTES, CC1101_STATUS);							// how many bytes are in the buffer
 	//dbg << rxBytes << ' ';
 
+	buf[0] = 0;
 	if ((rxBytes & 0x7F) && !(rxBytes & 0x80)) {										// any byte waiting to be read and no overflow?
-		buf[0] = readReg(CC1101_RXFIFO, CC1101_CONFIG);									// read data length
-		
-		if (buf[0] > CC1101_DATA_LEN) {													// if packet is too long
-			buf[0] = 0;																	// discard packet
-			
-		} else {
-			readBurst(&buf[1], CC1101_RXFIFO, buf[0]);									// read data packet
-			
-			rssi = readReg(CC1101_RXFIFO, CC1101_CONFIG);								// read RSSI
-			
-			if (rssi >= 128) rssi = 255 - rssi;
-			rssi /= 2; rssi += 72;
-			
-			uint8_t val = readReg(CC1101_RXFIFO, CC1101_CONFIG);						// read LQI and CRC_OK
-			lqi = val & 0x7F;
-			crc_ok = bitRead(val, 7);
-	
+		ccSelect();																		// select CC1101
+		waitMiso();																		// wait until MISO goes low
+		ccSendByte(CC1101_RXFIFO | READ_BURST);											// read the fifo in one burst
+		uint8_t len = ccSendByte(0x00);													// data length
+
+		if (len <= CC1101_DATA_LEN) {													// otherwise the packet is too long, discard it
+			uint8_t prev = 0;
+			for (uint8_t i = 1; i <= len; i++) {
+				uint8_t c = ccSendByte(0x00);
+				if      (i == 1)   buf[i] = (~c) ^ 0x89;								// same as AS::decode
+				else if (i < len)  buf[i] = (prev + 0xdc) ^ c;
+				else               buf[i] = c ^ buf[2];
+				prev = c;
+
+				if ((i == 9) && (i < len) && (ownID) && (buf[7] | buf[8] | buf[9]) && (memcmp(buf+7, ownID, 3)) && (!isGroup(buf+7))) {
+					rxSkip++;															// not for us, the rest stays in the fifo
+					rxSkipBytes += len - 9 + 2;											// data, rssi and lqi
+					len = 0;
+					break;
+				}
+			}
+
+			if (len) {
+				rssi = ccSendByte(0x00);												// read RSSI
+				if (rssi >= 128) rssi = 255 - rssi;
+				rssi /= 2; rssi += 72;
+
+				uint8_t val = ccSendByte(0x00);											// read LQI and CRC_OK
+				lqi = val & 0x7F;
+				crc_ok = bitRead(val, 7);
+			}
+			buf[0] = len;
 		}
+		ccDeselect();																	// deselect CC1101
+	}
 
-	} else buf[0] = 0;																	// nothing to do, or overflow
-
-	strobe(CC1101_SFRX);																// flush Rx FIFO
-	strobe(CC1101_SIDLE);																// enter IDLE state
-	strobe(CC1101_SRX);																	// back to RX state
-	strobe(CC1101_SWORRST);																// reset real time clock
-	//	trx868.rfState = RFSTATE_RX;													// declare to be in Rx state
+	rcvRestart();																		// flush the fifo and listen again
 
 	#ifdef CC_DBG																		// only if cc debug is set
 	if (buf[0] > 0) dbg << _HEX(buf, buf[0]+1) << '\n';//pTime();
@@ -182,10 +223,33 @@ uint8_t CC::rcvData(uint8_t *buf) {														// read data packet from RX FIF
 
 	return buf[0];																		// return the data buffer
 }
+void    CC::rcvRestart(void) {															// flush the RX FIFO and go back to RX state
+	worExit();																			// a frame woke us up from WOR
+	strobe(CC1101_SFRX);																// flush Rx FIFO
+	strobe(CC1101_SIDLE);																// enter IDLE state
+	strobe(CC1101_SRX);																	// back to RX state
+	strobe(CC1101_SWORRST);																// reset real time clock
+	//	trx868.rfState = RFSTATE_RX;													// declare to be in Rx state
+}
+void    CC::worExit(void) {																// normal RX settings again after setWOR
+	if (!worActive) return;
+	static const uint8_t rxVal[] = { 0x87, 0x6B, 0xF8 };								// reset values, RC oscillator off
+	writeBurst(CC1101_WOREVT1, (uint8_t*)rxVal, 3);
+	writeReg(CC1101_MCSM2, 0x01);														// same as init
+	worActive = 0;
+}
+uint8_t CC::isGroup(uint8_t *id) {
+	for (uint8_t i = 0; i < rxGrpCnt; i++) {
+		if (!memcmp(id, rxGrp + i*3, 3)) return 1;
+	}
+	return 0;
+}
 void    CC::setIdle() {																	// put CC1101 into power-down state
+	ccSetBusy(1);																		// the interrupt must not restart RX in between
 	strobe(CC1101_SIDLE);																// coming from RX state, we need to enter the IDLE state first
 	strobe(CC1101_SFRX);
 	strobe(CC1101_SPWD);																// enter power down state
+	ccSetBusy(0);
 	//dbg << "pd\n";
 }
 uint8_t CC::detectBurst(void) {		
@@ -210,6 +274,7 @@ uint8_t CC::detectBurst(void) {
 	// possible solution for finding a burst is to check for bit 6, carrier sense
 
 	// power on cc1101 module and set to RX mode
+	ccSetBusy(1);
 	ccSelect();																			// wake up the communication module
 	waitMiso();
 	ccDeselect();
@@ -227,9 +292,30 @@ uint8_t CC::detectBurst(void) {
 		if ((bTmp & 0x10) || (bTmp & 0x40)) break;										// check for channel clear, or carrier sense
 		_delay_us(10);																	// wait a bit
 	}
+	ccSetBusy(0);
 	return (bTmp & 0x40)?1:0;															// return carrier sense bit
 }
 
+void    CC::setWOR(void) {																// RX polling by the RC oscillator, GDO0 wakes the MCU
+	// the chip sleeps and wakes up every tEVENT0 = 750 / 26MHz * 0x28A0 = 300ms, waits EVENT1 for the crystal and listens
+	// for RX_TIME = 0.45% of tEVENT0, 1.35ms. RX_TIME_RSSI ends the listening early without carrier, RX_TIME_QUAL keeps it
+	// in RX while the preamble of a burst is on air. the burst of 360ms covers one wake up for sure. GDO0 falls at the end
+	// of packet, the chip goes IDLE by MCSM1 and the normal receive path reads the fifo and restarts RX
+	static const uint8_t worVal[] = { 0x28, 0xA0, 0x78 };								// tEVENT0, RC oscillator on, EVENT1 = 7, RC_CAL, WOR_RES = 0
+	if (worActive) return;																// still polling, a restart would delay the next poll
+	ccSetBusy(1);																		// the interrupt must not restart RX in between
+	strobe(CC1101_SIDLE);																// WOR starts from IDLE
+	strobe(CC1101_SFRX);
+	writeBurst(CC1101_WOREVT1, (uint8_t*)worVal, 3);
+	writeReg(CC1101_MCSM2, 0x1B);														// RX_TIME_RSSI = 1, RX_TIME_QUAL = 1, RX_TIME = 3
+	worActive = 1;
+
+	strobe(CC1101_SWORRST);																// reset real time clock
+	strobe(CC1101_SWOR);																// start the RX polling
+	ccSetBusy(0);
+	enableGDO0Int();																	// end of packet wakes the MCU
+}
+
 void    CC::strobe(uint8_t cmd) {														// send command strobe to the CC1101 IC via SPI
 	ccSelect();																			// select CC1101
 	waitMiso();																			// wait until MISO goes low
@@ -10,14 +10,20 @@
 #define _CC_H
 
 #include "HAL.h"
-#include <util/delay.h>
 
 class CC {
 	friend class AS;
 	friend class SN;
 	friend class PW;
+	friend class RV;
   
   public:		//---------------------------------------------------------------------------------------------------------
+	uint16_t rxSkip;																		// statistics, frames for others dropped after the receiver id
+	uint32_t rxSkipBytes;																	// ...and the fifo bytes not clocked out for them
+
+	uint8_t *rxGrp;																			// group ids which pass the filter as well, 3 byte each
+	uint8_t  rxGrpCnt;																		// ...and how many, set by AS::initGroups
+
   protected:	//---------------------------------------------------------------------------------------------------------
   private:		//---------------------------------------------------------------------------------------------------------
 
@@ -25,6 +31,16 @@ class CC {
 	uint8_t crc_ok;																			// CRC OK for received message
 	uint8_t rssi;																			// signal strength
 	uint8_t lqi;																			// link quality
+	uint8_t worActive;																		// wake on radio register values are loaded, see setWOR
+
+	#define CC1101_TX_LEN            32														// longest frame we send, see MaxSndLen
+	#define CC_TX_IDLE               0														// transmitter states
+	#define CC_TX_SETUP              1														// waiting for TX mode or burst preamble on air
+	#define CC_TX_DATA               2														// frame on air
+	uint8_t  txStat;																		// state of the transmitter
+	uint8_t  txBuf[CC1101_TX_LEN];															// encoded frame, until it is written into the fifo
+	tMillis  txTime;																		// start of the current state
+	uint16_t txWait;																		// duration of the current state
 
 	// CC1101 config register													// Reset  Description
 	#define CC1101_IOCFG2           0x00										// (0x29) GDO2 Output Pin Configuration
@@ -157,6 +173,7 @@ class CC {
   public:		//---------------------------------------------------------------------------------------------------------
 	void    setIdle(void);																	// put CC1101 into power-down state
 	uint8_t detectBurst(void);																// detect burst signal, sleep while no signal, otherwise stay awake
+	void    setWOR(void);																	// RX polling by the RC oscillator, GDO0 wakes the MCU
 
   protected:	//---------------------------------------------------------------------------------------------------------
   private:		//---------------------------------------------------------------------------------------------------------
@@ -164,8 +181,12 @@ class CC {
 	CC();
 
 	void    init();																			// initialize CC1101
-	uint8_t sndData(uint8_t *buf, uint8_t burst);											// send data packet via RF
-	uint8_t rcvData(uint8_t *buf);															// read data packet from RX FIFO
+	uint8_t startTx(uint8_t *buf, uint8_t burst);											// start sending a data packet via RF, returns at once
+	uint8_t txDone(void);																	// drives the transmitter, 1 if nothing is on the way
+	uint8_t rcvData(uint8_t *buf, uint8_t *ownID);											// read and decode a data packet from RX FIFO
+	void    rcvRestart(void);																// flush the RX FIFO and go back to RX state
+	void    worExit(void);																	// normal RX settings again after setWOR
+	uint8_t isGroup(uint8_t *id);															// 1 if id is one of rxGrp
 	
 	void    strobe(uint8_t cmd);															// send command strobe to the CC1101 IC via SPI
 	void    readBurst(uint8_t * buf, uint8_t regAddr, uint8_t len);							// read burst data from CC1101 via SPI
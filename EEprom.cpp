@@ -11,6 +11,164 @@
 
 uint8_t MAID[3];
 
+//- eeprom read cache -----------------------------------------------------------------------------------------------------
+// with an external eeprom every read is an i2c transfer, so reads go through a small direct mapped cache of eeCacheLines
+// lines. bytes the HAL takes for writing are updated in the cache. the internal eeprom needs no cache, eeCacheLines is 0
+#ifndef eeCacheLines
+	#ifdef EE_EXT
+		#define eeCacheLines 8
+	#else
+		#define eeCacheLines 0
+	#endif
+#endif
+#define eeCacheLine 16																	// bytes per line, power of 2
+s_eeRdStat eeRdStat;
+
+#if eeCacheLines
+static struct s_eeCache {
+	uint16_t line;																		// eeprom address / eeCacheLine + 1, 0 for an empty line
+	uint8_t  val[eeCacheLine];
+} eeCache[eeCacheLines];
+
+static void    eeRead(uint16_t addr, uint8_t len, void *ptr) {
+	uint8_t *p = (uint8_t*)ptr;
+	while (len) {
+		uint16_t line = addr / eeCacheLine;
+		s_eeCache *c = &eeCache[line % eeCacheLines];
+		eeRdStat.reads++;
+		if (c->line != line + 1) {														// miss, load the whole line
+			eeRdStat.misses++;
+			c->line = 0;
+			if (readEEProm(line * eeCacheLine, eeCacheLine, c->val)) c->line = line + 1;
+			else eeRdStat.errors++;														// 0xff for now, keep the line empty and ask again
+		}
+
+		uint8_t ofs = addr & (eeCacheLine - 1), n = eeCacheLine - ofs;
+		if (n > len) n = len;
+		memcpy(p, c->val + ofs, n);
+		addr += n; p += n; len -= n;
+	}
+}
+static void    eeCacheSet(uint16_t addr, uint8_t len, uint8_t *val) {
+	for (uint8_t i = 0; i < len; i++, addr++) {
+		s_eeCache *c = &eeCache[(addr / eeCacheLine) % eeCacheLines];
+		if (c->line == addr / eeCacheLine + 1) c->val[addr & (eeCacheLine - 1)] = val[i];
+	}
+}
+#else
+static void    eeRead(uint16_t addr, uint8_t len, void *ptr) {
+	if (!readEEProm(addr, len, ptr)) eeRdStat.errors++;
+}
+	#define eeCacheSet(addr, len, val)
+#endif
+
+//- eeprom write buffer ---------------------------------------------------------------------------------------------------
+// changed bytes are kept in a small buffer sorted by address, unchanged bytes are skipped. reads see the buffered content.
+// flushEEProm hands the lowest run of adjacent bytes over to the HAL, from AS::poll without waiting, before sleep until
+// everything is written. only a full buffer lets setEEPromBlock wait for the eeprom
+#ifndef eeBufSize
+	#ifdef EE_EXT
+		#define eeBufSize 32															// page writes take longer runs
+	#else
+		#define eeBufSize 16
+	#endif
+#endif
+#ifndef eeWrWait
+	#define eeWrWait 200																// 100us steps a waiting flush gives the eeprom to take the next write
+#endif
+static struct s_eeBuf {
+	uint16_t addr;
+	uint8_t  val;
+} eeBuf[eeBufSize];
+static uint8_t eeBufCnt;
+s_eeWrStat eeWrStat;
+s_lstStat  lstStat;
+
+static uint8_t eeBufFind(uint16_t addr) {
+	uint8_t i = 0;																		// first entry with an address >= addr
+	while ((i < eeBufCnt) && (eeBuf[i].addr < addr)) i++;
+	return i;
+}
+static uint8_t eeBufFlushRun(uint8_t wait) {
+	uint8_t val[eeBufSize], n = 0, done, tries = 0;
+	while ((n < eeBufCnt) && (eeBuf[n].addr == eeBuf[0].addr + n)) {					// collect the run of adjacent bytes
+		val[n] = eeBuf[n].val;
+		n++;
+	}
+
+	while (!(done = writeEEProm(eeBuf[0].addr, n, val))) {								// eeprom is busy
+		if (!wait) return 0;
+		if (++tries == eeWrWait) return 0;												// no write finishes that long, the eeprom fails
+		_delay_us(100);
+	}
+
+	eeCacheSet(eeBuf[0].addr, done, val);
+	eeWrStat.wrBytes += done;
+	eeBufCnt -= done;
+	memmove(eeBuf, eeBuf + done, eeBufCnt * sizeof(eeBuf[0]));
+	return done;
+}
+static void    eeBufSet(uint16_t addr, uint8_t val) {
+	eeWrStat.setBytes++;
+
+	uint8_t cur, i = eeBufFind(addr);
+	if ((i < eeBufCnt) && (eeBuf[i].addr == addr)) {									// already buffered
+		if (eeBuf[i].val == val) { eeWrStat.skipBytes++; return; }
+
+		eeRead(addr, 1, &cur);
+		if (cur != val) { eeBuf[i].val = val; return; }									// still a change
+
+		eeBufCnt--;																		// back to the eeprom content, nothing to write
+		memmove(&eeBuf[i], &eeBuf[i+1], (eeBufCnt - i) * sizeof(eeBuf[0]));
+		eeWrStat.skipBytes++;
+		return;
+	}
+
+	eeRead(addr, 1, &cur);
+	if (cur == val) { eeWrStat.skipBytes++; return; }									// same content already
+
+	if (eeBufCnt >= eeBufSize) {														// no space, write the lowest run first
+		if (!eeBufFlushRun(1)) { eeWrStat.errors++; return; }							// eeprom fails, the byte is lost
+		i = eeBufFind(addr);
+	}
+
+	memmove(&eeBuf[i+1], &eeBuf[i], (eeBufCnt - i) * sizeof(eeBuf[0]));					// insert sorted
+	eeBuf[i].addr = addr;
+	eeBuf[i].val = val;
+	eeBufCnt++;
+	if (eeBufCnt > eeWrStat.bufMax) eeWrStat.bufMax = eeBufCnt;
+}
+
+void    getEEPromBlock(uint16_t addr,uint8_t len,void *ptr) {
+	eeRead(addr, len, ptr);
+	for (uint8_t i = eeBufFind(addr); (i < eeBufCnt) && (eeBuf[i].addr < addr + len); i++) {
+		((uint8_t*)ptr)[eeBuf[i].addr - addr] = eeBuf[i].val;							// buffered bytes are newer
+	}
+}
+void    setEEPromBlock(uint16_t addr,uint8_t len,void *ptr) {
+	for (uint8_t i = 0; i < len; i++) {
+		eeBufSet(addr + i, ((uint8_t*)ptr)[i]);
+	}
+}
+void    clearEEPromBlock(uint16_t addr, uint16_t len) {
+	for (uint16_t l = 0; l < len; l++) {												// step through the bytes of eeprom
+		eeBufSet(addr + l, 0);
+	}
+}
+uint8_t flushEEProm(uint8_t wait) {
+	if (!wait) {																		// start the next write if the eeprom is ready
+		if (eeBufCnt) eeBufFlushRun(0);
+		return eeBufCnt;
+	}
+
+	while (eeBufCnt) {																	// write everything
+		if (eeBufFlushRun(1)) continue;
+		eeWrStat.errors += eeBufCnt;													// eeprom fails, drop the buffer instead of hanging
+		eeBufCnt = 0;
+	}
+	return 0;
+}
+
 
 // public:		//---------------------------------------------------------------------------------------------------------
 uint8_t  EE::getList(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t *buf) {
@@ -19,9 +177,50 @@ uint8_t  EE::getList(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t *buf) {
 
 	if (!checkIndex(cnl, lst, idx)) return 0;
 
+	uint8_t *l = getPeerList(cnl, lst, idx);											// list3/4 out of the ram copies
+	if (l) {
+		memcpy(buf, l, cnlTbl[xI].sLen);												// the module works on its own copy, it changes l3
+		return 1;
+	}
+
 	getEEPromBlock(cnlTbl[xI].pAddr + (cnlTbl[xI].sLen * idx), cnlTbl[xI].sLen, buf);	// get the eeprom content
 	return 1;
 }
+uint8_t  *EE::getPeerList(uint8_t cnl, uint8_t lst, uint8_t idx) {
+	#if lstLruCnt
+	if ((lst != 3) && (lst != 4)) return NULL;											// only peer lists are cached
+
+	uint8_t xI = getRegListIdx(cnl, lst);
+	if ((xI == 0xff) || (cnlTbl[xI].sLen > lstLruLen)) return NULL;						// unknown or too long for a copy
+	if (!checkIndex(cnl, lst, idx)) return NULL;
+
+	s_lstLru *e = &lstLru[0];
+	for (uint8_t i = 0; i < lstLruCnt; i++) {											// the matching entry, otherwise the oldest one
+		s_lstLru *c = &lstLru[i];
+		if ((c->cnl == cnl) && (c->lst == lst) && (c->idx == idx)) { e = c; break; }
+		if ((!c->cnl) || ((e->cnl) && (c->age > e->age))) e = c;
+	}
+
+	if ((e->cnl == cnl) && (e->lst == lst) && (e->idx == idx)) {
+		lstStat.hits++;
+	} else {
+		lstStat.misses++;
+		e->cnl = cnl;
+		e->lst = lst;
+		e->idx = idx;
+		e->age = 0xff;																	// older than all, the aging below skips it
+		getEEPromBlock(cnlTbl[xI].pAddr + (cnlTbl[xI].sLen * idx), cnlTbl[xI].sLen, e->val);
+	}
+
+	for (uint8_t i = 0; i < lstLruCnt; i++) {											// entries used after e get older
+		if ((lstLru[i].cnl) && (lstLru[i].age < e->age)) lstLru[i].age++;
+	}
+	e->age = 0;
+	return e->val;
+	#else
+	return NULL;
+	#endif
+}
 /**
  * @brief Write arbitrary data as list content to EEprom
  *
@@ -44,12 +243,12 @@ uint8_t  EE::getList(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t *buf) {
  *
  * In a simple example, the channel slice address definition for List0 is:
  * @code
- * const uint8_t cnlAddr[] PROGMEM = {
+ * EE_CONST uint8_t cnlAddr[] PROGMEM = {
  *     0x02, 0x05, 0x0a, 0x0b, 0x0c, 0x14, 0x24, 0x25, 0x26, 0x27, // sIdx 0x00, 10 bytes for Channel0/List0
  *     0x01,                                                       // sIdx 0x0a,  1 byte  for Channel1/List4
  * }; // 11 byte
  *
- * EE::s_cnlTbl cnlTbl[] = {
+ * EE_CONST EE::s_cnlTbl cnlTbl[] = {
  *     // cnl, lst, sIdx, sLen, pAddr;
  *     {  0,  0, 0x00, 10,  0x000f }, // Channel0/List0, 10 bytes at sIdx 0x00, Addr 0x000f
  *     {  1,  4, 0x0a,  1,  0x0019 }, // Channel1/List4,  1 byte  at sIdx 0x0a, Addr 0x0019
@@ -82,6 +281,7 @@ uint8_t  EE::setList(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t *buf) {
 
 	if (!checkIndex(cnl, lst, idx)) return 0;
 
+	dropLstLru(cnl, lst, idx);															// ram copy is outdated
 	setEEPromBlock(cnlTbl[xI].pAddr + (cnlTbl[xI].sLen * idx), cnlTbl[xI].sLen, buf);	// get the eeprom content
 	return 1;
 }
@@ -94,13 +294,12 @@ uint8_t  EE::getRegAddr(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t addr) {
 
 	uint16_t eIdx = cnlTbl[xI].pAddr + (cnlTbl[xI].sLen * idx);
 
+	uint8_t j = getRegOffset(xI, addr);
+	if (j == 0xff) return 0;															// address not found
+
 	uint8_t retByte;
-	for (uint8_t j = 0; j < cnlTbl[xI].sLen; j++) {										// search for the right address in cnlAddr
-		if (_pgmB(devDef.cnlAddr[cnlTbl[xI].sIdx + j]) == addr) {						// if byte fits
-			getEEPromBlock(eIdx + j, 1, (void*)&retByte);								// get the respective byte from eeprom
-			return retByte;																// and exit
-		}
-	}
+	getEEPromBlock(eIdx + j, 1, (void*)&retByte);										// get the respective byte from eeprom
+	return retByte;
 }
 uint32_t EE::getHMID(void) {
 	uint8_t a[3];
@@ -124,6 +323,7 @@ void     EE::init(void) {
 	#endif
 
 	initEEProm();																		// init function if a i2c eeprom is used
+	lstCache[2] = 0xff;																	// nothing looked up so far
 
 	// check for first time run by checking magic byte, if yes then prepare eeprom and set magic byte
 	uint16_t eepromCRC = 0, flashCRC = 0;												// define variable for storing crc
@@ -152,6 +352,8 @@ void     EE::init(void) {
 		firstTimeStart();																// function to be placed in register.h, to setup default values on first time start
 	}
 
+	initPeerIdx();																		// load the peer database into ram
+
 	// load HMID and serial from eeprom
 	if (*(uint16_t*)&HMID == NULL) getEEPromBlock(2, 3, HMID);							// check if HMID variable is set and valid, otherwise load from eeprom
 	if (*(uint16_t*)&HMSR == NULL) getEEPromBlock(5, 10, HMSR);
@@ -164,6 +366,14 @@ void     EE::init(void) {
 
 }
 void     EE::getMasterID(void) {
+	uint8_t xI = getRegListIdx(0, 0);
+	uint8_t j = (xI == 0xff) ? 0xff : getRegOffset(xI, 0x0a);
+
+	// slices are ascending, so 0x0c two bytes behind 0x0a means the master id is stored in one piece
+	if ((j != 0xff) && (j+2 < cnlTbl[xI].sLen) && (_pgmB(devDef.cnlAddr[cnlTbl[xI].sIdx + j+2]) == 0x0c)) {
+		getEEPromBlock(cnlTbl[xI].pAddr + j, 3, MAID);
+		return;
+	}
 	MAID[0] = getRegAddr(0, 0, 0, 0x0a);
 	MAID[1] = getRegAddr(0, 0, 0, 0x0b);
 	MAID[2] = getRegAddr(0, 0, 0, 0x0c);
@@ -205,14 +415,13 @@ void     EE::testModul(void) {															// prints register.h content on con
 	_delay_ms(100);
 
 	// get the strings
-	uint8_t aTst5[16], bReturn, bSlices, bFreeSlots, bTotalSlots;
+	uint8_t aTst5[16], bReturn, bFreeSlots, bTotalSlots, bPos = 0;
 	bTotalSlots = getPeerSlots(1);
 	bFreeSlots = countFreeSlots(1);
-	bSlices = countPeerSlc(1);
 
-	dbg << F("total slots: ") << bTotalSlots << F(", free slots: ") << bFreeSlots << F(", slices: ") << bSlices << '\n';
-	for (uint8_t i = 1; i <= bSlices; i++) {
-		bReturn = getPeerListSlc(1, i, aTst5);
+	dbg << F("total slots: ") << bTotalSlots << F(", free slots: ") << bFreeSlots << '\n';
+	for (uint8_t i = 1; bPos != 0xff; i++) {
+		bReturn = getPeerListSlc(1, &bPos, aTst5);
 		dbg << "s" << i << ": " << bReturn << F(" byte, ") << pHex(aTst5,bReturn) << '\n';
 	}
 
@@ -252,12 +461,11 @@ void     EE::testModul(void) {															// prints register.h content on con
 	dbg << (millis()-xtime) << F(" ms\n");
 
 	xtime = millis();
-	bReturn = getRegListSlc(1, 3, 1, 0, aTst5);
-	dbg << pHex(aTst5, bReturn) << '\n';
-	bReturn = getRegListSlc(1, 3, 1, 1, aTst5);
-	dbg << pHex(aTst5, bReturn) << '\n';
-	bReturn = getRegListSlc(1, 3, 1, 2, aTst5);
-	dbg << pHex(aTst5, bReturn) << '\n';
+	bPos = 0;
+	while (bPos != 0xff) {
+		bReturn = getRegListSlc(1, 3, 1, &bPos, aTst5);
+		dbg << pHex(aTst5, bReturn) << '\n';
+	}
 	dbg << (millis()-xtime) << F(" ms\n");
 
 	dbg << pLine;
@@ -292,14 +500,91 @@ uint8_t  EE::getIntend(uint8_t *reId, uint8_t *toId, uint8_t *peId) {
 }
 
 // peer functions
+void     EE::initPeerIdx(void) {
+	uint16_t cnt = 0;
+	for (uint8_t i = 0; i < devDef.cnlNbr; i++) cnt += peerTbl[i].pMax;				// count the peer slots of all channels
+
+	peerIdxCnt = 0;																		// index stays off if the slots don't fit
+	peerHashCnt = 0;
+	if (cnt > maxPeers) {
+		#ifdef EE_DBG																	// only if ee debug is set
+		dbg << F("peer index off, slots: ") << cnt << F(", maxPeers: ") << maxPeers << '\n';
+		#endif
+		if (cnt > maxPeers * 4) return;													// not even a hash byte per slot
+
+		uint8_t lPeer[4], *h = peerIdx[0];
+		for (uint8_t i = 0; i < devDef.cnlNbr; i++) {									// step through all channels
+			for (uint8_t j = 0; j < peerTbl[i].pMax; j++) {								// and the peer slots of the channel
+				getEEPromBlock(peerTbl[i].pAddr+(j*4), 4, lPeer);
+				*h++ = peerHash(lPeer);
+			}
+		}
+		peerHashCnt = cnt;
+		return;
+	}
+
+	uint8_t n = 0;
+	for (uint8_t i = 0; i < devDef.cnlNbr; i++) {										// step through all channels
+		for (uint8_t j = 0; j < peerTbl[i].pMax; j++) {									// and the peer slots of the channel
+			getEEPromBlock(peerTbl[i].pAddr+(j*4), 4, peerIdx[n++]);					// get peer from eeprom
+		}
+	}
+	peerIdxCnt = n;
+	setPeerBloom();
+}
+void     EE::setPeerBloom(void) {
+	memset(peerBloom, 0, sizeof(peerBloom));
+
+	for (uint8_t i = 0; i < peerIdxCnt; i++) {											// step through the ram index
+		uint8_t *p = peerIdx[i];
+		if (isEmpty(p, 4)) continue;													// empty slots don't count
+
+		uint8_t h1 = (p[0] ^ p[1] ^ p[2]) & 0x3f;										// two bits out of 64 per peer id
+		uint8_t h2 = ((uint8_t)(p[0] + p[1] + p[2]) >> 2) & 0x3f;
+		peerBloom[h1 >> 3] |= _BV(h1 & 7);
+		peerBloom[h2 >> 3] |= _BV(h2 & 7);
+	}
+}
+uint8_t  EE::checkPeerBloom(uint8_t *peer) {
+	if (!peerIdxCnt) return 1;															// no index, can't say anything
+
+	uint8_t h1 = (peer[0] ^ peer[1] ^ peer[2]) & 0x3f;
+	uint8_t h2 = ((uint8_t)(peer[0] + peer[1] + peer[2]) >> 2) & 0x3f;
+	return (peerBloom[h1 >> 3] & _BV(h1 & 7)) && (peerBloom[h2 >> 3] & _BV(h2 & 7));
+}
+uint8_t  *EE::getPeerIdxSlot(uint8_t cnl, uint8_t idx) {
+	if ((!peerIdxCnt) || (!cnl)) return NULL;											// no index or no peer channel
+
+	uint8_t ofs = idx;
+	for (uint8_t i = 0; i < cnl-1; i++) ofs += peerTbl[i].pMax;							// slots of the channels before
+	return peerIdx[ofs];
+}
+uint8_t  *EE::getPeerHash(uint8_t cnl) {
+	if ((!peerHashCnt) || (!cnl)) return NULL;											// no hash bytes or no peer channel
+
+	uint16_t ofs = 0;
+	for (uint8_t i = 0; i < cnl-1; i++) ofs += peerTbl[i].pMax;							// slots of the channels before
+	return peerIdx[0] + ofs;
+}
+uint8_t  EE::peerHash(uint8_t *peer) {
+	uint8_t h = 0;
+	for (uint8_t i = 0; i < 4; i++) h = ((h << 1) | (h >> 7)) ^ peer[i];				// rotate and xor
+	if ((!h) && (!isEmpty(peer, 4))) h = 1;												// 0 stands for an empty slot only
+	return h;
+}
+
 void     EE::clearPeers(void) {
 	for (uint8_t i = 0; i < devDef.cnlNbr; i++) {										// step through all channels
 		clearEEPromBlock(peerTbl[i].pAddr, peerTbl[i].pMax * 4);
 		//dbg << F("clear eeprom, addr ") << peerTbl[i].pAddr << F(", len ") << (peerTbl[i].pMax * 4) << '\n';																	// ...and some information
 	}
+	memset(peerIdx, 0, sizeof(peerIdx));												// and the ram index
+	memset(peerBloom, 0, sizeof(peerBloom));
 }
 uint8_t  EE::isPeerValid (uint8_t *peer) {
 	//dbg << "p: " << _HEX(peer, 4) << '\n';
+	if (!checkPeerBloom(peer)) return 0;												// sender is for sure not in the peer database
+
 	for (uint8_t i = 1; i <= devDef.cnlNbr; i++) {										// step through all channels
 		if (getIdxByPeer(i, peer) != 0xff) return i;									// if a valid peer is found return the respective channel
 	}
@@ -313,8 +598,12 @@ uint8_t  EE::countFreeSlots(uint8_t cnl) {
 	if ((!cnl) || (cnl > devDef.cnlNbr)) return 0;										// return if channel is out of range
 	//dbg << F("cFS: ") << peerTbl[cnl-1].pMax << '\n';
 
+	uint8_t *slot = getPeerIdxSlot(cnl, 0);												// ram index of the channel, if there is one
+	uint8_t *hash = getPeerHash(cnl);													// or the hash bytes
 	for (uint8_t i = 0; i < peerTbl[cnl-1].pMax; i++) {									// step through the possible peer slots
-		getEEPromBlock(peerTbl[cnl-1].pAddr+(i*4), 4, lPeer);							// get peer from eeprom
+		if (hash) { bCounter += !hash[i]; continue; }									// hash byte 0 is an empty slot
+		if (slot) memcpy(lPeer, slot+(i*4), 4);											// get peer from ram
+		else getEEPromBlock(peerTbl[cnl-1].pAddr+(i*4), 4, lPeer);						// or from eeprom
 		//if (!*(unsigned long*)lPeer) bCounter++;										// increase counter if peer slot is empty
 		if (isEmpty(lPeer, 4)) bCounter++;												// increase counter if peer slot is empty
 		//dbg << F("addr: ") << (peerTbl[cnl-1].pAddr+(i*4)) << F(", lPeer: ") << pHex(lPeer, 4) << '\n';
@@ -327,15 +616,24 @@ uint8_t  EE::getIdxByPeer(uint8_t cnl, uint8_t *peer) {
 	if (!cnl) return 0;																	// on channel 0 there is no need to search
 	if (cnl > devDef.cnlNbr) return 0xff;												// return if channel is out of range
 
+	uint8_t *slot = getPeerIdxSlot(cnl, 0);												// ram index of the channel, if there is one
+	if ((slot) && (!checkPeerBloom(peer))) return 0xff;									// sender is for sure not in the peer database
+	uint8_t *hash = getPeerHash(cnl), h = peerHash(peer);								// without index the hash bytes, if there are some
+
 	for (uint8_t i = 0; i < peerTbl[cnl-1].pMax; i++) {									// step through the possible peer slots
-		getEEPromBlock(peerTbl[cnl-1].pAddr+(i*4), 4, lPeer);							// get peer from eeprom
+		if ((hash) && (hash[i] != h)) continue;											// for sure another peer, no need to read the slot
+		if (slot) memcpy(lPeer, slot+(i*4), 4);											// get peer from ram
+		else getEEPromBlock(peerTbl[cnl-1].pAddr+(i*4), 4, lPeer);						// or from eeprom
 		if (compArray(lPeer, peer, 4)) return i;										// if result matches then return slot index
 		//dbg << i << ": " << _HEX(lPeer,4) << ", s: " << _HEX(peer, 4) << '\n';
 	}
 	return 0xff;
 }
 uint8_t  EE::getPeerByIdx(uint8_t cnl, uint8_t idx, uint8_t *peer) {
-	getEEPromBlock(peerTbl[cnl-1].pAddr+(idx*4), 4, peer);
+	uint8_t *slot = getPeerIdxSlot(cnl, idx);
+	if (slot) memcpy(peer, slot, 4);													// get peer from ram
+	else getEEPromBlock(peerTbl[cnl-1].pAddr+(idx*4), 4, peer);						// or from eeprom
+	return 1;
 }
 uint8_t  EE::addPeer(uint8_t cnl, uint8_t *peer) {
 	uint8_t lPeer[4];
@@ -355,30 +653,42 @@ uint8_t  EE::addPeer(uint8_t cnl, uint8_t *peer) {
 	if (peer[4]) cnt |= 2;
 
 	// count free peer slots and check against cnt
-	for (uint8_t i = 0; i < peerTbl[cnl1].pMax; i++) {									// step through the possible peer slots
-		getEEPromBlock(peerTbl[cnl1].pAddr+(i*4), 4, lPeer);							// get peer from eeprom
-		if (isEmpty(lPeer, 4)) ret++;													// increase counter if peer slot is empty
-	}
+	uint8_t *slot = getPeerIdxSlot(cnl, 0);												// ram index of the channel, if there is one
+	uint8_t *hash = getPeerHash(cnl);													// or the hash bytes
+	ret = countFreeSlots(cnl);
 	if (((peer[3]) && (peer[4])) && (ret < 2)) return 0;								// not enough space, return failure
 	if (((peer[3]) || (peer[4])) && (ret < 1)) return 0;
 
 	// search for free peer slots and write content
-	for (uint8_t i = 0; i < peerTbl[cnl1].pMax; i++) {									// step through the possible peer slots
-		getEEPromBlock(peerTbl[cnl1].pAddr+(i*4), 4, lPeer);							// get peer from eeprom
+	for (uint8_t i = 0; (i < peerTbl[cnl1].pMax) && (cnt); i++) {						// step through the possible peer slots
+		if ((hash) && (hash[i])) continue;												// slot is in use
+		if (slot) memcpy(lPeer, slot+(i*4), 4);											// get peer from ram
+		else getEEPromBlock(peerTbl[cnl1].pAddr+(i*4), 4, lPeer);						// or from eeprom
 
 		if        (isEmpty(lPeer, 4) && (cnt & 1)) {									// slot is empty and peer cnlA is set
 			cnt ^= 1;
 			setEEPromBlock(peerTbl[cnl1].pAddr+(i*4), 4, peer);
+			if (slot) memcpy(slot+(i*4), peer, 4);										// keep the ram index in sync
+			if (hash) hash[i] = peerHash(peer);
 			peer[5] = i;																// remember the idx position, add to the buffer
 
 		} else if (isEmpty(lPeer, 4) && (cnt & 2)) {									// slot is empty and peer cnlB is set
 			cnt ^= 2;
 			setEEPromBlock(peerTbl[cnl1].pAddr+(i*4), 3, peer);						// first 3 bytes
 			setEEPromBlock(peerTbl[cnl1].pAddr+(i*4)+3, 1, peer+4);					// 5th byte
+			if (slot) {																	// keep the ram index in sync
+				memcpy(slot+(i*4), peer, 3);
+				slot[(i*4)+3] = peer[4];
+			}
+			if (hash) {
+				memcpy(lPeer, peer, 3); lPeer[3] = peer[4];
+				hash[i] = peerHash(lPeer);
+			}
 			peer[6] = i;																// remember the idx position, add to the buffer
 
 		}
 	}
+	setPeerBloom();																		// new peers have to pass the filter
 	return 1;																			// everything went fine, return success
 }
 uint8_t  EE::remPeer(uint8_t cnl, uint8_t *peer) {
@@ -393,55 +703,55 @@ uint8_t  EE::remPeer(uint8_t cnl, uint8_t *peer) {
 	//dbg << "a: " << pHex(peer,4) << ", b: " << pHex(tPeer,4) << '\n';
 
 	// search for peers and delete them
+	uint8_t *slot = getPeerIdxSlot(cnl, 0);												// ram index of the channel, if there is one
+	uint8_t *hash = getPeerHash(cnl), hA = peerHash(peer), hB = peerHash(tPeer);		// or the hash bytes
 	for (uint8_t i = 0; i < peerTbl[cnl-1].pMax; i++) {									// step through the possible peer slots
-		getEEPromBlock(peerTbl[cnl-1].pAddr+(i*4), 4, lPeer);							// get peer from eeprom
+		if ((hash) && (hash[i] != hA) && (hash[i] != hB)) continue;						// neither peer A nor B
+		if (slot) memcpy(lPeer, slot+(i*4), 4);											// get peer from ram
+		else getEEPromBlock(peerTbl[cnl-1].pAddr+(i*4), 4, lPeer);						// or from eeprom
 
 		if (compArray(lPeer, peer, 4) || compArray(lPeer ,tPeer, 4)) {					// check if something matches
 			clearEEPromBlock(peerTbl[cnl-1].pAddr+(i*4), 4);							// free the slot
+			if (slot) memset(slot+(i*4), 0, 4);											// in the ram index too
+			if (hash) hash[i] = 0;
 		}
 	}
+	setPeerBloom();																		// removed peers should not pass the filter any more
 	return 1;
 }
-uint8_t  EE::countPeerSlc(uint8_t cnl) {
-	if (cnl > devDef.cnlNbr) return 0;													// return if channel is out of range
-
-	int16_t lTmp = peerTbl[cnl-1].pMax - countFreeSlots(cnl) + 1;						// get used slots and add one for terminating zeros
-	lTmp = lTmp * 4;																	// 4 bytes per slot
-
-	uint8_t bMax = 0;																	// size return value
-	while (lTmp > 0) {																	// loop until lTmp gets 0
-		lTmp = lTmp - maxMsgLen;														// reduce by max message len
-		bMax++;																			// count the loops
+uint8_t  EE::getPeerListSlc(uint8_t cnl, uint8_t *pos, uint8_t *buf) {
+	// *pos is the cursor, 0 for the first slice. every call resumes at the slot where the last one stopped, the slice
+	// which holds the terminating zeros sets *pos to 0xff. peers are read in blocks of as many slots as still fit
+	if ((!cnl) || (cnl > devDef.cnlNbr)) {												// channel out of range, answer with an empty list
+		memset(buf, 0, 4);
+		*pos = 0xff;
+		return 4;
 	}
-	return bMax;																		// return amount of slices
-}
-uint8_t  EE::getPeerListSlc(uint8_t cnl, uint8_t slc, uint8_t *buf) {
-	if (cnl > devDef.cnlNbr) return 0;													// return if channel is out of range
-
-	uint8_t byteCnt = 0, slcCnt = 0;													// start the byte counter
-
-	for (uint8_t i = 0; i < peerTbl[cnl-1].pMax; i++) {									// step through the possible peer slots
 
-		getEEPromBlock(peerTbl[cnl-1].pAddr+(i*4), 4, buf);								// get peer from eeprom
-		if (isEmpty(buf, 4)) continue;													// peer is empty therefor next
+	uint8_t pMax = peerTbl[cnl-1].pMax, byteCnt = 0;
+	uint8_t *slot = getPeerIdxSlot(cnl, 0);												// ram index of the channel, if there is one
 
-		byteCnt+=4;																		// if we are here, then it is valid and we should increase the byte counter
-		//dbg << i << ": " << pHex(buf,4) << ", bC: " << byteCnt  << ", sC: " << slcCnt << '\n';
+	while ((*pos < pMax) && (byteCnt < maxMsgLen)) {									// until the slice is full or all slots are done
+		uint8_t n = (maxMsgLen - byteCnt) / 4, *blk = buf + byteCnt;
+		if (n > pMax - *pos) n = pMax - *pos;
 
-		if ((slcCnt == slc) && (byteCnt >= maxMsgLen)) {								// we are in the right slice but string is full
-			return byteCnt;																// return the amount of bytes in the string
+		if (slot) memcpy(blk, slot+(*pos*4), n*4);										// get the block from ram
+		else getEEPromBlock(peerTbl[cnl-1].pAddr+(*pos*4), n*4, blk);					// or from eeprom
+		*pos += n;
 
-		} else if (byteCnt >= maxMsgLen) {												// only counter is full
-			slcCnt++;																	// increase the slice counter
-			byteCnt = 0;																// and reset the byte counter
-
-		} else if (slcCnt == slc) {														// we are in the fitting slice
-			buf+=4;																		// therefore we should increase the string counter
+		for (uint8_t i = 0; i < n; i++) {												// keep the used slots only
+			if (isEmpty(blk+(i*4), 4)) continue;
+			memmove(buf+byteCnt, blk+(i*4), 4);
+			byteCnt += 4;
 		}
 	}
 
-	memset(buf, 0, 4);																	// add the terminating zeros
-	return byteCnt + 4;																	// return the amount of bytes
+	if ((*pos >= pMax) && (byteCnt < maxMsgLen)) {										// all slots done and room left
+		memset(buf+byteCnt, 0, 4);														// add the terminating zeros
+		byteCnt += 4;
+		*pos = 0xff;
+	}
+	return byteCnt;																		// return the amount of bytes
 }
 uint8_t  EE::getPeerSlots(uint8_t cnl) {													// returns the amount of possible peers
 	if (cnl > devDef.cnlNbr) return 0;
@@ -452,6 +762,8 @@ uint8_t  EE::getPeerSlots(uint8_t cnl) {													// returns the amount of po
 void     EE::clearRegs(void) {
 	uint8_t peerMax;
 
+	dropLstLru(0xff, 0, 0);																// all ram copies are outdated
+
 	for (uint8_t i = 0; i < devDef.lstNbr; i++) {										// steps through the cnlTbl
 
 		if ((cnlTbl[i].lst == 3) || (cnlTbl[i].lst == 4)) {								// list3/4 is peer based
@@ -481,38 +793,62 @@ uint8_t  EE::countRegListSlc(uint8_t cnl, uint8_t lst) {
 	}
 	return bMax+1;																		// return amount of slices
 }
-uint8_t  EE::getRegListSlc(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t slc, uint8_t *buf) {
-
+uint8_t  EE::getRegListSlc(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t *pos, uint8_t *buf) {
+	// *pos is the cursor, the byte offset within the list. every call reads the next maxMsgLen/2 bytes with one eeprom
+	// access, the slice after the last one holds the terminating zeros and sets *pos to 0xff
 	uint8_t xI = getRegListIdx(cnl, lst);
-	if (xI == 0xff) return 0;															// respective line not found
-	//dbg << "idx " << idx << " pT " << peerTbl[cnl-1].pMax << '\n';
+	if ((xI == 0xff) || (!checkIndex(cnl, lst, idx))) { *pos = 0xff; return 0; }		// line not found or peer index out of range
 
-	if (!checkIndex(cnl, lst, idx)) return 0;											// check if peer index is in range
+	uint8_t remByte = (*pos < cnlTbl[xI].sLen) ? cnlTbl[xI].sLen - *pos : 0;			// calculate the remaining bytes
+	if (!remByte) {																		// everything sent, add terminating zeros
+		*(uint16_t*)buf = 0;
+		*pos = 0xff;
+		return 2;
+	}
+	if (remByte > (maxMsgLen/2)) remByte = (maxMsgLen/2);								// shorten remaining bytes if necessary
 
-	uint8_t slcOffset = slc * maxMsgLen;												// calculate the starting offset
-	slcOffset /= 2;																		// divided by to because of mixed message, regs + eeprom content
+	uint8_t val[maxMsgLen/2];
+	const uint8_t *reg = devDef.cnlAddr + cnlTbl[xI].sIdx + *pos;
+	getEEPromBlock(cnlTbl[xI].pAddr + (cnlTbl[xI].sLen * idx) + *pos, remByte, val);	// the eeprom content in one go
+	*pos += remByte;
 
-	int8_t remByte = cnlTbl[xI].sLen - slcOffset;										// calculate the remaining bytes
-	if (remByte <= 0) {																	// check if we are in the last slice and add terminating zeros
-		*(uint16_t*)buf = 0;															// add them
-		//dbg << slc << " " << slcOffset << " " << cnlTbl[xI].sLen << '\n';
-		return 2;																		// nothing to do anymore
+	for (uint8_t i = 0; i < remByte; i++) {												// pairs of register address and content
+		*buf++ = _pgmB(reg[i]);
+		*buf++ = val[i];
 	}
-	if (remByte >= (maxMsgLen/2)) remByte = (maxMsgLen/2);								// shorten remaining bytes if necessary
+	return remByte*2;																	// return the byte length
+}
+uint8_t  EE::countRegListSeq(uint8_t cnl, uint8_t lst) {
+	// 0 if the list has to go as pairs: a run which starts at register 00 with content 00 reads like the terminating zeros
+	uint8_t xI = getRegListIdx(cnl, lst);
+	if (xI == 0xff) return 0;															// respective line not found
+	if ((cnlTbl[xI].sLen) && (!_pgmB(devDef.cnlAddr[cnlTbl[xI].sIdx]))) return 0;		// register 00, the lowest address comes first
 
-	uint8_t sIdx = cnlTbl[xI].sIdx;
-	uint16_t eIdx = cnlTbl[xI].pAddr + (cnlTbl[xI].sLen * idx);
-	//dbg << slc << ", sO:" << slcOffset << ", rB:" << remByte << ", sIdx:" << pHexB(sIdx) << ", eIdx:" << pHexB(eIdx) << '\n';
+	uint8_t bMax = 1, pos = 0;															// one for the terminating zeros
+	while (pos < cnlTbl[xI].sLen) {														// a slice per run of registers
+		pos += getRegRun(xI, pos);
+		bMax++;
+	}
+	return bMax;																		// return amount of slices
+}
+uint8_t  EE::getRegListSeq(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t *pos, uint8_t *buf) {
+	// like getRegListSlc, but a slice holds the address of the first register and the content of the following ones,
+	// as long as the addresses are ascending without gaps
+	uint8_t xI = getRegListIdx(cnl, lst);
+	if ((xI == 0xff) || (!checkIndex(cnl, lst, idx))) { *pos = 0xff; return 0; }		// line not found or peer index out of range
 
-	for (uint8_t i = 0; i < remByte; i++) {												// count through the remaining bytes
-		*buf++ = _pgmB(devDef.cnlAddr[i+sIdx+slcOffset]);								// add the register address
-		getEEPromBlock(i+eIdx+slcOffset, 1, buf++);										// add the eeprom content
-		//dbg << (i+eIdx+slcOffset) << '\n';
+	if (*pos >= cnlTbl[xI].sLen) {														// everything sent, add terminating zeros
+		*(uint16_t*)buf = 0;
+		*pos = 0xff;
+		return 2;
 	}
 
-	return remByte*2;																	// return the byte length
+	uint8_t run = getRegRun(xI, *pos);
+	*buf++ = _pgmB(devDef.cnlAddr[cnlTbl[xI].sIdx + *pos]);								// the offset is the first register address
+	getEEPromBlock(cnlTbl[xI].pAddr + (cnlTbl[xI].sLen * idx) + *pos, run, buf);		// and the content in one go
+	*pos += run;
+	return run+1;																		// return the byte length
 }
-
 /**
  * @brief Set individual registers of a list.
  *
@@ -540,12 +876,12 @@ uint8_t  EE::getRegListSlc(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t slc, u
  * In a simple example, the channel slice address definition for List0 is:
  * @include docs/snippets/register-h-cnlAddr.cpp docs/snippets/register-h-cnlTbl.cpp
  * @code
- * const uint8_t cnlAddr[] PROGMEM = {
+ * EE_CONST uint8_t cnlAddr[] PROGMEM = {
  *     0x02, 0x05, 0x0a, 0x0b, 0x0c, 0x14, 0x24, 0x25, 0x26, 0x27, // sIdx 0x00, 10 bytes for Channel0/List0
  *     0x01,                                                       // sIdx 0x0a,  1 byte  for Channel1/List4
  * }; // 11 byte
  *
- * EE::s_cnlTbl cnlTbl[] = {
+ * EE_CONST EE::s_cnlTbl cnlTbl[] = {
  *     // cnl, lst, sIdx, sLen, pAddr;
  *     {  0,  0, 0x00, 10,  0x000f }, // Channel0/List0, 10 bytes at sIdx 0x00, Addr 0x000f
  *     {  1,  4, 0x0a,  1,  0x0019 }, // Channel1/List4,  1 byte  at sIdx 0x0a, Addr 0x0019
@@ -573,26 +909,61 @@ uint8_t  EE::setListArray(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t len, ui
 	if ((cnl > 0) && (idx >=peerTbl[cnl-1].pMax)) return 0;								// check if peer index is in range
 
 	uint16_t eIdx = cnlTbl[xI].pAddr + (cnlTbl[xI].sLen * idx);
+	dropLstLru(cnl, lst, idx);															// ram copy is outdated
 
 	for (uint8_t i = 0; i < len; i+=2) {												// step through the input array
+		uint8_t j = getRegOffset(xI, buf[i]);											// search for the right address in cnlAddr
+		if (j == 0xff) continue;														// unknown register, go to the next i
 
-		for (uint8_t j = 0; j < cnlTbl[xI].sLen; j++) {									// search for the right address in cnlAddr
-			if (_pgmB(devDef.cnlAddr[cnlTbl[xI].sIdx + j]) == buf[i]) {					// if byte fits
-				setEEPromBlock(eIdx + j, 1, (void*)&buf[i+1]);									// add the eeprom content
-				//dbg << "eI:" << pHexB(eIdx + j) << ", " << pHexB(buf[i+1]) << '\n';
-				break;																	// go to the next i
-			}
-		}
-
+		setEEPromBlock(eIdx + j, 1, (void*)&buf[i+1]);									// add the eeprom content
+		//dbg << "eI:" << pHexB(eIdx + j) << ", " << pHexB(buf[i+1]) << '\n';
 	}
+	return 1;
+}
+void     EE::dropLstLru(uint8_t cnl, uint8_t lst, uint8_t idx) {
+	#if lstLruCnt
+	for (uint8_t i = 0; i < lstLruCnt; i++) {
+		s_lstLru *c = &lstLru[i];
+		if ((cnl == 0xff) || ((c->cnl == cnl) && (c->lst == lst) && ((idx == 0xff) || (c->idx == idx)))) c->cnl = 0;
+	}
+	#endif
 }
 uint8_t  EE::getRegListIdx(uint8_t cnl, uint8_t lst) {
+	// lists are mostly asked for several times in a row, e.g. by getRegListSlc or setListArray
+	if ((lstCache[2] != 0xff) && (lstCache[0] == cnl) && (lstCache[1] == lst)) return lstCache[2];
+
 	for (uint8_t i = 0; i < devDef.lstNbr; i++) {										// steps through the cnlTbl
 		// check if we are in the right line by comparing channel and list, otherwise try next
-		if ((cnlTbl[i].cnl == cnl) && (cnlTbl[i].lst == lst)) return i;
+		if ((cnlTbl[i].cnl == cnl) && (cnlTbl[i].lst == lst)) {
+			lstCache[0] = cnl;															// remember for the next call
+			lstCache[1] = lst;
+			lstCache[2] = i;
+			return i;
+		}
 	}
 	return 0xff;																		// respective line not found
 }
+uint8_t  EE::getRegOffset(uint8_t xI, uint8_t addr) {
+	// register addresses of a slice are ascending, which is checked in register.h by EE_CHECK_TABLES()
+	const uint8_t *slc = devDef.cnlAddr + cnlTbl[xI].sIdx;
+	uint8_t lo = 0, hi = cnlTbl[xI].sLen;
+
+	while (lo < hi) {																	// binary search within the slice
+		uint8_t mid = (lo + hi) >> 1;
+		uint8_t reg = _pgmB(slc[mid]);
+		if (reg == addr) return mid;													// found, return the byte offset
+		if (reg < addr) lo = mid + 1;
+		else hi = mid;
+	}
+	return 0xff;																		// address not found
+}
+uint8_t  EE::getRegRun(uint8_t xI, uint8_t pos) {
+	const uint8_t *slc = devDef.cnlAddr + cnlTbl[xI].sIdx;
+	uint8_t first = _pgmB(slc[pos]), n = 1;
+
+	while ((pos + n < cnlTbl[xI].sLen) && (n < maxMsgLen - 1) && (_pgmB(slc[pos + n]) == first + n)) n++;
+	return n;
+}
 uint8_t  EE::checkIndex(uint8_t cnl, uint8_t lst, uint8_t idx) {
 	//dbg << "cnl: " << cnl << " lst: " << lst << " idx: " << idx << '\n';
 	if ((cnl) && ((lst == 3) || (lst == 4)) && (idx >= peerTbl[cnl-1].pMax) ) return 0;
@@ -11,6 +11,22 @@
 
 #include "HAL.h"
 #define maxMsgLen 16																		// define max message length in byte
+#ifndef maxPeers
+	#define maxPeers 32																		// peer slots held in the ram peer index, 4 byte each
+#endif
+#ifndef maxPeerSlots
+	#ifdef EE_EXT
+		#define maxPeerSlots 254															// peer slots of a channel, AS::sendPeerMsg keeps a bit per slot
+	#else
+		#define maxPeerSlots 64
+	#endif
+#endif
+#ifndef lstLruCnt
+	#define lstLruCnt 2																		// list3/4 copies kept in ram for peer events, 0 turns the cache off
+#endif
+#ifndef lstLruLen
+	#define lstLruLen 64																	// bytes of a copy, longer lists are read from the eeprom every time
+#endif
 
 /**
  * @file EEprom.h
@@ -52,6 +68,10 @@ extern void firstTimeStart(void);															// only on first start of the de
  *   - the channel table @c EE::s_cnlTbl @c cnlTbl referring to the channel slice address definition
  *   - the peer device table @c EE::s_peerTbl @c peerTbl
  *
+ * The tables and the channel slice address definition are declared with @c EE_CONST in register.h,
+ * followed by @c EE_CHECK_TABLES(). With a C++11 compiler this checks the tables while the sketch
+ * compiles, see EE_CHECK_TABLES().
+ *
  * @todo Insert defDev example here.
  *
  * @paragraph section_eeprom_memory_layout EEprom memory layout
@@ -165,9 +185,41 @@ class EE {
 
   protected:	//---------------------------------------------------------------------------------------------------------
   private:		//---------------------------------------------------------------------------------------------------------
+	// ram copy of the peer database, slots are stored channel by channel in the order of peerTbl. the bloom filter is
+	// fed with the 3 byte peer id and rejects most of the foreign senders before the peer slots are searched.
+	// if the peer database has more than maxPeers slots, peerIdxCnt stays 0 and all peer functions work on the eeprom.
+	// up to 4 * maxPeers slots peerIdx holds one hash byte per slot instead, getIdxByPeer reads only the slots with a
+	// matching hash from the eeprom.
+	uint8_t  peerIdx[maxPeers][4];
+	uint8_t  peerBloom[8];
+	uint8_t  peerIdxCnt;
+	uint16_t peerHashCnt;																// slots with a hash byte, 0 if none or if the full index is on
+
+	uint8_t  lstCache[3];																// cnl, lst and cnlTbl line of the last getRegListIdx()
+
+	// list3/4 of the last peers which sent an event, a long key press repeats the same frame every 250ms and every frame
+	// loads the list into the module again. setList, setListArray and clearRegs drop the copies they write to.
+	#if lstLruCnt
+	struct s_lstLru {
+		uint8_t  cnl;																	// 0 for an unused entry, list3/4 never have channel 0
+		uint8_t  lst;
+		uint8_t  idx;																	// peer index
+		uint8_t  age;																	// 0 for the entry used last
+		uint8_t  val[lstLruLen];
+	} lstLru[lstLruCnt];
+	#endif
+	void     dropLstLru(uint8_t cnl, uint8_t lst, uint8_t idx);							// forget copies, 0xff in cnl for all, in idx for all peers
+
+	void     initPeerIdx(void);															// loads the peer database into ram
+	void     setPeerBloom(void);															// rebuilds the bloom filter out of peerIdx
+	uint8_t  checkPeerBloom(uint8_t *peer);												// 0 if the peer is for sure not in the database
+	uint8_t  *getPeerIdxSlot(uint8_t cnl, uint8_t idx);									// ram slot of the given channel and index
+	uint8_t  *getPeerHash(uint8_t cnl);													// hash byte of slot 0 of the channel or NULL
+	static uint8_t peerHash(uint8_t *peer);												// hash byte of a 4 byte peer, 0 for an empty slot
 
   public:		//---------------------------------------------------------------------------------------------------------
 	uint8_t  getList(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t *buf);				// get a complete list in to a given buffer
+	uint8_t  *getPeerList(uint8_t cnl, uint8_t lst, uint8_t idx);						// ram copy of a list3/4 out of the cache, NULL if not cached
 	uint8_t  setList(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t *buf);				// set a complete list to the eeprom
 	uint8_t  getRegAddr(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t addr);			// ok, gets a single register value
 	uint32_t getHMID(void);																// get HMID as 32 bit integer
@@ -193,15 +245,16 @@ class EE {
 	uint8_t  getPeerByIdx(uint8_t cnl, uint8_t idx, uint8_t *peer);						// ok, returns the respective peer of the given index
 	uint8_t  addPeer(uint8_t cnl, uint8_t *peer);										// ok, writes a peer in the database on first free slot
 	uint8_t  remPeer(uint8_t cnl, uint8_t *peer);										// ok, writes a zero to the respective slot
-	uint8_t  countPeerSlc(uint8_t cnl);													// ok, count the slices for function getPeerListSlc
-	uint8_t  getPeerListSlc(uint8_t cnl, uint8_t slc, uint8_t *buf);					// ok, returns the whole peer database as a string
+	uint8_t  getPeerListSlc(uint8_t cnl, uint8_t *pos, uint8_t *buf);					// next slice of the peer database, *pos is the cursor
 	uint8_t  getPeerSlots(uint8_t cnl);													// ok, returns max peers per channel
 
 	// register functions
 	void     clearRegs(void);															// ok, clears register space
 
 	uint8_t  countRegListSlc(uint8_t cnl, uint8_t lst);									// ok, counts the slices for a complete regs transmition
-	uint8_t  getRegListSlc(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t slc, uint8_t *buf);// ok, generates answer to a channel/list request
+	uint8_t  getRegListSlc(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t *pos, uint8_t *buf);// next slice of a channel/list request, *pos is the cursor
+	uint8_t  countRegListSeq(uint8_t cnl, uint8_t lst);									// slices of getRegListSeq, one per run of register addresses
+	uint8_t  getRegListSeq(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t *pos, uint8_t *buf);// same as getRegListSlc, but offset and data
 	uint8_t  setListArray(uint8_t cnl, uint8_t lst, uint8_t idx, uint8_t len, uint8_t *buf);// ok, set registers from a string
 
 	//uint8_t getListForMsg3(uint8_t cnl, uint8_t lst, uint8_t *peer, uint8_t *buf);
@@ -209,16 +262,24 @@ class EE {
 	//void    setListFromModule(uint8_t cnl, uint8_t peerIdx, uint8_t *data, uint8_t len);
 
 	uint8_t  getRegListIdx(uint8_t cnl, uint8_t lst);									// ok, returns the respective line of cnlTbl
+	uint8_t  getRegOffset(uint8_t xI, uint8_t addr);									// byte offset of a register within the list of cnlTbl line xI
+	uint8_t  getRegRun(uint8_t xI, uint8_t pos);										// registers with ascending addresses from byte pos on, one slice at most
 	uint8_t  checkIndex(uint8_t cnl, uint8_t lst, uint8_t idx);
 };
 
+struct s_lstStat {
+	uint32_t hits;																		// list3/4 taken from the ram copies of getPeerList
+	uint32_t misses;																	// ...or read from the eeprom into one of them
+};
+extern s_lstStat lstStat;
+
 /**
  * @brief Global device register channel table definition. Must be declared in user space.
  *
  *
  *
  */
-extern EE::s_cnlTbl cnlTbl[];															// initial register.h
+extern const EE::s_cnlTbl cnlTbl[];														// initial register.h
 
 /**
  * @brief Global peer table definition. Must be declared in user space.
@@ -226,7 +287,7 @@ extern EE::s_cnlTbl cnlTbl[];															// initial register.h
  *
  * @todo Insert description and example for peerTbl
  */
-extern EE::s_peerTbl peerTbl[];															// initial register.h
+extern const EE::s_peerTbl peerTbl[];													// initial register.h
 
 /**
  * @brief Global device definition. Must be declared in user space.
@@ -234,7 +295,78 @@ extern EE::s_peerTbl peerTbl[];															// initial register.h
  *
  * @todo Insert description and example for devDef
  */
-extern EE::s_devDef devDef;																// initial register.h
+extern const EE::s_devDef devDef;														// initial register.h
+
+/**
+ * @brief Qualifier of the register.h tables.
+ *
+ * cnlAddr, cnlTbl, peerTbl and devDef are declared as @c EE_CONST. With a C++11 compiler this is
+ * constexpr, which makes the tables visible to EE_CHECK_TABLES(), older compilers get a plain const.
+ */
+#if __cplusplus >= 201103L
+	#define EE_CONST constexpr
+#else
+	#define EE_CONST const
+#endif
+
+#if __cplusplus >= 201103L
+// eeprom regions of the device, region 0 is the header (magic byte, HMID, serial), followed by the lines of cnlTbl
+// and peerTbl. list3 and list4 are stored once per peer slot of the channel.
+constexpr uint16_t eeRgnAddr(const EE::s_cnlTbl *c, const EE::s_peerTbl *p, uint8_t l, uint8_t r) {
+	return (r == 0) ? 0 : (r <= l) ? c[r-1].pAddr : p[r-1-l].pAddr;
+}
+constexpr uint16_t eeRgnLen(const EE::s_cnlTbl *c, const EE::s_peerTbl *p, uint8_t l, uint8_t r) {
+	return (r == 0) ? 15 : (r > l) ? p[r-1-l].pMax * 4 :
+		((c[r-1].lst == 3) || (c[r-1].lst == 4)) ? c[r-1].sLen * p[c[r-1].cnl-1].pMax : c[r-1].sLen;
+}
+constexpr bool     eeRgnApart(const EE::s_cnlTbl *c, const EE::s_peerTbl *p, uint8_t l, uint8_t a, uint8_t b) {
+	return (!eeRgnLen(c, p, l, a)) || (!eeRgnLen(c, p, l, b)) ||
+		(eeRgnAddr(c, p, l, a) + eeRgnLen(c, p, l, a) <= eeRgnAddr(c, p, l, b)) ||
+		(eeRgnAddr(c, p, l, b) + eeRgnLen(c, p, l, b) <= eeRgnAddr(c, p, l, a));
+}
+constexpr bool     eeRgnApartAll(const EE::s_cnlTbl *c, const EE::s_peerTbl *p, uint8_t l, uint8_t n, uint8_t a, uint8_t b) {
+	return (b >= n) || (eeRgnApart(c, p, l, a, b) && eeRgnApartAll(c, p, l, n, a, b+1));
+}
+constexpr bool     eeRgnFree(const EE::s_cnlTbl *c, const EE::s_peerTbl *p, uint8_t l, uint8_t n, uint8_t r) {
+	return (r >= n) || (eeRgnApartAll(c, p, l, n, r, r+1) && eeRgnFree(c, p, l, n, r+1));
+}
+constexpr bool     eeRgnFit(const EE::s_cnlTbl *c, const EE::s_peerTbl *p, uint8_t l, uint8_t n, uint8_t r) {
+	return (r >= n) || ((eeRgnAddr(c, p, l, r) + (uint32_t)eeRgnLen(c, p, l, r) <= eeEnd + 1UL) && eeRgnFit(c, p, l, n, r+1));
+}
+// register addresses of a slice are strictly ascending, getRegOffset() relies on it
+constexpr bool     eeSlcAsc(const uint8_t *a, uint8_t i, uint8_t n) {
+	return (i >= n) || ((a[i-1] < a[i]) && eeSlcAsc(a, i+1, n));
+}
+constexpr bool     eeSlcSorted(const uint8_t *a, const EE::s_cnlTbl *c, uint8_t l, uint8_t r) {
+	return (r >= l) || (eeSlcAsc(a + c[r].sIdx, 1, c[r].sLen) && eeSlcSorted(a, c, l, r+1));
+}
+// peerTbl is indexed by cnl-1
+constexpr bool     eePeerOrder(const EE::s_peerTbl *p, uint8_t n, uint8_t i) {
+	return (i >= n) || ((p[i].cnl == i+1) && eePeerOrder(p, n, i+1));
+}
+constexpr bool     eePeerFit(const EE::s_peerTbl *p, uint8_t n, uint8_t i) {
+	return (i >= n) || ((p[i].pMax <= maxPeerSlots) && eePeerFit(p, n, i+1));
+}
+
+/**
+ * @brief Checks the register.h tables at compile time.
+ *
+ * Place it in register.h after devDef. Compilation stops if the line counts of cnlTbl and peerTbl
+ * don't match devDef, peerTbl is not in channel order, the register addresses of a slice in cnlAddr
+ * are not ascending, a channel has more than maxPeerSlots peers, or the eeprom regions of the header,
+ * the lists and the peer database overlap or exceed the eeprom (eeEnd).
+ */
+#define EE_CHECK_TABLES() \
+	static_assert(sizeof(cnlTbl) / sizeof(cnlTbl[0]) == devDef.lstNbr, "cnlTbl needs devDef.lstNbr lines"); \
+	static_assert(sizeof(peerTbl) / sizeof(peerTbl[0]) == devDef.cnlNbr, "peerTbl needs devDef.cnlNbr lines"); \
+	static_assert(eePeerOrder(peerTbl, devDef.cnlNbr, 0), "peerTbl lines have to be in channel order"); \
+	static_assert(eePeerFit(peerTbl, devDef.cnlNbr, 0), "peerTbl channel with more than maxPeerSlots peers"); \
+	static_assert(eeSlcSorted(devDef.cnlAddr, cnlTbl, devDef.lstNbr, 0), "cnlAddr slices have to be ascending"); \
+	static_assert(eeRgnFree(cnlTbl, peerTbl, devDef.lstNbr, devDef.lstNbr + devDef.cnlNbr + 1, 0), "eeprom regions overlap"); \
+	static_assert(eeRgnFit(cnlTbl, peerTbl, devDef.lstNbr, devDef.lstNbr + devDef.cnlNbr + 1, 0), "eeprom regions exceed eeEnd")
+#else
+	#define EE_CHECK_TABLES()
+#endif
 
 /**
  * @brief Global definition of master HM-ID (paired central).
@@ -1,4 +1,5 @@
 #include "HAL.h"
+#if defined(__AVR__)
 
 //- some macros for debugging ---------------------------------------------------------------------------------------------
 
@@ -12,6 +13,13 @@ void dbgStart(void) {
 		_delay_ms(500);
 	}
 }
+uint8_t dbgRoom(void) {
+	int n = dbg.availableForWrite();											// free space in the tx buffer of the serial port
+	return (n > 255) ? 255 : n;
+}
+void    dbgWrite(uint8_t *buf, uint8_t len) {
+	dbg.write(buf, len);
+}
 //- -----------------------------------------------------------------------------------------------------------------------
 
 
@@ -43,6 +51,14 @@ void    startWDG8000ms(void) {
 	WDTCSR = (1<<WDIE) | (1<<WDP3) | (1<<WDP0);
 	wdtSleep_TIME = 8192;
 }
+void    startWDGms(uint32_t ms) {
+	uint8_t wdp = 0;															// 16ms * 2^wdp, up to 8s
+	while ((wdp < 9) && ((16UL << (wdp+1)) <= ms)) wdp++;
+
+	WDTCSR |= (1<<WDCE) | (1<<WDE);
+	WDTCSR = (1<<WDIE) | ((wdp & 8) ? (1<<WDP3) : 0) | (wdp & 7);
+	wdtSleep_TIME = 16 << wdp;
+}
 void    setSleep(void) {
 	//dbg << ',';																// some debug
 	//_delay_ms(10);															// delay is necessary to get it printed on the console before device sleeps
@@ -83,6 +99,7 @@ ISR(WDT_vect) {
 
 //- timer functions -------------------------------------------------------------------------------------------------------
 static volatile tMillis milliseconds;
+static void (*msTick)(void);													// hook of the 1ms interrupt, see setMsTick
 void    initMillis() {
 	SET_TCCRA();
 	SET_TCCRB();
@@ -101,28 +118,104 @@ void    addMillis(tMillis ms) {
 		milliseconds += ms;
 	}
 }
+void    setMsTick(void (*tick)(void)) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		msTick = tick;
+	}
+}
 ISR(ISR_VECT) {
 	++milliseconds;
+	if (msTick) msTick();
 }
 //- -----------------------------------------------------------------------------------------------------------------------
 
 
 //- eeprom functions ------------------------------------------------------------------------------------------------------
-void    initEEProm(void) {
-	// place the code to init a i2c eeprom
+#ifdef EE_EXT
+// 24Cxx on the twi, polled. while the part writes a page it doesn't acknowledge its address, readEEProm waits up to
+// eeExtTimeout for it and writeEEProm returns 0 like the internal eeprom does while busy. a missing part or a stuck bus
+// ends in a timeout, the twi is reset and the caller gets 0
+static uint8_t twiCmd(uint8_t cmd) {
+	TWCR = cmd | _BV(TWINT) | _BV(TWEN);
+	for (uint8_t i = 0; !(TWCR & _BV(TWINT)); i++) {										// a byte on the bus takes 22us at 400kHz
+		if (i == 200) { TWCR = 0; TWCR = _BV(TWEN); return 0; }								// nothing after 1ms, release the bus
+		_delay_us(5);
+	}
+	return TWSR & 0xf8;																		// status without the prescaler bits
 }
-void    getEEPromBlock(uint16_t addr,uint8_t len,void *ptr) {
-	eeprom_read_block((void*)ptr,(const void*)addr,len);									// AVR GCC standard function
+static void    twiStop(void) {
+	TWCR = _BV(TWINT) | _BV(TWSTO) | _BV(TWEN);
+	for (uint8_t i = 0; (TWCR & _BV(TWSTO)) && (i < 200); i++) _delay_us(5);
 }
-void    setEEPromBlock(uint16_t addr,uint8_t len,void *ptr) {
-	eeprom_write_block((const void*)ptr,(void*)addr,len);									// AVR GCC standard function
+static uint8_t twiSend(uint8_t val) {
+	TWDR = val;
+	return twiCmd(0);
+}
+static uint8_t eeExtSelect(uint16_t addr) {
+	uint8_t st = twiCmd(_BV(TWSTA));
+	if ((st != 0x08) && (st != 0x10)) { twiStop(); return 0; }								// no start condition, bus error
+	if (twiSend(eeExtAddr << 1) != 0x18) { twiStop(); return 0; }							// part is busy, no ack on the address
+	if ((twiSend(addr >> 8) != 0x28) || (twiSend(addr & 0xff) != 0x28)) { twiStop(); return 0; }
+	return 1;
+}
+void    initEEProm(void) {
+	TWSR = 0;																				// prescaler 1
+	TWBR = ((F_CPU / eeExtClock) - 16) / 2;
+	TWCR = _BV(TWEN);
 }
-void    clearEEPromBlock(uint16_t addr, uint16_t len) {
-	uint8_t tB=0;
-	for (uint16_t l = 0; l < len; l++) {													// step through the bytes of eeprom
-		setEEPromBlock(addr+l,1,(void*)&tB);
+uint8_t readEEProm(uint16_t addr, uint8_t len, void *ptr) {
+	for (uint16_t i = 0; !eeExtSelect(addr); i++) {											// acknowledge polling, waits for a running page write
+		if (i == eeExtTimeout * 10) { memset(ptr, 0xff, len); return 0; }					// part doesn't answer, reads like an erased one
+		_delay_us(100);
 	}
+	twiCmd(_BV(TWSTA));																		// repeated start
+	twiSend((eeExtAddr << 1) | 1);															// and read sequential
+	for (uint8_t i = 0; i < len; i++) {
+		twiCmd((i < len - 1) ? _BV(TWEA) : 0);												// no ack on the last byte
+		((uint8_t*)ptr)[i] = TWDR;
+	}
+	twiStop();
+	return 1;
+}
+uint8_t writeEEProm(uint16_t addr, uint8_t len, void *ptr) {
+	// the part takes the bytes up to the end of the page, more would wrap around to the start of the page
+	uint8_t n = eeExtPage - (addr & (eeExtPage - 1));
+	if (n > len) n = len;
+
+	if (!eeExtSelect(addr)) return 0;														// last page is still in progress
+	for (uint8_t i = 0; i < n; i++) twiSend(((uint8_t*)ptr)[i]);
+	twiStop();																				// starts the page write
+	return n;
+}
+#else
+void    initEEProm(void) {
+}
+uint8_t readEEProm(uint16_t addr, uint8_t len, void *ptr) {
+	eeprom_read_block((void*)ptr,(const void*)addr,len);									// AVR GCC standard function, waits for eeprom ready
+	return 1;
+}
+uint8_t writeEEProm(uint16_t addr, uint8_t len, void *ptr) {
+	// the internal eeprom is written byte by byte, every byte takes 3.3ms. eeprom_write_byte only waits for the byte before,
+	// so we hand over one byte while the eeprom is ready and the cpu is free again right away
+	if (!eeprom_is_ready()) return 0;														// last byte is still in progress
+	eeprom_write_byte((uint8_t*)addr, *(uint8_t*)ptr);
+	return 1;
 }
+#endif
+//- -----------------------------------------------------------------------------------------------------------------------
+
+
+//- rf capture functions --------------------------------------------------------------------------------------------------
+#ifdef RF_CAP
+uint8_t capActive(void) {
+	return 1;																				// serial port is always there
+}
+void    capFrame(uint8_t flags, tMillis time, uint8_t rssi, uint8_t lqi, uint8_t *buf) {
+	uint8_t hdr[] = { CAP_SYNC, (uint8_t)time, (uint8_t)(time >> 8), (uint8_t)(time >> 16), (uint8_t)(time >> 24), flags, rssi, lqi };
+	dbg.write(hdr, sizeof(hdr));
+	dbg.write(buf, buf[0]+1);
+}
+#endif
 //- -----------------------------------------------------------------------------------------------------------------------
 
 
@@ -167,3 +260,5 @@ uint16_t getAdcValue(uint8_t adcmux) {
 	return adcValue;															// return the measured value
 }
 //- -----------------------------------------------------------------------------------------------------------------------
+
+#endif
@@ -8,27 +8,31 @@
 #ifndef _HAL_H
 	#define _HAL_H
 
-	#if defined(ARDUINO) && ARDUINO >= 100
-		#include "Arduino.h"
-	#else
-		#include "WProgram.h"
+	#if defined(__AVR__)
+		#if defined(ARDUINO) && ARDUINO >= 100
+			#include "Arduino.h"
+		#else
+			#include "WProgram.h"
+		#endif
+
+		#include <avr/sleep.h>
+		#include <avr/power.h>
+		#include <avr/wdt.h>
+		#include <util/delay.h>
+		#include <util/atomic.h>
+		#include <avr/eeprom.h>
+
+		#include "Print.h"
 	#endif
 
-	#include <avr/sleep.h>
-	#include <avr/power.h>
-	#include <avr/wdt.h>
-	#include <util/delay.h>
-	#include <util/atomic.h>
-	#include <avr/eeprom.h>
-
-	#include "Print.h"
-
 
 	//- MCU dependent HAL definitions -----------------------------------------------------------------------------------------
 	#if defined(__AVR_ATmega328P__)
 		#include "HAL_atmega328P.h"
 	#elif defined(__AVR_ATmega32U4__)
 		#include "HAL_atmega32U4.h"
+	#elif defined(__linux__)
+		#include "HAL_linux.h"
 	#else
 		#error "No HAL definition for current MCU available!"
 	#endif
@@ -70,6 +74,7 @@
 	extern void    initMillis(void);
 	extern tMillis getMillis(void);
 	extern void    addMillis(tMillis ms);
+	extern void    setMsTick(void (*tick)(void));								// called out of the 1ms timer interrupt, keep it short
 	//- -----------------------------------------------------------------------------------------------------------------------
 
 	//- some macros for debugging ---------------------------------------------------------------------------------------------
@@ -97,6 +102,8 @@
 	inline Print &operator <<(Print &obj, _eTIME arg) { obj.print('('); obj.print(getMillis()); obj.print(')'); return obj; }
 
 	extern void    dbgStart(void);
+	extern uint8_t dbgRoom(void);												// bytes the serial port takes without waiting
+	extern void    dbgWrite(uint8_t *buf, uint8_t len);							// write bytes, see Trace.h
 	//- -----------------------------------------------------------------------------------------------------------------------
 
 
@@ -125,10 +132,13 @@
 	//- cc1100 hardware functions ---------------------------------------------------------------------------------------------
 	extern void    ccInitHw(void);
 	extern uint8_t ccSendByte(uint8_t data);
-	extern uint8_t ccGetGDO0(void);
+	extern uint8_t ccGetGDO0(void);												// end of packet which was not handled by the callback
+	extern void    ccSetGDO0(void);												// end of packet found by polling, reported by ccGetGDO0
 
 	extern void    enableGDO0Int(void);
 	extern void    disableGDO0Int(void);
+	extern void    ccGDO0Callback(void (*cb)(void));							// called from the GDO0 interrupt on end of packet
+	extern void    ccSetBusy(uint8_t busy);										// main loop runs a sequence on the cc1101, GDO0 waits meanwhile
 
 	extern void    waitMiso(void);
 	extern void    ccSelect(void);
@@ -136,11 +146,71 @@
 	//- -----------------------------------------------------------------------------------------------------------------------
 
 
+	//- rf capture functions --------------------------------------------------------------------------------------------------
+	// with RF_CAP every frame on air is streamed as binary record, received ones from RV::pop, sent ones from SN::sndFrame
+	//   CAP_SYNC, time in ms (4 byte, lsb first), flags, rssi, lqi (bit 7 crc ok), length byte and the encoded frame
+	// avr streams to the serial port, the linux host into a file. examples/HOST_Linux replays a capture into the stack
+	//#define RF_CAP
+	#define CAP_SYNC        0xA5												// start of a record
+	#define CAP_TX          0x01												// flags, frame was sent
+	#define CAP_BURST       0x02												// ...with burst preamble
+
+	extern uint8_t capActive(void);												// 1 if the records go somewhere
+	extern void    capFrame(uint8_t flags, tMillis time, uint8_t rssi, uint8_t lqi, uint8_t *buf);
+	//- -----------------------------------------------------------------------------------------------------------------------
+
+
 	//- eeprom functions ------------------------------------------------------------------------------------------------------
+	// get/set/clear work on a write buffer in EEprom.cpp, unchanged bytes are skipped and changed bytes are written in the
+	// background by flushEEProm. the HAL only provides the raw access
+	// EE_EXT takes a 24Cxx on the i2c bus instead of the internal eeprom, for devices with a lot of peers. only parts with
+	// 2 byte addresses are supported (24C32 and bigger), a write takes up to a page and the part is busy for some ms after
+	//#define EE_EXT
+	#ifdef EE_EXT
+		#ifndef eeExtSize
+			#define eeExtSize   0x8000											// bytes of the part, 24C256
+		#endif
+		#ifndef eeExtPage
+			#define eeExtPage   64												// bytes of a page, power of 2
+		#endif
+		#ifndef eeExtAddr
+			#define eeExtAddr   0x50											// i2c address, A0 to A2 low
+		#endif
+		#ifndef eeExtClock
+			#define eeExtClock  400000L											// i2c clock in Hz
+		#endif
+		#ifndef eeExtTimeout
+			#define eeExtTimeout 10												// ms of acknowledge polling, a page write takes 5ms at most
+		#endif
+		#define eeEnd           (eeExtSize - 1)									// last eeprom address
+	#else
+		#define eeEnd           E2END
+	#endif
+
 	extern void    initEEProm(void);
 	extern void    getEEPromBlock(uint16_t addr,uint8_t len,void *ptr);
 	extern void    setEEPromBlock(uint16_t addr,uint8_t len,void *ptr);
 	extern void    clearEEPromBlock(uint16_t addr, uint16_t len);
+	extern uint8_t flushEEProm(uint8_t wait);									// write buffered bytes, wait for all or only start the next one
+
+	extern uint8_t readEEProm(uint16_t addr, uint8_t len, void *ptr);			// raw read, waits for a running write, 0 if the part fails
+	extern uint8_t writeEEProm(uint16_t addr, uint8_t len, void *ptr);			// start a write, returns the bytes taken, 0 while busy
+
+	struct s_eeWrStat {
+		uint16_t setBytes;														// bytes handed over to setEEPromBlock or clearEEPromBlock
+		uint16_t skipBytes;														// ...which had the same content already
+		uint16_t wrBytes;														// bytes written into the eeprom
+		uint8_t  bufMax;														// highest fill level of the write buffer
+		uint16_t errors;														// bytes dropped, the eeprom didn't take them in time
+	};
+	extern s_eeWrStat eeWrStat;
+
+	struct s_eeRdStat {
+		uint32_t reads;															// cache lines asked for by getEEPromBlock and the write buffer
+		uint32_t misses;														// ...which had to be read from the eeprom
+		uint16_t errors;														// ...and failed, the part didn't answer
+	};
+	extern s_eeRdStat eeRdStat;
 	//- -----------------------------------------------------------------------------------------------------------------------
 
 
@@ -148,6 +218,7 @@
 	extern void    startWDG32ms(void);
 	extern void    startWDG250ms(void);
 	extern void    startWDG8000ms(void);
+	extern void    startWDGms(uint32_t ms);										// longest watchdog period which fits into ms, 16ms at least
 	extern void    setSleep(void);
 
 	extern void    startWDG();
@@ -15,12 +15,25 @@ uint8_t ccSendByte(uint8_t data) {
 	while (!(SPSR & _BV(SPIF))); 												// wait until transfer finished
 	return SPDR;
 }
+static void (*gdo0Cb)(void);													// end of packet handler, runs within the interrupt
+static volatile uint8_t gdo0Pend;												// end of packet, not handled by the callback
+static volatile uint8_t ccBusy;													// main loop owns the cc1101, see ccSetBusy
 uint8_t ccGetGDO0() {
-	uint8_t x = chkPCINT(CC_GDO0_PCIE, CC_GDO0_INT, 0);							// check PCINT without debouncing
-	//if (x>1) dbg << "x:" << x << '\n';
-
-	if (x == 2 ) return 1;														// falling edge detected
-	else return 0;
+	uint8_t x;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		x = gdo0Pend;
+		gdo0Pend = 0;
+	}
+	return x;
+}
+void    ccSetGDO0(void) {
+	gdo0Pend = 1;
+}
+void    ccGDO0Callback(void (*cb)(void)) {
+	gdo0Cb = cb;
+}
+void    ccSetBusy(uint8_t busy) {
+	ccBusy = busy;
 }
 
 void    enableGDO0Int(void) {
@@ -134,19 +147,35 @@ void    initConfKey(void) {
 }
 
 //- -----------------------------------------------------------------------------------------------------------------------
+static void chkGDO0(uint8_t port, uint8_t prev) {
+	// called by the pin change interrupts after the new pin state is stored, a falling edge on GDO0 is the end of packet.
+	// while the main loop runs a sequence of strobes the callback must not restart the receiver in between, and while the
+	// spi bus is in use it can't read the fifo. the edge is kept for ccGetGDO0 then
+	if ((port != CC_GDO0_PCIE) || !(CC_GDO0_PCMSK & _BV(CC_GDO0_INT))) return;	// not the GDO0 port or interrupt disabled
+	if (!(prev & _BV(CC_GDO0_INT)) || (pcInt[port].cur & _BV(CC_GDO0_INT))) return;	// no falling edge
+
+	if ((gdo0Cb) && (!ccBusy) && (CC_CS_PORT & _BV(CC_CS_PIN))) gdo0Cb();		// cc1101 is not in use, spi is free
+	else gdo0Pend = 1;
+}
 ISR (PCINT0_vect) {
+	uint8_t prev = pcInt[0].cur;
 	pcInt[0].cur = PINB;
 	pcInt[0].time = getMillis();
+	chkGDO0(0, prev);
 	//dbg << "i1:" << PINB  << "\n";
 }
 ISR (PCINT1_vect) {
+	uint8_t prev = pcInt[1].cur;
 	pcInt[1].cur = PINC;
 	pcInt[1].time = getMillis();
+	chkGDO0(1, prev);
 	//dbg << "i2:" << PINC << "\n";
 }
 ISR (PCINT2_vect) {
+	uint8_t prev = pcInt[2].cur;
 	pcInt[2].cur = PIND;
 	pcInt[2].time = getMillis();
+	chkGDO0(2, prev);
 	//dbg << "i3:" << PIND  << "\n";
 }
 //- -----------------------------------------------------------------------------------------------------------------------
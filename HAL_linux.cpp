@@ -0,0 +1,610 @@
+//- -----------------------------------------------------------------------------------------------------------------------
+// AskSin driver implementation
+// 2013-08-03 <trilu@gmx.de> Creative Commons - http://creativecommons.org/licenses/by-nc-sa/3.0/de/
+//- -----------------------------------------------------------------------------------------------------------------------
+//- Hardware abstraction layer for a linux host ---------------------------------------------------------------------------
+//- -----------------------------------------------------------------------------------------------------------------------
+
+#include "HAL.h"
+#if defined(__linux__) && !defined(__AVR__)
+#include "CC1101.h"
+
+HardwareSerial Serial;
+s_hostStat hostStat;
+
+//- some macros for debugging ---------------------------------------------------------------------------------------------
+void dbgStart(void) {
+	dbg.begin(57600);																		// nothing to setup, stdout is always there
+}
+//- -----------------------------------------------------------------------------------------------------------------------
+
+
+//- timer functions -------------------------------------------------------------------------------------------------------
+// the clock is virtual, it only moves forward by _delay_ms/_delay_us, sleep or addMillis. like that every run of the
+// stack is deterministic and the host driver decides how much time passes between two loop iterations
+static uint64_t hostClock;																	// virtual time in us
+static void    (*msTick)(void);																// see setMsTick
+static void    hostRadioService(void);
+static void    hostPowerAdd(uint64_t us);
+static void    hostPowerMove(uint64_t us);
+
+static void    hostAdvance(uint64_t us) {
+	// the timer interrupt fires on every ms boundary the clock passes, also while we wait in a delay
+	uint64_t ms = hostClock / 1000;
+	hostPowerAdd(us);
+	hostClock += us;
+	if (!msTick) return;
+	while (ms++ < hostClock / 1000) msTick();
+}
+void    hostDelayUs(uint32_t us) {
+	hostAdvance(us);
+	hostRadioService();																		// frames could end while we wait, like the interrupt would do
+}
+uint32_t hostMicros(void) {
+	return (uint32_t)hostClock;
+}
+void    initMillis() {
+}
+tMillis getMillis() {
+	return (tMillis)(hostClock / 1000);
+}
+void    addMillis(tMillis ms) {
+	hostAdvance((uint64_t)ms * 1000);
+	hostRadioService();
+}
+void    setMsTick(void (*tick)(void)) {
+	msTick = tick;
+}
+//- -----------------------------------------------------------------------------------------------------------------------
+
+
+//- serial port -----------------------------------------------------------------------------------------------------------
+// the trace goes through a model of the arduino serial port, 64 byte tx buffer which is sent out with 57600 baud. the
+// text of dbg << is not slowed down
+#define HOST_UART_BUF       64
+#define HOST_UART_US        174																// 10 bit per byte
+static uint64_t uartEnd;																	// time the tx buffer runs empty
+
+uint8_t dbgRoom(void) {
+	if (uartEnd <= hostClock) return HOST_UART_BUF;
+	uint32_t busy = (uartEnd - hostClock + HOST_UART_US - 1) / HOST_UART_US;				// bytes still in the buffer
+	return (busy >= HOST_UART_BUF) ? 0 : HOST_UART_BUF - busy;
+}
+void    dbgWrite(uint8_t *buf, uint8_t len) {
+	if (uartEnd < hostClock) uartEnd = hostClock;
+	uartEnd += (uint64_t)len * HOST_UART_US;
+	hostStat.uartBytes += len;
+	if (Serial.out) fwrite(buf, 1, len, Serial.out);
+}
+//- -----------------------------------------------------------------------------------------------------------------------
+
+
+//- power management functions --------------------------------------------------------------------------------------------
+static uint8_t  wdtActive;
+static uint8_t  mcuState;																	// 0 running, 1 power down with watchdog, 2 power down
+static uint8_t  mcuWake;																	// an interrupt ended the sleep
+static uint64_t sleepLimit;																	// see hostSleepLimit
+
+void    startWDG32ms(void) {
+	wdtActive = 1;
+	wdtSleep_TIME = 32;
+}
+void    startWDG250ms(void) {
+	wdtActive = 1;
+	wdtSleep_TIME = 256;
+}
+void    startWDG8000ms(void) {
+	wdtActive = 1;
+	wdtSleep_TIME = 8192;
+}
+void    startWDGms(uint32_t ms) {
+	uint8_t wdp = 0;																		// same steps as the avr watchdog
+	while ((wdp < 9) && ((16UL << (wdp+1)) <= ms)) wdp++;
+
+	wdtActive = 1;
+	wdtSleep_TIME = 16 << wdp;
+}
+void    setSleep(void) {
+	// the watchdog or the GDO0 interrupt end the sleep. without watchdog we sleep until GDO0 or until the host driver wants
+	// the control back, without a limit that is right now
+	uint64_t start = hostClock;
+	uint64_t end = (wdtActive) ? hostClock + (uint64_t)wdtSleep_TIME * 1000 : sleepLimit;
+
+	mcuState = (wdtActive) ? 1 : 2;
+	mcuWake = 0;
+	while ((hostClock < end) && (!mcuWake)) hostDelayUs((end - hostClock > 1000) ? 1000 : end - hostClock);
+	mcuState = 0;
+	hostStat.sleepMs += (hostClock - start) / 1000;
+}
+void    hostSleepLimit(uint32_t ms) {
+	sleepLimit = (uint64_t)ms * 1000;
+}
+
+void    startWDG() {
+	wdtActive = 1;
+}
+void    stopWDG() {
+	wdtActive = 0;
+}
+void    setSleepMode() {
+}
+//- -----------------------------------------------------------------------------------------------------------------------
+
+
+//- eeprom functions ------------------------------------------------------------------------------------------------------
+#define HOST_EE_WR_US       3400																// atmega328p, 3.4ms per written byte
+#define HOST_EE_PAGE_US     5000																// 24Cxx, 5ms per page write
+
+static uint8_t eeImage[eeEnd + 1];															// ram copy of the eeprom
+static FILE    *eeFile;																		// image file, NULL for ram only
+static uint64_t eeBusy;																		// end of the running write
+
+void    hostEEPromFile(const char *path) {
+	if (eeFile) fclose(eeFile);
+	eeFile = fopen(path, "r+b");															// try to open an existing image
+	if (!eeFile) eeFile = fopen(path, "w+b");												// otherwise create a new one
+}
+void    initEEProm(void) {
+	memset(eeImage, 0xff, sizeof(eeImage));													// erased eeprom reads 0xff
+	if (!eeFile) return;																	// ram only
+
+	fseek(eeFile, 0, SEEK_SET);
+	size_t len = fread(eeImage, 1, sizeof(eeImage), eeFile);								// load what we have
+	if (len < sizeof(eeImage)) {															// new or short file, fill up to full size
+		fseek(eeFile, 0, SEEK_SET);
+		fwrite(eeImage, 1, sizeof(eeImage), eeFile);
+		fflush(eeFile);
+	}
+}
+#ifdef EE_EXT
+// 24Cxx model, the bytes on the i2c bus cost 9 clocks each on the virtual clock. a busy part doesn't acknowledge its
+// address, the read polls until the page write is done
+static void    eeI2c(uint16_t bytes) {
+	hostStat.i2cBytes += bytes;
+	hostDelayUs((bytes * 9 * 1000000UL + eeExtClock - 1) / eeExtClock);
+}
+uint8_t readEEProm(uint16_t addr, uint8_t len, void *ptr) {
+	if (addr + len > sizeof(eeImage)) { memset(ptr, 0xff, len); return 0; }				// out of range, like a part which doesn't answer
+	while (hostClock < eeBusy) eeI2c(1);													// acknowledge polling
+	eeI2c(4 + len);																			// address, 2 byte eeprom address, address again and data
+	memcpy(ptr, &eeImage[addr], len);
+	hostStat.eeRdCalls++;
+	hostStat.eeRdBytes += len;
+	return 1;
+}
+uint8_t writeEEProm(uint16_t addr, uint8_t len, void *ptr) {
+	if (addr >= sizeof(eeImage)) return len;												// out of range, nothing to wait for
+	eeI2c(1);																				// address of the part
+	if (hostClock < eeBusy) return 0;														// no acknowledge, last page is still in progress
+
+	uint8_t n = eeExtPage - (addr & (eeExtPage - 1));										// the part takes the bytes up to the end of the page
+	if (n > len) n = len;
+	eeI2c(2 + n);
+	memcpy(&eeImage[addr], ptr, n);
+	eeBusy = hostClock + HOST_EE_PAGE_US;
+	hostStat.eeWrBytes += n;
+	hostStat.eeWrCycles++;
+
+	if (!eeFile) return n;																	// write through to the image file
+	fseek(eeFile, addr, SEEK_SET);
+	fwrite(ptr, 1, n, eeFile);
+	fflush(eeFile);
+	return n;
+}
+#else
+uint8_t readEEProm(uint16_t addr, uint8_t len, void *ptr) {
+	if (addr + len > sizeof(eeImage)) { memset(ptr, 0xff, len); return 0; }				// out of range, like a part which doesn't answer
+	if (hostClock < eeBusy) hostDelayUs(eeBusy - hostClock);								// like eeprom_read_block, wait for the running write
+	memcpy(ptr, &eeImage[addr], len);
+	hostStat.eeRdCalls++;
+	hostStat.eeRdBytes += len;
+	return 1;
+}
+uint8_t writeEEProm(uint16_t addr, uint8_t len, void *ptr) {
+	// same behaviour as the internal eeprom of the 328p, one byte per call which keeps the eeprom busy for 3.4ms
+	if (addr >= sizeof(eeImage)) return 1;													// out of range, nothing to wait for
+	if (hostClock < eeBusy) return 0;														// last byte is still in progress
+	eeImage[addr] = *(uint8_t*)ptr;
+	eeBusy = hostClock + HOST_EE_WR_US;
+	hostStat.eeWrBytes++;
+	hostStat.eeWrCycles++;
+
+	if (!eeFile) return 1;																	// write through to the image file
+	fseek(eeFile, addr, SEEK_SET);
+	fwrite(ptr, 1, 1, eeFile);
+	fflush(eeFile);
+	return 1;
+}
+#endif
+//- -----------------------------------------------------------------------------------------------------------------------
+
+
+//- battery measurement functions -----------------------------------------------------------------------------------------
+uint16_t getAdcValue(uint8_t adcmux) {
+	return 0;
+}
+uint8_t  getBatteryVoltage(void) {
+	return 30;																				// 3.0V, battery is always fine
+}
+//- -----------------------------------------------------------------------------------------------------------------------
+
+
+//- status led related functions ------------------------------------------------------------------------------------------
+void    initLeds(void) {
+}
+void    ledRed(uint8_t stat) {
+}
+void    ledGrn(uint8_t stat) {
+}
+//- -----------------------------------------------------------------------------------------------------------------------
+
+
+//- pin related functions -------------------------------------------------------------------------------------------------
+void    initPCINT(void) {
+}
+uint8_t chkPCINT(uint8_t port, uint8_t pin, uint8_t debounce) {
+	return 1;																				// pull up active, no edge
+}
+void    initConfKey(void) {
+}
+//- -----------------------------------------------------------------------------------------------------------------------
+
+
+//- cc1100 hardware functions ---------------------------------------------------------------------------------------------
+// register and fifo model of the cc1101, good enough for the access pattern of the CC class. queued frames are on air one
+// after the other, at the end of its air time a frame is moved into the rx fifo if the chip is in RX mode and the fifo is
+// empty, otherwise it is lost. the end of packet raises GDO0, the callback runs like an interrupt as long as the spi bus is
+// free and the main loop doesn't run a sequence on the chip. sent frames occupy the channel for their air time.
+// in wake on radio mode the chip sleeps and goes into RX for a short time every tEVENT0, a poll which falls into the
+// preamble of a frame keeps it in RX until the end of packet. a frame with burst has 360ms of preamble in front
+#define HOST_RX_QUEUE       16																// frames which could be queued for reception
+#define HOST_FIFO_SIZE      64																// fifo size of the cc1101
+#define HOST_BYTE_US        800																// 10kBaud, 800us per byte on air
+#define HOST_BURST_US       360000															// burst preamble, see CC::startTx
+#define HOST_CS_US          1000															// calibration and rssi after SRX until carrier sense is valid
+
+struct s_hostFrame {
+	uint8_t buf[HOST_FIFO_SIZE];															// length byte and encoded frame
+	uint8_t rssi;																			// raw rssi register value
+	uint8_t lqi;																			// lqi, crc ok flag is added by the model
+	uint64_t start;																			// start of air time, burst preamble included
+	uint64_t end;																			// end of air time
+};
+
+static struct s_hostRadio {
+	uint8_t  reg[0x30];																		// config register
+	uint8_t  marc;																			// MARCSTATE
+	uint64_t rxStart;																		// last SRX, see HOST_CS_US
+
+	uint8_t  wor;																			// wake on radio is running, marc is SLEEP meanwhile
+	uint64_t worStart;																		// SWOR, the first poll is one period later
+	uint64_t worPeriod;																		// tEVENT0 in us
+	uint64_t worRx;																			// start of RX within the period, EVENT1 and calibration
+	uint64_t worRxTime;																		// RX_TIME in us
+	uint8_t  gdo0Int;																		// GDO0 interrupt enabled
+	uint8_t  gdo0Pend;																		// end of packet, not handled by the callback
+	uint8_t  busy;																			// main loop runs a sequence, see ccSetBusy
+	void     (*gdo0Cb)(void);																// GDO0 interrupt handler
+
+	uint8_t  spiSel;																		// chip select is active
+	uint8_t  inService;																		// avoids recursion if the handler uses the spi bus
+
+	uint8_t  spiFirst;																		// next byte is the header byte
+	uint8_t  spiAddr;																		// register address of the current transfer
+	uint8_t  spiRead   :1;																	// read access
+	uint8_t  spiBurst  :1;																	// burst access
+
+	uint8_t  rxFifo[HOST_FIFO_SIZE];														// rx fifo
+	uint8_t  rxLen, rxPos;
+	uint8_t  txFifo[HOST_FIFO_SIZE];														// tx fifo
+	uint8_t  txLen;
+	uint8_t  txBurst   :1;																	// preamble is on air since a STX with empty fifo
+	uint8_t  txActive  :1;																	// frame is on air
+	uint64_t txEnd;																			// end of air time for the current frame
+
+	s_hostFrame queue[HOST_RX_QUEUE];														// receive queue
+	uint8_t  qHead, qCnt;
+	uint64_t qEnd;																			// air time of the last queued frame ends here
+
+	hostTxCallback txCb;																	// callback for sent frames
+} hr;
+
+static void    hostWorStart(void) {
+	// timing of the polls out of the registers, 750 periods of the 26MHz crystal are one period of the RC oscillator
+	static const uint8_t evt1[] = { 4, 6, 8, 12, 16, 24, 32, 48 };							// EVENT1 in RC periods
+	uint8_t  res = hr.reg[CC1101_WORCTRL] & 0x03;
+	uint64_t rc = (750ULL << (5 * res)) * 1000 / 26;										// RC period in ns, scaled by WOR_RES
+	uint8_t  rxTime = hr.reg[CC1101_MCSM2] & 0x07;
+
+	hr.worPeriod = (((uint16_t)hr.reg[CC1101_WOREVT1] << 8) | hr.reg[CC1101_WOREVT0]) * rc / 1000;
+	if (!hr.worPeriod) return;																// no timing, the chip stays idle
+	hr.worRx = evt1[(hr.reg[CC1101_WORCTRL] >> 4) & 0x07] * 750 / 26 + HOST_CS_US;
+	hr.worRxTime = (rxTime == 7) ? hr.worPeriod : (hr.worPeriod * 36058 / 1000000) >> (rxTime + 5 * res);	// 3.6058% for RX_TIME 0
+	hr.worStart = hostClock;
+	hr.wor = 1;
+	hr.marc = MARCSTATE_SLEEP;
+}
+static void    hostWorCheck(void) {
+	// the first poll at or after the start of the frame has to find the preamble, after the sync word it's too late
+	s_hostFrame *f = &hr.queue[hr.qHead];
+	uint64_t from = (f->start > hr.worStart + hr.worPeriod) ? f->start : hr.worStart + hr.worPeriod;
+	uint64_t poll = hr.worStart + (from - hr.worStart + hr.worPeriod - 1) / hr.worPeriod * hr.worPeriod + hr.worRx;
+	if (poll > hostClock) return;															// not yet
+	if (poll >= f->end - (uint64_t)(f->buf[0] + 3) * HOST_BYTE_US) return;					// sync word is over, frame gets lost
+
+	hr.wor = 0;																				// poll found the preamble, RX until end of packet
+	hr.marc = MARCSTATE_RX;
+	hostPower.worWakes++;
+	hostPowerMove(hostClock - poll);
+}
+static void    hostRadioService(void) {
+	if (hr.inService) return;
+	hr.inService = 1;
+	if ((hr.wor) && (hr.qCnt)) hostWorCheck();
+
+	// finish a frame which was on air
+	if ((hr.txActive) && (hostClock >= hr.txEnd)) {
+		hostStat.rfTxFrames++;
+		if (hr.txBurst) hostStat.rfTxBursts++;
+		if (hr.txCb) hr.txCb(hr.txFifo, hr.txBurst);
+
+		hr.txActive = hr.txBurst = 0;
+		hr.txLen = 0;
+		hr.marc = MARCSTATE_RX;																// chip goes back to RX after TX
+	}
+
+	// receive the frames which are over
+	while ((hr.qCnt) && (hostClock >= hr.queue[hr.qHead].end)) {
+		if (hr.wor) hostWorCheck();
+		s_hostFrame *f = &hr.queue[hr.qHead];
+		hr.qHead = (hr.qHead + 1) % HOST_RX_QUEUE;
+		hr.qCnt--;
+
+		if ((hr.marc != MARCSTATE_RX) || (hr.rxLen)) {										// not listening or fifo not read yet
+			hostStat.rfRxLost++;
+			continue;
+		}
+
+		memcpy(hr.rxFifo, f->buf, f->buf[0] + 1);
+		hr.rxLen = f->buf[0] + 1;
+		hr.rxFifo[hr.rxLen++] = f->rssi;													// appended status bytes, rssi and lqi with crc ok
+		hr.rxFifo[hr.rxLen++] = f->lqi | 0x80;
+		hr.rxPos = 0;
+		hostStat.rfRxFrames++;
+
+		if (!hr.gdo0Int) continue;															// falling edge of GDO0, end of packet
+		mcuWake = 1;																		// pin change interrupt ends the sleep
+		if ((hr.gdo0Cb) && (!hr.spiSel) && (!hr.busy)) hr.gdo0Cb();
+		else hr.gdo0Pend = 1;
+	}
+
+	hr.inService = 0;
+}
+static void    hostRadioStrobe(uint8_t cmd) {
+	switch (cmd) {
+		case CC1101_SRES:
+			memset(hr.reg, 0, sizeof(hr.reg));
+			hr.rxLen = hr.rxPos = hr.txLen = hr.txBurst = hr.txActive = hr.wor = 0;
+			hr.marc = MARCSTATE_IDLE;
+			break;
+		case CC1101_SCAL:
+		case CC1101_SIDLE:
+			if (hr.txActive) hr.txEnd = hostClock;											// idle would abort the frame, the model lets it finish
+			hostRadioService();
+			hr.marc = MARCSTATE_IDLE;
+			hr.wor = 0;
+			break;
+		case CC1101_SRX:
+			hr.marc = MARCSTATE_RX;
+			hr.rxStart = hostClock;
+			break;
+		case CC1101_STX:
+			if (!hr.txLen) {																// no data, preamble only
+				hr.txBurst = 1;
+				hr.marc = MARCSTATE_TX;
+				break;
+			}
+			hr.txActive = 1;
+			hr.txEnd = hostClock + (uint64_t)(hr.txFifo[0] + 11) * HOST_BYTE_US;			// preamble, sync, length, data and crc
+			hr.marc = MARCSTATE_TX;
+			break;
+		case CC1101_SFRX:
+			hr.rxLen = hr.rxPos = 0;
+			break;
+		case CC1101_SFTX:
+			hr.txLen = 0;
+			break;
+		case CC1101_SPWD:
+			hr.marc = MARCSTATE_SLEEP;
+			break;
+		case CC1101_SWOR:
+			hostWorStart();
+			break;
+	}
+}
+static uint8_t hostRadioOnAir(void) {
+	if (!hr.qCnt) return 0;
+	return (hostClock >= hr.queue[hr.qHead].start) ? 1 : 0;									// the first frame is on air once its start is reached
+}
+static uint8_t hostRadioStatus(uint8_t addr) {
+	switch (addr) {
+		case CC1101_PARTNUM:   return 0x00;
+		case CC1101_VERSION:   return 0x14;
+		case CC1101_MARCSTATE: return hr.marc;
+		case CC1101_PKTSTATUS:
+			if ((hr.marc != MARCSTATE_RX) || (hostClock < hr.rxStart + HOST_CS_US)) return 0x00;	// neither carrier sense nor channel clear yet
+			return (hostRadioOnAir()) ? 0x40 : 0x10;										// carrier sense or channel clear
+		case CC1101_TXBYTES:   return hr.txLen;
+		case CC1101_RXBYTES:   return hr.rxLen - hr.rxPos;
+	}
+	return 0;
+}
+
+void    hostRadioRcv(uint8_t *buf, uint8_t rssi, uint8_t lqi, uint8_t burst) {
+	if ((hr.qCnt >= HOST_RX_QUEUE) || (buf[0] >= HOST_FIFO_SIZE - 2)) return;				// queue full or frame too long
+
+	s_hostFrame *f = &hr.queue[(hr.qHead + hr.qCnt++) % HOST_RX_QUEUE];
+	memcpy(f->buf, buf, buf[0] + 1);
+	f->rssi = rssi;
+	f->lqi = lqi;
+
+	if (hr.qEnd < hostClock) hr.qEnd = hostClock;											// channel is free, frame starts now
+	f->start = hr.qEnd;																		// otherwise right after the one before
+	hr.qEnd += ((burst) ? HOST_BURST_US : 0) + (uint64_t)(buf[0] + 11) * HOST_BYTE_US;
+	f->end = hr.qEnd;
+}
+void    hostRadioTx(hostTxCallback cb) {
+	hr.txCb = cb;
+}
+uint8_t hostRadioPending(void) {
+	return hr.qCnt;
+}
+
+void    ccInitHw(void) {
+	hr.marc = MARCSTATE_IDLE;
+}
+uint8_t ccSendByte(uint8_t data) {
+	hostStat.spiBytes++;
+
+	if (hr.spiFirst) {																		// header byte
+		hr.spiFirst = 0;
+		hr.spiAddr  = data & 0x3F;
+		hr.spiRead  = (data & READ_SINGLE) ? 1 : 0;
+		hr.spiBurst = (data & WRITE_BURST) ? 1 : 0;
+
+		if ((!hr.spiRead) && (!hr.spiBurst) && (hr.spiAddr >= CC1101_SRES) && (hr.spiAddr <= CC1101_SNOP)) {
+			hostRadioStrobe(hr.spiAddr);													// command strobe
+		}
+		return (hr.marc == MARCSTATE_RX) ? 0x10 : (hr.marc == MARCSTATE_TX) ? 0x20 : 0x00;	// chip status byte
+	}
+
+	if (hr.spiRead) {																		// data phase, read access
+		if (hr.spiAddr == CC1101_RXFIFO) return (hr.rxPos < hr.rxLen) ? hr.rxFifo[hr.rxPos++] : 0;
+		if ((hr.spiBurst) && (hr.spiAddr >= CC1101_PARTNUM) && (hr.spiAddr < CC1101_PATABLE)) return hostRadioStatus(hr.spiAddr);
+		uint8_t val = (hr.spiAddr < sizeof(hr.reg)) ? hr.reg[hr.spiAddr] : 0;
+		if (hr.spiBurst) hr.spiAddr++;
+		return val;
+	}
+
+	if (hr.spiAddr == CC1101_TXFIFO) {														// data phase, write access
+		if (hr.txLen < HOST_FIFO_SIZE) hr.txFifo[hr.txLen++] = data;
+	} else if (hr.spiAddr < sizeof(hr.reg)) {
+		hr.reg[hr.spiAddr] = data;
+		if (hr.spiBurst) hr.spiAddr++;
+	}
+	return 0;
+}
+uint8_t ccGetGDO0() {
+	hostRadioService();
+
+	uint8_t x = hr.gdo0Pend;
+	hr.gdo0Pend = 0;
+	return x;
+}
+void    ccSetGDO0(void) {
+	hr.gdo0Pend = 1;
+}
+void    ccGDO0Callback(void (*cb)(void)) {
+	hr.gdo0Cb = cb;
+}
+void    ccSetBusy(uint8_t busy) {
+	hr.busy = busy;
+}
+
+void    enableGDO0Int(void) {
+	hr.gdo0Int = 1;
+}
+void    disableGDO0Int(void) {
+	hr.gdo0Int = 0;
+}
+
+void    waitMiso(void) {
+}
+void    ccSelect(void) {
+	hostRadioService();
+	if (hr.marc == MARCSTATE_SLEEP) hr.marc = MARCSTATE_IDLE;								// chip select wakes the chip up
+	hr.wor = 0;																				// ...and ends wake on radio
+	hr.spiFirst = 1;
+	hr.spiSel = 1;
+}
+void    ccDeselect(void) {
+	hr.spiSel = 0;
+}
+//- -----------------------------------------------------------------------------------------------------------------------
+
+
+//- power model -----------------------------------------------------------------------------------------------------------
+// every us of the virtual clock is counted for the state of the mcu and the cc1101 at that time, the average current is
+// worked out of these times and the charge of the wake on radio polls when it is asked for. the currents are datasheet
+// values at 3V, atmega328p at 8MHz and cc1101 at 868MHz and +10dBm. a wake on radio poll costs EVENT1 with running
+// crystal, the calibration and RX_TIME in RX, the RSSI termination which ends most polls earlier is not part of the
+// model, so the result is an upper bound for the polls
+#define HOST_UA_MCU_RUN     4000.0															// active, the main loop never idles
+#define HOST_UA_MCU_WDT     4.5																// power down with watchdog
+#define HOST_UA_MCU_PWD     0.2																// power down, brown out detection off
+#define HOST_UA_CC_RX       15700.0
+#define HOST_UA_CC_TX       30000.0
+#define HOST_UA_CC_IDLE     1700.0
+#define HOST_UA_CC_PWD      0.2
+#define HOST_UA_CC_WOR      0.5																// sleep with RC oscillator, between the polls
+#define HOST_UA_CC_CAL      8000.0															// frequency synthesizer calibration
+#define HOST_CAL_US         720
+
+s_hostPower hostPower;
+static const double mcuUa[] = { HOST_UA_MCU_RUN, HOST_UA_MCU_WDT, HOST_UA_MCU_PWD };
+static const double ccUa[]  = { HOST_UA_CC_RX, HOST_UA_CC_TX, HOST_UA_CC_IDLE, HOST_UA_CC_PWD, HOST_UA_CC_WOR };
+
+static uint8_t hostRadioState(void) {
+	if (hr.wor) return 4;
+	if (hr.marc == MARCSTATE_RX) return 0;
+	if (hr.marc == MARCSTATE_TX) return 1;
+	if (hr.marc == MARCSTATE_SLEEP) return 3;
+	return 2;
+}
+static void    hostPowerAdd(uint64_t us) {
+	uint8_t cc = hostRadioState();
+	hostPower.mcuUs[mcuState] += us;
+	hostPower.ccUs[cc] += us;
+	if (!hr.wor) return;
+
+	// polls within the time which passes now
+	uint32_t polls = (hostClock + us - hr.worStart) / hr.worPeriod - (hostClock - hr.worStart) / hr.worPeriod;
+	hostPower.worPolls += polls;
+	if (polls) hostPower.pollCharge += polls * ((hr.worRx - HOST_CS_US) * HOST_UA_CC_IDLE + HOST_CAL_US * HOST_UA_CC_CAL + hr.worRxTime * HOST_UA_CC_RX);
+}
+static void    hostPowerMove(uint64_t us) {
+	// a poll found a frame, the time since then was charged as wake on radio but the chip was in RX
+	hostPower.ccUs[4] -= us;
+	hostPower.ccUs[0] += us;
+}
+double  hostPowerAvg(void) {
+	if (!hostClock) return 0;
+	double charge = hostPower.pollCharge;
+	for (uint8_t i = 0; i < 3; i++) charge += mcuUa[i] * hostPower.mcuUs[i];
+	for (uint8_t i = 0; i < 5; i++) charge += ccUa[i] * hostPower.ccUs[i];
+	return charge / hostClock;
+}
+//- -----------------------------------------------------------------------------------------------------------------------
+
+
+//- rf capture functions --------------------------------------------------------------------------------------------------
+static FILE    *capFile;																	// NULL while no capture is wanted
+
+void    hostCaptureFile(const char *path) {
+	if (capFile) fclose(capFile);
+	capFile = fopen(path, "wb");
+	if (!capFile) perror(path);
+}
+uint8_t capActive(void) {
+	return capFile ? 1 : 0;
+}
+void    capFrame(uint8_t flags, tMillis time, uint8_t rssi, uint8_t lqi, uint8_t *buf) {
+	if (!capFile) return;
+	uint8_t hdr[] = { CAP_SYNC, (uint8_t)time, (uint8_t)(time >> 8), (uint8_t)(time >> 16), (uint8_t)(time >> 24), flags, rssi, lqi };
+	fwrite(hdr, 1, sizeof(hdr), capFile);
+	fwrite(buf, 1, buf[0]+1, capFile);
+	fflush(capFile);
+}
+//- -----------------------------------------------------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,123 @@
+//- -----------------------------------------------------------------------------------------------------------------------
+// AskSin driver implementation
+// 2013-08-03 <trilu@gmx.de> Creative Commons - http://creativecommons.org/licenses/by-nc-sa/3.0/de/
+//- -----------------------------------------------------------------------------------------------------------------------
+//- Hardware abstraction layer for a linux host ---------------------------------------------------------------------------
+//- runs the unchanged AskSin stack inside a process, EEprom is file backed, the clock is virtual and the cc1101 is a model
+//- -----------------------------------------------------------------------------------------------------------------------
+
+#ifndef _HAL_LINUX_H
+	#define _HAL_LINUX_H
+
+	#include <stdint.h>
+	#include <stdlib.h>
+	#include <string.h>
+	#include <stdio.h>
+
+	//- avr-libc and arduino replacements -------------------------------------------------------------------------------------
+	#define PROGMEM
+	#define EEMEM
+	#define PSTR(x)                 (x)
+	class __FlashStringHelper;
+	#define F(x)                    (reinterpret_cast<const __FlashStringHelper *>(x))
+	#define pgm_read_byte(x)        (*(const uint8_t*)(x))
+	#define pgm_read_word(x)        (*(const uint16_t*)(x))
+	#define memcpy_P                memcpy
+
+	#define _BV(bit)                (1 << (bit))
+	#define bitRead(value, bit)     (((value) >> (bit)) & 0x01)
+	#define E2END                   0x3FF											// same eeprom size as the atmega328p
+
+	#define cli()
+	#define sei()
+	#define ATOMIC_RESTORESTATE
+	#define ATOMIC_BLOCK(type)      for (uint8_t _atomic = 1; _atomic; _atomic = 0)
+	#define ISR(vector)             void vector(void)
+
+	#define power_all_disable()
+	#define power_timer0_enable()
+	#define power_timer2_enable()
+	#define power_spi_enable()
+	#define power_serial_enable()
+
+	#define RF_CAP																	// capture is always built in, see hostCaptureFile
+
+	#define DEC                     10
+	#define HEX                     16
+
+	extern void     hostDelayUs(uint32_t us);										// advances the virtual clock
+	#define _delay_ms(ms)           hostDelayUs((uint32_t)((ms) * 1000))
+	#define _delay_us(us)           hostDelayUs((uint32_t)(us))
+	#define millis()                getMillis()
+
+	class Print {
+	  public:
+		virtual size_t write(uint8_t c) = 0;
+		size_t  print(const char *s)                 { size_t n = 0; while (*s) n += write(*s++); return n; }
+		size_t  print(const __FlashStringHelper *s)  { return print(reinterpret_cast<const char *>(s)); }
+		size_t  print(char c)                        { return write(c); }
+		size_t  print(unsigned char b, int base=DEC) { return print((unsigned long)b, base); }
+		size_t  print(int n, int base=DEC)           { return print((long)n, base); }
+		size_t  print(unsigned int n, int base=DEC)  { return print((unsigned long)n, base); }
+		size_t  print(long n, int base=DEC)          { if ((n < 0) && (base == DEC)) { write('-'); return print((unsigned long)-n, base) + 1; } return print((unsigned long)n, base); }
+		size_t  print(unsigned long n, int base=DEC) { char b[34], *p = &b[33]; *p = 0; do { uint8_t d = n % base; *--p = d < 10 ? '0' + d : 'A' + d - 10; n /= base; } while (n); return print(p); }
+		size_t  print(double n, int digits=2)        { char b[32]; snprintf(b, sizeof(b), "%.*f", digits, n); return print(b); }
+		size_t  println(void)                        { return write('\n'); }
+		template<class T> size_t println(T arg)      { size_t n = print(arg); return n + println(); }
+	};
+
+	class HardwareSerial : public Print {
+	  public:
+		FILE    *out;																	// stream the debug output goes to, NULL silences it
+		HardwareSerial() : out(stdout) {}
+		void    begin(unsigned long baud)            { (void)baud; }
+		int     available(void)                      { return 0; }
+		int     read(void)                           { return -1; }
+		size_t  write(uint8_t c)                     { if (out) fputc(c, out); return 1; }
+	};
+	extern HardwareSerial Serial;
+	//- -----------------------------------------------------------------------------------------------------------------------
+
+	//- host simulation hooks ---------------------------------------------------------------------------------------------------
+	// the radio model holds a queue of encoded frames which are sent back to back, at the end of its air time a frame is
+	// handed over to the RX FIFO while the cc1101 sits in RX mode and the fifo is empty, otherwise it counts as lost.
+	// GDO0 reports the end of packet like IOCFG0 = 0x06 would do it. sent frames are handed over to the TX callback.
+	// the power model charges the virtual time with the currents of the mcu and the cc1101 in their states
+	typedef void (*hostTxCallback)(uint8_t *buf, uint8_t burst);
+
+	struct s_hostStat {
+		uint32_t spiBytes;																// bytes clocked over the spi bus
+		uint32_t eeRdCalls;																// raw eeprom reads
+		uint32_t eeRdBytes;																// bytes read from eeprom
+		uint32_t eeWrBytes;																// bytes written to eeprom
+		uint32_t eeWrCycles;															// write cycles of the eeprom, a byte or with EE_EXT a page
+		uint32_t i2cBytes;																// bytes on the i2c bus of the external eeprom
+		uint32_t rfRxFrames;															// frames handed over to the rx fifo
+		uint32_t rfRxLost;																// frames on air while not listening or fifo full
+		uint32_t rfTxFrames;															// frames sent by the cc1101 model
+		uint32_t rfTxBursts;															// frames sent with burst preamble
+		uint32_t sleepMs;																// time spent in setSleep
+		uint32_t uartBytes;																// bytes of the trace sent over the serial port
+	};
+	extern s_hostStat hostStat;
+
+	struct s_hostPower {
+		uint64_t mcuUs[3];																// mcu running, power down with watchdog, power down
+		uint64_t ccUs[5];																// cc1101 in RX, TX, IDLE, power down, wake on radio
+		uint32_t worPolls;																// RX polls in wake on radio mode
+		uint32_t worWakes;																// ...which found a preamble and stayed in RX
+		double   pollCharge;															// uA * us of the polls, on top of the times above
+	};
+	extern s_hostPower hostPower;
+
+	extern void     hostEEPromFile(const char *path);								// set the eeprom image file, call before hm.init()
+	extern void     hostCaptureFile(const char *path);								// stream the rf capture into this file
+	extern void     hostRadioRcv(uint8_t *buf, uint8_t rssi, uint8_t lqi, uint8_t burst = 0);	// queue an encoded frame for reception, buf[0] holds the length
+	extern void     hostRadioTx(hostTxCallback cb);									// register a callback for sent frames
+	extern uint8_t  hostRadioPending(void);											// frames waiting in the receive queue
+	extern uint32_t hostMicros(void);												// virtual clock in us
+	extern void     hostSleepLimit(uint32_t ms);									// a sleep without watchdog ends here at the latest
+	extern double   hostPowerAvg(void);												// average current in uA since start
+	//- -----------------------------------------------------------------------------------------------------------------------
+
+#endif
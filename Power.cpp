@@ -34,6 +34,7 @@ void PW::setMode(uint8_t mode) {
 
 	initWakeupPin();
 	//setSleepMode();
+	if (pwrMode == 5) setSleepMode();														// power down, GDO0 and the watchdog wake us up
 	stayAwake(10000);																		// startup means stay awake for next 20 seconds
 }
 void PW::stayAwake(uint16_t time) {
@@ -55,13 +56,19 @@ void PW::poll(void) {
 	// communication module could stay idle, communication will start with transmition
 	//
 	// mode 4 means - sleep for ever until an interrupt get raised
+	//
+	// mode 5 means - the cc1101 polls for a burst in wake on radio mode, the mcu sleeps in power down until GDO0 reports
+	// a received frame, the watchdog runs only while a timer is armed
+	//
+	// in mode 1 to 3 the sleep ends earlier if an armed waitTimer is due before, see waitTimer::next()
 	
 	if (pwrMode == 0) return;																// no power savings, there for we can exit
 	if (!pwrTmr.done()) return;																// timer active, jump out
 	if (checkWakeupPin()) return;															// wakeup pin active
 	
 	// some communication still active, jump out
-	if ((pHM->sn.active) || (pHM->stcSlice.active) || (pHM->cFlag.active) || (pHM->pairActive) || (pHM->confButton.armFlg)) return;
+	if ((pHM->sn.active) || (pHM->rv.rCnt) || (pHM->stcSlice.active) || (pHM->cFlag.active) || (pHM->pairActive) || (pHM->confButton.armFlg)) return;
+	if (waitTimer::next() < 16) return;														// a timer is due before the shortest watchdog period
 	
 	#ifdef PW_DBG																			// only if pw debug is set
 	dbg << '.';																				// ...and some information
@@ -101,15 +108,22 @@ void PW::poll(void) {
 	}
 
 	// if we are here, we could go sleep. set cc module idle, switch off led's and sleep
-	pHM->cc.setIdle();																		// set communication module to idle
+	flushEEProm(1);																			// nothing should wait in ram while we sleep
+	if (pwrMode == 5) pHM->cc.setWOR();														// communication module listens by itself
+	else pHM->cc.setIdle();																	// set communication module to idle
 	pHM->ld.set(nothing);																	// switch off all led's
 
-	// start the respective watchdog timers
+	// start the watchdog, the power mode sets the longest sleep, the next armed timer could shorten it
+	uint32_t sleepMs = 8192;
+	if ((pwrMode == 1) && (!chkCCBurst)) sleepMs = 256;
+	if ((pwrMode == 1) && (chkCCBurst)) sleepMs = 32;
+	if (pwrMode == 2) sleepMs = 256;
+	uint32_t nextMs = waitTimer::next();
+	if (nextMs < sleepMs) sleepMs = nextMs;
+
 	cli();
-	if ((pwrMode == 1) && (!chkCCBurst)) startWDG250ms();
-	if ((pwrMode == 1) && (chkCCBurst)) startWDG32ms();
-	if (pwrMode == 2) startWDG250ms();
-	if (pwrMode == 3) startWDG8000ms();
+	if ((pwrMode == 5) && (nextMs == 0xffffffff)) stopWDG();								// only the frame wakes us up
+	else if (pwrMode != 4) startWDGms(sleepMs);
 	sei();
 
 
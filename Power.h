@@ -17,6 +17,7 @@
 // 2 - deep sleep, wakeup every 250ms, not able to receive anything while sleeping, timer gets updated every 256ms
 // 3 - 0.04ma; deep sleep, wakeup every 8 seconds, not able to receive anything while sleeping, timer gets updated every 8192ms
 // 4 - 0.00ma; deep sleep, wakeup only on interrupt
+// 5 - wake on radio, the cc1101 looks for a burst every 300ms by itself, deep sleep until a frame or the next timer
 
 class PW {
 	friend class AS;
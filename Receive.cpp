@@ -8,10 +8,16 @@
 
 #define RV_DBG
 //#define RV_DBG_EX
+#define RV_TRC 2																			// trace level of the frames, see Trace.h
 #include "Receive.h"
 #include "AS.h"
 
 
+static RV *pRV;																				// instance for the GDO0 interrupt
+static void rcvGDO0(void) {
+	pRV->rcvISR();
+}
+
 // private:		//---------------------------------------------------------------------------------------------------------
 RV::RV() {
 }
@@ -24,6 +30,61 @@ void    RV::init(AS *ptrMain) {
 
 	pHM = ptrMain;
 	buf = (uint8_t*)&mBdy;
+
+	pRV = this;
+	ccGDO0Callback(rcvGDO0);																// fifo gets read within the GDO0 interrupt
+}
+void    RV::rcvISR(void) {
+	// runs within the GDO0 interrupt, or from AS::poll if the interrupt found the spi bus busy. the fifo is read and decoded
+	// into the next free slot, frames for other devices are dropped on the fly. all the rest is done later in the main loop
+	if (rCnt >= rvRingSize) {																// ring is full, drop the new frame
+		pHM->cc.rcvRestart();
+		ringOvr++;
+		return;
+	}
+
+	struct s_rvSlot *s = &ring[rHead];
+	#if defined(RV_DBG_EX)																	// extended debug shows all frames, also the ones for others
+	uint8_t *ownID = NULL;
+	#elif defined(RF_CAP)
+	uint8_t *ownID = capActive() ? NULL : HMID;												// a capture holds everything on air
+	#else
+	uint8_t *ownID = HMID;
+	#endif
+	if (!pHM->cc.rcvData(s->buf, ownID)) return;											// nothing in the fifo, a broken frame or not for us
+
+	s->rssi = pHM->cc.rssi;
+	s->lqi  = pHM->cc.lqi | (pHM->cc.crc_ok << 7);
+	s->time = getMillis();
+
+	if (++rHead >= rvRingSize) rHead = 0;
+	rCnt++;
+	if (rCnt > ringMax) ringMax = rCnt;
+}
+uint8_t RV::pop(void) {
+	// move the oldest frame of the ring into the receive buffer, returns the length byte
+	if (!rCnt) return 0;
+
+	struct s_rvSlot *s = &ring[rTail];
+	memcpy(buf, s->buf, s->buf[0]+1);
+	rssi    = s->rssi;
+	lqi     = s->lqi;
+	rcvTime = s->time;
+
+	if (++rTail >= rvRingSize) rTail = 0;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		rCnt--;																				// slot is free for the interrupt again
+	}
+
+	#ifdef RF_CAP
+	if (capActive()) {																		// record the frame like it was on air
+		uint8_t x[MaxDataLen+1];
+		memcpy(x, buf, buf[0]+1);
+		pHM->encode(x);
+		capFrame(0, rcvTime, rssi, lqi, x);
+	}
+	#endif
+	return buf[0];
 }
 void	RV::poll(void) {
 	static uint8_t last_rCnt;
@@ -33,11 +94,15 @@ void	RV::poll(void) {
 		this->peerId[3] = (this->buf[10] & 0x3f);											// mask out long and battery low
 	}
 	
-	uint8_t bIntend = pHM->ee.getIntend(this->mBdy.reID,this->mBdy.toID, this->peerId);		// get the intend of the message
+	uint8_t *toID = this->mBdy.toID;
+	if (pHM->getGroup(toID) != 0xff) toID = HMID;											// sent to one of our groups, as good as to us
+	uint8_t bIntend = pHM->ee.getIntend(this->mBdy.reID, toID, this->peerId);				// get the intend of the message
+	// ACK or ACK_STATUS of the receiver or a group member of a frame on the way, they are no peers of us
+	if ((bIntend == 'u') && (this->mBdy.mTyp == 0x02) && (this->mBdy.by10 <= 0x01) && (pHM->sn.isAnswer(this->mBdy.reID, this->mBdy.mCnt))) bIntend = 'a';
 
 	// some debugs
-	#ifdef RV_DBG																			// only if AS debug is set
-		dbg << (char)bIntend << F("> ") << _HEX(this->buf, this->bufLen) << ' ' << _TIME << '\n';
+	#if RV_TRC																				// trace of the received frame
+		trcFrame(TRC_RV_FRAME, bIntend, this->buf, RV_TRC);
 	#endif
 	
 	#ifdef RV_DBG_EX																		// only if extended AS debug is set
@@ -52,8 +117,8 @@ void	RV::poll(void) {
 
 	// filter out repeated messages
 	if ((this->mBdy.mFlg.RPTED) && (last_rCnt == this->mBdy.mLen)) {						// check if message was already received
-		#ifdef RV_DBG																		// only if AS debug is set
-			dbg << F("  repeated message\n");
+		#if RV_TRC
+			trcEvent(TRC_RV_REPEAT, 0, NULL, 0);
 		#endif
 
 		this->mBdy.mLen = 0;																// clear receive buffer
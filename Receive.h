@@ -12,9 +12,13 @@
 
 #include "HAL.h"
 #define MaxDataLen   60						// maximum length of received bytes
+#ifndef rvRingSize
+	#define rvRingSize 3						// frames which could be held between GDO0 interrupt and poll
+#endif
 
 class RV {
 	friend class AS;
+	friend class PW;
   
   protected:	//---------------------------------------------------------------------------------------------------------
 	struct s_mFlg {
@@ -40,11 +44,28 @@ class RV {
 	  uint8_t       pyLd[MaxDataLen-12];	// payload
 	};
 
+	struct s_rvSlot {
+	  uint8_t       buf[MaxDataLen+1];		// length byte and decoded frame
+	  uint8_t       rssi;					// signal strength, as read by the cc1101 class
+	  uint8_t       lqi;					// link quality, bit 7 crc ok
+	  tMillis       time;					// time of the GDO0 interrupt
+	} ring[rvRingSize];						// filled by the interrupt, emptied in order by pop
+	uint8_t rHead;							// next slot to fill, only touched by the interrupt
+	uint8_t rTail;							// next slot to read, only touched by poll
+	volatile uint8_t rCnt;					// frames in the ring
+
   public:		//---------------------------------------------------------------------------------------------------------
 	struct s_msgBody mBdy;					// structure for easier message creation
 	uint8_t peerId[4];						// hold for messages >= 3E the peerID with channel
 	uint8_t *buf;							// cast to byte array
 
+	uint8_t rssi;							// signal strength of the frame in buf
+	uint8_t lqi;							// link quality of the frame in buf, bit 7 crc ok
+	tMillis rcvTime;						// time of reception of the frame in buf
+
+	uint8_t  ringMax;						// statistics, most frames waiting in the ring
+	uint16_t ringOvr;						// statistics, frames dropped because the ring was full
+
 	#define hasData		buf[0]?1:0			// check if something is in the buffer
 
   private:		//---------------------------------------------------------------------------------------------------------
@@ -54,11 +75,14 @@ class RV {
 	class AS *pHM;							// pointer to main class for function calls
 
   public:		//---------------------------------------------------------------------------------------------------------
+	void    rcvISR(void);							// read the cc1101 fifo into the ring, called by the GDO0 interrupt
+
   protected:	//---------------------------------------------------------------------------------------------------------
   private:		//---------------------------------------------------------------------------------------------------------
 	RV();
 	void    init(AS *ptrMain);
 	void    poll(void);
+	uint8_t pop(void);
 
 };
 
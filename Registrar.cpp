@@ -21,6 +21,13 @@ void	RG::regInAS(uint8_t cnl, uint8_t lst, s_mod_dlgt delegate, uint8_t *mainLis
 	pHM->ee.getList(cnl,1,0,modTbl[cnl-1].lstCnl);											// load list1 in the respective buffer
 	modTbl[cnl-1].mDlgt(0x01, 0, 0x06, NULL, 0);											// inform the module of the change
 }
+void	RG::setDue(uint8_t cnl, uint32_t ms) {
+	// a module which never calls setDue is polled every loop. one which calls it after every poll and every event tells
+	// RG when it has work again, a timer which runs out or something which has to be done right now
+	modTbl[cnl-1].sleep = (ms) ? 1 : 0;
+	if (ms > 0x7fffffff) ms = 0x7fffffff;													// events only, but the wake time has to stay comparable
+	modTbl[cnl-1].wake = getMillis() + ms;
+}
 
 // private:		//---------------------------------------------------------------------------------------------------------
 RG::RG() {
@@ -35,8 +42,18 @@ void    RG::init(AS *ptrMain) {
 	pHM = ptrMain;
 }
 void	RG::poll(void) {
-	// poll through the module table
+	// poll through the module table, modules which sleep are skipped until their wake time
+	uint32_t now = getMillis();
+	uint32_t calls = rgStat.calls;
+	rgStat.loops++;
+
 	for (uint8_t i = 0; i < devDef.cnlNbr; i++) {
-		if (modTbl[i].cnl) modTbl[i].mDlgt(0,0,0,NULL,0);
+		if (!modTbl[i].cnl) continue;														// no module on this channel
+		if ((modTbl[i].sleep) && ((int32_t)(now - modTbl[i].wake) < 0)) continue;			// not due yet
+		rgStat.calls++;
+		modTbl[i].mDlgt(0,0,0,NULL,0);
 	}
+	if (rgStat.calls == calls) rgStat.idle++;
 }
+
+s_rgStat rgStat;
@@ -27,6 +27,11 @@ class RG {
 		uint8_t msgCnt;																		// channel message counter
 		uint8_t *lstCnl;																	// pointer to list0/1
 		uint8_t *lstPeer;																	// pointer to list3/4
+		uint8_t sleep :1;																	// module waits for wake or an event, see setDue()
+		uint8_t stsPend :1;																	// actuator status waits for AS::sendStatList()
+		uint8_t stsStat;																	// ...its value
+		uint8_t stsDul;																		// ...and the down up low battery byte
+		uint32_t wake;																		// getMillis() of the next poll while sleep is set
 		s_mod_dlgt mDlgt;																	// delegate to the module function
 	};
 
@@ -37,6 +42,7 @@ class RG {
 
   public:		//---------------------------------------------------------------------------------------------------------
 	void regInAS(uint8_t cnl, uint8_t lst, s_mod_dlgt delegate, uint8_t *mainList, uint8_t *peerList);
+	void setDue(uint8_t cnl, uint32_t ms);													// poll the module again in ms, 0 every loop, 0xffffffff on events only
 
   protected:	//---------------------------------------------------------------------------------------------------------
   private:		//---------------------------------------------------------------------------------------------------------
@@ -47,4 +53,11 @@ class RG {
 };
 extern RG::s_modTable modTbl[];																// initial register.h
 
+struct s_rgStat {
+	uint32_t loops;																			// RG::poll() calls
+	uint32_t calls;																			// module polls out of them
+	uint32_t idle;																			// loops without a due module
+};
+extern s_rgStat rgStat;
+
 #endif
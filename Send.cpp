@@ -7,15 +7,14 @@
 //- -----------------------------------------------------------------------------------------------------------------------
 
 #define SN_DBG
+#define SN_TRC 2																			// trace level of the frames, see Trace.h
 #include "Send.h"
 #include "AS.h"
 
 // private:		//---------------------------------------------------------------------------------------------------------
-#define sndLen       this->buf[0]+1															// amount of bytes in the send buffer
+#define sndLen       (this->buf[0]+1)													// amount of bytes in the send buffer
 #define reqACK       this->mBdy.mFlg.BIDI													// check if an ACK is requested
 
-waitTimer sndTmr;																			// send timer functionality
-
 SN::SN() {
 } 
 void SN::init(AS *ptrMain) {
@@ -28,83 +27,202 @@ void SN::init(AS *ptrMain) {
 	buf = (uint8_t*)&mBdy;
 }
 void SN::poll(void) {
-	#define maxRetries    3
 	#define maxTime       300
-	
-	// set right amount of retries
-	if (!this->maxRetr) {																	// first time run, check message type and set retries
-		if (reqACK) this->maxRetr = maxRetries;												// if BIDI is set, we have three retries
-		else this->maxRetr = 1;
+
+	// while a frame or the burst preamble is on air the cc1101 works on its own, we only check if it is done. the time
+	// out for the ACK starts when the frame was sent completely
+	if (txQ) {
+		if (!pHM->cc.txDone()) return;
+		txQ->sndTime = getMillis();
+		txQ = NULL;
 	}
-	
-	//dbg << "x:" << this->retrCnt << " y:" << this->maxRetr << " t:" << sndTmr.done() << '\n';
-	
-	// send something while timer is not busy with waiting for an answer and max tries are not done 
-	if ((this->retrCnt < this->maxRetr) && (sndTmr.done() )) {								// not all sends done and timing is OK
-
-		// some sanity
-		this->mBdy.mFlg.RPTEN = 1;															// every message need this flag
-		//if (pHM->cFlag.active) this->mBdy.mFlg.CFG = pHM->cFlag.active;						// set the respective flag while we are in config mode
-		this->timeOut = 0;																	// not timed out because just started
-		this->lastMsgCnt = this->mBdy.mCnt;													// copy the message count to identify the ACK
-		this->retrCnt++;																	// increase counter while send out
-
-		// check if we should send an internal message
-		if (compArray(this->mBdy.toID, HMID, 3)) {											// message is addressed to us
-			memcpy(pHM->rv.buf, this->buf, sndLen);											// copy send buffer to received buffer
-			this->retrCnt = 0xff;															// ACK not required, because internal
-						
-			#ifdef SN_DBG																	// only if AS debug is set
-			dbg << F("<i ");
-			#endif
-
-		} else {																			// send it external
-			uint8_t tBurst = this->mBdy.mFlg.BURST;											// get burst flag, while string will get encoded
-			pHM->encode(this->buf);															// encode the string
-			disableGDO0Int();
-			pHM->cc.sndData(this->buf,tBurst);												// send to communication module
-			enableGDO0Int();
-			pHM->decode(this->buf);															// decode the string, so it is readable next time
-			
-			if (reqACK) sndTmr.set(maxTime);												// set the time out for the message
-			
-			#ifdef SN_DBG																	// only if AS debug is set
-			dbg << F("<- ");
-			#endif
 
+	// first round, clean up finished frames and check if a BIDI frame is on the way. only one BIDI frame is on the way
+	// at a time, otherwise the answer of the other side could be missed while we are sending. frames without ACK request
+	// are send in between.
+	uint8_t busy = 0;
+	for (uint8_t i = 0; i < sndQueSize; i++) {
+		struct s_sndQue *q = &que[i];
+		if (!q->used) continue;
+
+		uint8_t bidi = q->buf[2] & 0x20;
+		uint16_t wait = maxTime + q->grpN * grpSlotTime;									// group members answer one after the other
+		if (q->retrCnt == 0xff) endFrame(q, 0);												// answer was received
+		else if ((q->retrCnt >= q->maxRetr) && ((!bidi) || ((uint16_t)((uint16_t)getMillis() - q->sndTime) >= wait))) endFrame(q, bidi);
+		else if ((q->retrCnt) && (bidi)) busy = 1;											// max retries not achieved, BIDI frame is on the way
+	}
+
+	// second round, the next one to send is the oldest frame of the highest priority which is not waiting for an ACK
+	struct s_sndQue *nxt = NULL;
+	for (uint8_t i = 0; i < sndQueSize; i++) {
+		struct s_sndQue *q = &que[i];
+		if (!q->used) continue;
+
+		uint8_t bidi = q->buf[2] & 0x20;
+		uint16_t age = (uint16_t)getMillis() - q->sndTime;
+		if ((q->retrCnt) && (bidi) && (age < maxTime + q->grpN * grpSlotTime)) continue;	// waiting for the ACK
+		if ((!q->retrCnt) && (age < q->hold)) continue;										// reply slot not reached
+		if ((!q->retrCnt) && (bidi) && (busy)) continue;									// new BIDI frame has to wait
+
+		if ((!nxt) || (q->prio < nxt->prio) || ((q->prio == nxt->prio) && ((int8_t)(q->seq - nxt->seq) < 0))) nxt = q;
+	}
+	if (nxt) sndFrame(nxt);
+
+	active = queDepth ? 1 : 0;
+}
+uint8_t SN::push(uint8_t prio) {
+	#define maxRetries    3
+
+	this->mBdy.mFlg.RPTEN = 1;																// every message need this flag
+	//if (pHM->cFlag.active) this->mBdy.mFlg.CFG = pHM->cFlag.active;						// set the respective flag while we are in config mode
+	uint8_t retr = this->maxRetr;
+	uint16_t hold = this->hold;
+	uint8_t grpN = this->grpN;
+	this->maxRetr = 0;																		// next push selects again by BIDI flag
+	this->hold = this->grpN = 0;
+
+	// search a free slot, if the queue is full, the newest frame with the lowest priority below the new one is replaced
+	// as long as it wasn't send already
+	struct s_sndQue *q = NULL;
+	for (uint8_t i = 0; i < sndQueSize; i++) {
+		struct s_sndQue *t = &que[i];
+		if (!t->used) { q = t; break; }
+
+		if ((t->retrCnt) || (t->prio <= prio)) continue;
+		if ((!q) || (t->prio > q->prio) || ((t->prio == q->prio) && ((int8_t)(t->seq - q->seq) > 0))) q = t;
+	}
+
+	if ((!q) || (sndLen > MaxSndLen)) {														// nothing free or too long
+		queDrop++;
+		#if SN_TRC																			// trace of the dropped frame
+		trcFrame(TRC_SN_DROP, 0, this->buf, SN_TRC);
+		#endif
+		return 0;
+	}
+
+	if (q->used) {																			// replaced frame counts as dropped
+		queDrop++;
+		queDepth--;
+		#if SN_TRC																			// trace of the dropped frame
+		trcFrame(TRC_SN_DROP, 0, q->buf, SN_TRC);
+		#endif
+	}
+
+	memcpy(q->buf, this->buf, sndLen);														// copy the frame in the slot
+	q->used = 1;
+	q->prio = prio;
+	q->seq = seqCnt++;
+	q->retrCnt = 0;
+	q->sndTime = getMillis();																// the hold starts now
+	q->hold = hold;
+	q->grpN = grpN;
+	if (retr) q->maxRetr = retr;
+	else q->maxRetr = (reqACK) ? maxRetries : 1;											// if BIDI is set, we have three retries
+
+	queDepth++;
+	if (queDepth > queMax) queMax = queDepth;
+	this->active = 1;
+	return 1;
+}
+uint8_t SN::hasSlot(uint8_t prio) {
+	if (queDepth >= sndQueSize) return 0;													// queue is full
+	for (uint8_t i = 0; i < sndQueSize; i++) {
+		if ((que[i].used) && (que[i].prio == prio)) return 0;								// something of this priority is still on the way
+	}
+	return 1;
+}
+void SN::rcvACK(uint8_t cnt) {
+	for (uint8_t i = 0; i < sndQueSize; i++) {
+		struct s_sndQue *q = &que[i];
+		if ((!q->used) || (!q->retrCnt) || (q->retrCnt == 0xff)) continue;					// not send till now
+		if ((!(q->buf[2] & 0x20)) || (q->buf[1] != cnt)) continue;							// not the active message this ACK belongs to
+
+		if (q->grpN) {																		// group frame, every member counts once
+			uint8_t slot = grpSlot(q);
+			if (slot == 0xff) continue;														// no member, or this one answered already
+			grpSlots |= 1UL << slot;
+			if (grpIdCnt < grpAckMax) memcpy(grpIds[grpIdCnt++], pHM->rv.mBdy.reID, 3);
 		}
-		
-		if (!pHM->ld.active) pHM->ld.set(send);												// fire the status led
-		
-		#ifdef SN_DBG																		// only if AS debug is set
-		dbg << _HEX(this->buf,sndLen) << ' ' << _TIME << '\n';
+		if (q->grpAck > 1) q->grpAck--;														// group frame, other members have still to answer
+		else q->retrCnt = 0xff;																// message counter is similar - set retrCnt to 255
+	}
+	//dbg << "act:" << this->active << " cnt:" << cnt << '\n';
+}
+uint8_t SN::isAnswer(uint8_t *id, uint8_t cnt) {
+	for (uint8_t i = 0; i < sndQueSize; i++) {
+		struct s_sndQue *q = &que[i];
+		if ((!q->used) || (!q->retrCnt) || (q->retrCnt == 0xff)) continue;					// not send till now
+		if ((!(q->buf[2] & 0x20)) || (q->buf[1] != cnt)) continue;							// no ACK requested or other counter
+		if (compArray(q->buf+7, id, 3)) return 1;											// the receiver of the frame
+		if ((q->grpN) && (grpSlot(q) != 0xff)) return 1;									// a member of the group in its reply slot
+	}
+	return 0;
+}
+uint8_t SN::grpSlot(struct s_sndQue *q) {
+	// the sender doesn't know the members of a group, only how many there are. a member answers in its reply slot after
+	// the end of the frame, so an ACK which ends outside the slots of the group isn't one of a member. a slot counts once
+	// and so does a member, the second ACK through a repeater ends in a later slot
+	uint16_t past = (uint16_t)pHM->rv.rcvTime - q->sndTime;
+	uint16_t slot = past / grpSlotTime;
+	if ((slot >= q->grpN) || (slot >= 32) || (grpSlots & (1UL << slot))) return 0xff;
+	for (uint8_t i = 0; i < grpIdCnt; i++) {
+		if (compArray(grpIds[i], pHM->rv.mBdy.reID, 3)) return 0xff;
+	}
+	return slot;
+}
+void SN::sndFrame(struct s_sndQue *q) {
+	q->retrCnt++;																			// increase counter while send out
+	q->sndTime = getMillis();
+	q->grpAck = q->grpN;																	// every round collects the ACKs of all members
+	if (q->grpN) grpSlots = grpIdCnt = 0;
+
+	// check if we should send an internal message
+	if (compArray(q->buf+7, HMID, 3)) {														// message is addressed to us
+		memcpy(pHM->rv.buf, q->buf, q->buf[0]+1);											// copy send buffer to received buffer
+		q->retrCnt = 0xff;																	// ACK not required, because internal
+
+		#if SN_TRC																			// trace of the internal frame
+		trcFrame(TRC_SN_INT, 0, q->buf, SN_TRC);
+		#endif
+
+	} else {																				// send it external
+		uint8_t tBurst = q->buf[2] & 0x10;													// get burst flag, while string will get encoded
+		pHM->encode(q->buf);																// encode the string
+		pHM->cc.startTx(q->buf,tBurst ? 1 : 0);												// hand over to the communication module, it copies the frame
+		#ifdef RF_CAP
+		capFrame(CAP_TX | (tBurst ? CAP_BURST : 0), q->sndTime, 0, 0, q->buf);				// record it as it goes on air
+		#endif
+		pHM->decode(q->buf);																// decode the string, so it is readable next time
+		txQ = q;																			// poll waits for the end of the transmission
+
+		#if SN_TRC																			// trace of the sent frame
+		trcFrame(TRC_SN_TX, 0, q->buf, SN_TRC);
 		#endif
 
-	} else if ((this->retrCnt >= this->maxRetr) && (sndTmr.done() )) {						// max retries achieved, but seems to have no answer
-		this->retrCnt = 0;
-		this->maxRetr = 0;
-		this->active = 0;
-		if (!reqACK) return;
-		
-		this->timeOut = 1;																	// set the time out only while an ACK or answer was requested
+	}
+
+	if (!pHM->ld.active) pHM->ld.set(send);													// fire the status led
+}
+void SN::endFrame(struct s_sndQue *q, uint8_t tOut) {
+	uint8_t gotACK = (q->retrCnt == 0xff);
+
+	q->used = 0;
+	queDepth--;
+	this->active = queDepth ? 1 : 0;
+
+	if (tOut) this->timeOut |= _BV(q->prio);												// remember the result per priority
+	else this->timeOut &= ~_BV(q->prio);
+
+	if (tOut) {																				// set the time out only while an ACK or answer was requested
 		pHM->pw.stayAwake(100);
 		pHM->ld.set(noack);
-		
-		#ifdef SN_DBG																		// only if AS debug is set
-		dbg << F("  timed out") << ' ' << _TIME << '\n';
+
+		#if SN_TRC
+		trcEvent(TRC_SN_TOUT, 0, NULL, 0);
 		#endif
-	}
 
-	if (this->retrCnt == 0xff) {															// answer was received, clean up the structure
-		this->timeOut = 0;
-		this->retrCnt = 0;
-		this->maxRetr = 0;
-		this->active = 0;
-		sndTmr.set(0);
-		
+	} else if (gotACK) {																	// answer was received
 		pHM->pw.stayAwake(100);
 		if (!pHM->ld.active) pHM->ld.set(ack);												// fire the status led
 	}
-
-	
 }
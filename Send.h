@@ -11,6 +11,23 @@
 
 #include "HAL.h"
 #define MaxDataLen   60						// maximum length of received bytes
+#define MaxSndLen    32						// maximum length of a queued frame, DEVICE_INFO with 27 byte is the longest one
+#ifndef sndQueSize
+	#define sndQueSize 4					// frames the send queue can hold
+#endif
+
+// priorities of the send queue, lower value goes out first
+#define sndPrioACK     0					// ACK, ACK_STATUS, NACK
+#define sndPrioConfig  1					// answers to config requests, device info
+#define sndPrioStatus  2					// actuator status
+#define sndPrioPeer    3					// peer events
+
+#ifndef grpSlotTime
+	#define grpSlotTime 40					// ms per reply slot of a group member, an ACK_STATUS takes 21ms on air
+#endif
+#ifndef grpAckMax
+	#define grpAckMax   8					// members of a group frame we remember the ACK of, see grpSlot
+#endif
 
 
 class SN {
@@ -42,9 +59,27 @@ class SN {
 	};
 
 
-	uint8_t retrCnt;						// variable to count how often a message was already send
-	uint8_t maxRetr;						// how often a message has to be send until ACK
-	uint8_t lastMsgCnt;						// store of message counter, needed to identify ACK
+	struct s_sndQue {
+		uint8_t  buf[MaxSndLen];			// the frame, not encoded
+		uint8_t  used     :1;				// slot holds a frame
+		uint8_t  prio     :2;				// see sndPrio defines
+		uint8_t  seq;						// keeps the order within a priority
+		uint8_t  retrCnt;					// how often the frame was already send, 0xff if the ACK was received
+		uint8_t  maxRetr;					// how often the frame has to be send until ACK
+		uint16_t sndTime;					// time of the last send, for the ACK time out, or of the push
+		uint16_t hold;						// ms after the push the frame waits before it goes out the first time
+		uint8_t  grpN;						// frame goes to a group, ACKs of so many members finish it
+		uint8_t  grpAck;					// ...and the ACKs still missing in this round
+	} que[sndQueSize];
+
+	uint8_t seqCnt;							// sequence counter for the queue entries
+	uint8_t maxRetr;						// retries for the next push, 0 selects by BIDI flag
+	uint16_t hold;							// ms the next push waits, the reply slot of a group member
+	uint8_t grpN;							// group members the next push expects an ACK from, 0 for a single receiver
+	uint32_t grpSlots;						// reply slots of the group frame on the way which brought an ACK
+	uint8_t grpIds[grpAckMax][3];			// ...and the members which sent them
+	uint8_t grpIdCnt;
+	struct s_sndQue *txQ;					// frame which is on air, the cc1101 sends it in the background
 
 	class AS *pHM;							// pointer to main class for function calls
 
@@ -56,7 +91,16 @@ class SN {
 	uint8_t msgCnt;							// message counter for standard sends, while not answering something
 
 	uint8_t active   :1;					// is send module active, 1 indicates yes
-	uint8_t timeOut  :1;					// was last message a timeout
+	uint8_t timeOut  :4;					// per priority, was the last message a timeout
+
+	uint8_t  queDepth;						// frames in the send queue
+	uint8_t  queMax;						// highest queue depth seen
+	uint16_t queDrop;						// frames dropped because the queue was full
+
+	uint8_t push(uint8_t prio);				// queues the frame in mBdy, 0 if it was dropped
+	uint8_t hasSlot(uint8_t prio);			// 1 if nothing of this priority is queued and a slot is free
+	void    rcvACK(uint8_t cnt);			// ACK received, finish the respective frame
+	uint8_t isAnswer(uint8_t *id, uint8_t cnt);	// 1 if a frame on the way waits for this ACK of id
 
   public:		//---------------------------------------------------------------------------------------------------------
   protected:	//---------------------------------------------------------------------------------------------------------
@@ -65,6 +109,9 @@ class SN {
 	SN();
 	void init(AS *ptrMain);
 	void poll(void);
+	void sndFrame(struct s_sndQue *q);		// hands a frame over to the cc1101 or the receive buffer
+	void endFrame(struct s_sndQue *q, uint8_t tOut);
+	uint8_t grpSlot(struct s_sndQue *q);	// reply slot of the ACK in rv for the group frame q, 0xff if it is no new member
 };
 
 #endif 
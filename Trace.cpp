@@ -0,0 +1,65 @@
+//- -----------------------------------------------------------------------------------------------------------------------
+// AskSin driver implementation
+// 2013-08-03 <trilu@gmx.de> Creative Commons - http://creativecommons.org/licenses/by-nc-sa/3.0/de/
+//- -----------------------------------------------------------------------------------------------------------------------
+//- AskSin trace functions ------------------------------------------------------------------------------------------------
+//- -----------------------------------------------------------------------------------------------------------------------
+
+#include "Trace.h"
+
+s_trcStat trcStat;
+
+static uint8_t trcRing[trcRingSize];														// records back to back, wrapping around
+static uint8_t tHead;																		// next byte to write
+static uint8_t tTail;																		// first byte of the oldest record
+static uint8_t tUsed;																		// bytes in the ring
+
+static inline void trcPut(uint8_t b) {
+	trcRing[tHead] = b;
+	if (++tHead >= trcRingSize) tHead = 0;
+}
+
+// public:		//---------------------------------------------------------------------------------------------------------
+void    trcEvent(uint8_t evt, uint8_t arg, uint8_t *data, uint8_t len) {
+	// records are only written from the main loop, so there is nothing to lock. a record which doesn't fit is dropped,
+	// the older ones are kept
+	uint16_t rec = TRC_REC_HDR + len;
+	if (rec > (uint16_t)(trcRingSize - tUsed)) {
+		trcStat.drop++;
+		return;
+	}
+
+	tMillis t = getMillis();
+	trcPut(TRC_SYNC);
+	trcPut(evt);
+	trcPut(arg);
+	trcPut(t); trcPut(t >> 8); trcPut(t >> 16); trcPut(t >> 24);
+	trcPut(len);
+	for (uint8_t i = 0; i < len; i++) trcPut(data[i]);
+
+	tUsed += rec;
+	trcStat.recs++;
+	if (tUsed > trcStat.fillMax) trcStat.fillMax = tUsed;
+}
+void    trcFrame(uint8_t evt, uint8_t arg, uint8_t *buf, uint8_t lvl) {
+	uint8_t len = buf[0] + 1;
+	if ((lvl < 2) && (len > TRC_HDR)) len = TRC_HDR;										// header only, the length byte tells what is missing
+	trcEvent(evt, arg, buf, len);
+}
+uint8_t trcPoll(void) {
+	// hands over as many bytes as the uart takes without waiting, like that the main loop is never blocked by the trace.
+	// the rest waits in the ring for the next idle loop
+	if (!tUsed) return 0;
+
+	uint8_t n = dbgRoom();
+	if (n > tUsed) n = tUsed;
+	while (n) {
+		uint8_t seg = ((uint16_t)tTail + n > trcRingSize) ? trcRingSize - tTail : n;		// up to the end of the ring
+		dbgWrite(trcRing + tTail, seg);
+		tTail += seg;
+		if (tTail >= trcRingSize) tTail = 0;
+		tUsed -= seg;
+		n -= seg;
+	}
+	return tUsed ? 1 : 0;
+}
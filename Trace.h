@@ -0,0 +1,50 @@
+//- -----------------------------------------------------------------------------------------------------------------------
+// AskSin driver implementation
+// 2013-08-03 <trilu@gmx.de> Creative Commons - http://creativecommons.org/licenses/by-nc-sa/3.0/de/
+//- -----------------------------------------------------------------------------------------------------------------------
+//- AskSin trace functions ------------------------------------------------------------------------------------------------
+//- the frame debugs of the rx and tx path are stored as small binary records in a ring, the ring drains to the serial port
+//- only while the main loop is idle and only as much as the uart takes without waiting. examples/HOST_Linux/HOST_Trace
+//- turns the serial output back into the text of the debug messages.
+//- every module has its own level, set before the includes like the XX_DBG flags:
+//-   #define RV_TRC 2	0 or not defined - off, 1 - frames shortened to the header (TRC_HDR bytes), 2 - whole frames
+//- -----------------------------------------------------------------------------------------------------------------------
+
+#ifndef _TR_H
+#define _TR_H
+
+#include "HAL.h"
+
+#ifndef trcRingSize
+	#define trcRingSize 128						// bytes for trace records, 255 at most. a frame takes 8 bytes plus the frame
+#endif
+
+#define TRC_SYNC      0xA6						// start of a record, followed by event, arg, time (4 byte, lsb first),
+												// length and the data
+#define TRC_REC_HDR   8							// bytes in front of the data
+#define TRC_HDR       11						// frame bytes kept by level 1, length byte up to by10
+
+enum trcEvents {								// events and the debug text they stand for
+	TRC_RV_FRAME = 1,							// "x> frame (time)", arg holds the intend
+	TRC_RV_REPEAT,								// "  repeated message"
+	TRC_SN_DROP,								// "<x frame (time)", send queue full or frame too long
+	TRC_SN_INT,									// "<i frame (time)", internal message
+	TRC_SN_TX,									// "<- frame (time)"
+	TRC_SN_TOUT,								// "  timed out (time)"
+	TRC_AS_PEER,								// "a: curIdx m maxIdx", data holds both
+	TRC_AS_SLICE,								// "cnl: x s: idx" and "totSlc: n", data holds all three
+	TRC_AS_AES,									// "aes: ok" or "aes: failed", arg holds the result of the check
+};
+
+struct s_trcStat {
+	uint16_t recs;								// records written into the ring
+	uint16_t drop;								// records dropped because the ring was full
+	uint8_t  fillMax;							// highest fill level of the ring in bytes
+};
+extern s_trcStat trcStat;
+
+extern void    trcEvent(uint8_t evt, uint8_t arg, uint8_t *data, uint8_t len);	// store a record, never waits
+extern void    trcFrame(uint8_t evt, uint8_t arg, uint8_t *buf, uint8_t lvl);	// store a frame, shortened to TRC_HDR on level 1
+extern uint8_t trcPoll(void);													// hand bytes to the uart, 1 while some are left
+
+#endif
@@ -0,0 +1,217 @@
+//- -----------------------------------------------------------------------------------------------------------------------
+// AskSin driver implementation
+// 2013-08-03 <trilu@gmx.de> Creative Commons - http://creativecommons.org/licenses/by-nc-sa/3.0/de/
+//- -----------------------------------------------------------------------------------------------------------------------
+//- AskSin actor state machine --------------------------------------------------------------------------------------------
+//- the list3 jump table state machine {no=>0, dlyOn=>1, rampOn=>2, on=>3, dlyOff=>4, rampOff=>5, off=>6} together with
+//- the peer triggers and the status messages, shared by cmSwitch, cmDimmer and cmBlind. a module derives from
+//- cmActor<module>, the state machine reaches the members of the module at compile time, so there is no virtual call
+//- and every module gets its own copy with only the states it has.
+//- the module brings:
+//-   lstCnl, lstPeer with lgMultiExec and s_l3 *l3 with ctValLo, ctValHi, onDly, onTime, offDly, offTime, actionType
+//-   and the condition and jump table nibbles at the register addresses 0x01 to 0x03 and 0x0b to 0x0d
+//-   setStat, the status which is set on the output right now
+//-   hmEventCol, the call back for the AS registrar
+//- traits, a module redefines them in its own class:
+//-   fsmL3Reg  - register address of the first byte of s_l3
+//-   fsmRamp   - the module has the states rampOn and rampOff, its status reports the direction UP or DOWN
+//- hooks, a module hides them with its own version:
+//-   fsmStop   - a peer trigger arrived, stop what runs
+//-   fsmAction - action types besides jmpToTarget
+//-   fsmEnter  - the state machine goes into a new state, before the delay and duration timers are set
+//-   fsmRampTo - rampOn or rampOff, 1 if the ramp is done
+//-   fsmNext   - ms until the module has work of its own besides the state machine and the status, 0 for now
+//- -----------------------------------------------------------------------------------------------------------------------
+
+#ifndef _cmActor_H
+#define _cmActor_H
+
+#include "AS.h"
+#include "HAL.h"
+
+//#define AC_DBG																			// debug message flag
+
+template <class T> class cmActor {
+  protected://-------------------------------------------------------------------------------------------------------------
+	enum { fsmL3Reg = 1 };																	// s_l3 starts with register 0x01
+	enum { fsmRamp  = 0 };																	// no rampOn and rampOff states
+
+	uint8_t   cnt;																			// message counter for type 40 message
+	uint8_t   curStat:4, nxtStat:4;															// current state and next state
+	uint8_t   sendStat :2;																	// is there a status to be send, 1 indicates an ACK, 2 a status message
+	uint16_t  msgDelay;																		// delay for the next status message while the status changes
+	waitTimer msgTmr;																		// message timer for sending status
+	waitTimer delayTmr;																		// delay timer for on, off, delay and ramp time
+
+	T        *self(void) { return static_cast<T*>(this); }
+
+	// - jump table ------------------------------------
+	// dly, ramp and on have their condition in register 0x02, 0x01, 0x03 and the jump target in 0x0c, 0x0d, 0x0b, the
+	// low nibble for the on side, the high nibble for the off side
+	uint8_t   fsmHas(uint8_t stat) {															// 1 if the module has the state
+		return (stat) && (stat <= 6) && ((T::fsmRamp) || ((stat != 2) && (stat != 5)));
+	}
+	uint8_t  *fsmReg(uint8_t stat, uint8_t jt) {											// register of the jump target or the condition
+		uint8_t k = (stat > 3) ? stat - 3 : stat;											// 1 dly, 2 ramp, 3 on
+		if (k == 3) k = 0;
+		return (uint8_t*)self()->l3 + ((jt) ? 0x0b + k : 0x03 - k) - T::fsmL3Reg;
+	}
+	uint8_t   fsmJt(uint8_t stat) {																// jump target of the state
+		uint8_t x = *fsmReg(stat, 1);
+		return (stat > 3) ? x >> 4 : x & 0x0f;
+	}
+	void      fsmSetJt(uint8_t stat, uint8_t val) {												// refill the jump table, only in RAM
+		uint8_t *x = fsmReg(stat, 1);
+		*x = (stat > 3) ? (*x & 0x0f) | (val << 4) : (*x & 0xf0) | val;
+	}
+	uint8_t   fsmCt(uint8_t stat) {																// condition of the state, 0xff if there is none
+		if (!fsmHas(stat)) return 0xff;
+		uint8_t x = *fsmReg(stat, 0);
+		return (stat > 3) ? x >> 4 : x & 0x0f;
+	}
+
+	// - default hooks ---------------------------------
+	void      fsmStop(void) {}
+	void      fsmAction(uint8_t type, uint8_t msgCnt) {}
+	void      fsmEnter(uint8_t stat) {}
+	uint8_t   fsmRampTo(uint8_t stat) { return 1; }
+	uint32_t  fsmNext(void) { return 0xffffffff; }
+
+	// - scheduling ------------------------------------
+	// ms until the module needs its next poll, 0xffffffff if only an event brings new work, see RG::setDue()
+	uint32_t  fsmDue(void) {
+		uint32_t due = self()->fsmNext(), x;
+		if (sendStat) {																		// status waits for msgTmr
+			x = msgTmr.remain();
+			if (x < due) due = x;
+		}
+		if (delayTmr.running()) {															// delay, on or off time, the ramp
+			x = delayTmr.remain();
+			if (x < due) due = x;
+		} else if ((self()->l3->actionType == 1) && (curStat != nxtStat) && (fsmHas(nxtStat))) {
+			due = 0;																		// next state right now
+		}
+		return due;
+	}
+
+	void      sendStatus(void) {
+		if (!sendStat) return;																// nothing to do
+		if (!msgTmr.done()) return;															// not the right time
+
+		// prepare message; UP 0x10, DOWN 0x20, ERROR 0x30, DELAY 0x40, LOWBAT 0x80. a module without ramp has no direction
+		if      (modStat == self()->setStat)                   modDUL  = 0;
+		else if ((T::fsmRamp) && (modStat < self()->setStat))  modDUL  = 0x10;
+		else if ((T::fsmRamp) && (modStat > self()->setStat))  modDUL  = 0x20;
+		if (!delayTmr.done() )                                 modDUL |= 0x40;
+
+		// check which type has to be send - if it is an ACK and modDUL != 0, then set timer for sending a actuator status
+		if      (sendStat == 1) hm->sendACK_STATUS(regCnl, modStat, modDUL);				// send ACK
+		else if (sendStat == 2) hm->sendINFO_ACTUATOR_STATUS(regCnl, modStat, modDUL);		// send status
+
+		// check if it is a stable status, otherwise schedule next info message. without ramp only the delay changes it
+		if ((modDUL >= 0x40) || ((modDUL) && (!T::fsmRamp))) {								// status is currently changing
+			sendStat = 2;																	// send next time a info status message
+			msgTmr.set(delayTmr.remain()+5);
+
+		} else if (modDUL) {
+			sendStat = 2;																	// send next time a info status message
+			msgTmr.set(msgDelay);
+
+		} else sendStat = 0;																// no need for next time
+	}
+
+	void      fsmPoll(void) {
+		// - jump table section, only
+		if (self()->l3->actionType != 1) return;											// only valid for jump table
+		if (curStat == nxtStat) return;														// no status change expected
+		uint8_t stat = nxtStat;
+		if (!fsmHas(stat)) return;															// no target
+
+		#ifdef AC_DBG
+		dbg << F("AC:") << regCnl << F(" state ") << curStat << F(" > ") << stat << '\n';
+		#endif
+
+		self()->fsmEnter(stat);
+
+		if ((stat == 2) || (stat == 5)) {		// rampOn, rampOff
+			if (!self()->fsmRampTo(stat)) return;											// wait until the ramp is done
+			curStat = stat;
+			nxtStat = fsmJt(stat);
+			return;
+		}
+		curStat = stat;																		// remember current status
+
+		if ((stat == 1) || (stat == 4)) {		// dlyOn, dlyOff
+			nxtStat = fsmJt(stat);															// get next status from jump table
+			uint8_t dly = (stat == 1) ? self()->l3->onDly : self()->l3->offDly;
+			if (dly) delayTmr.set(byteTimeCvt(dly));										// activate the timer for the delay
+			return;
+		}
+
+		// on, off - we stay here unless the on or off time is set, then we go to the other side and stay there
+		uint8_t tme = (stat == 3) ? self()->l3->onTime : self()->l3->offTime;
+		if ((!tme) || (tme == 255)) return;
+		delayTmr.set(byteTimeCvt(tme));														// activate the timer and set next status
+
+		uint8_t end = (stat == 3) ? 6 : 3;
+		if (T::fsmRamp) {																	// via rampOff or rampOn
+			nxtStat = end - 1;
+			fsmSetJt(end - 1, end);
+		} else nxtStat = end;
+		fsmSetJt(end, end);																	// stay in off or on mode
+	}
+
+  public://----------------------------------------------------------------------------------------------------------------
+	void      trigger40(uint8_t msgLng, uint8_t msgCnt) {									// messages coming from switch
+		// some sanity
+		delayTmr.set(0);																	// delay timer is not needed any more
+		self()->fsmStop();
+
+		// check for multi execute flag
+		if (( msgLng) && (!self()->lstPeer.lgMultiExec) && (cnt == msgCnt)) return;		// trigger was long, but we have no multi execute
+		cnt = msgCnt;																		// remember message counter
+
+		// set short or long
+		self()->l3 = (msgLng) ? (typename T::s_l3*)&self()->lstPeer+1 : (typename T::s_l3*)&self()->lstPeer;
+
+		// check against action type
+		if (self()->l3->actionType == 1) {		// jmpToTarget
+			if (fsmHas(curStat)) nxtStat = fsmJt(curStat);
+			delayTmr.set(0);																// set timer to 0 for avoiding delays
+
+		} else self()->fsmAction(self()->l3->actionType, msgCnt);
+	}
+	void      trigger41(uint8_t msgBLL, uint8_t msgCnt, uint8_t msgVal) {					// messages coming from sensor
+		uint8_t isLng = (msgBLL & 0x40)?1:0;												// is it a long message?
+
+		// set short or long
+		self()->l3 = (isLng) ? (typename T::s_l3*)&self()->lstPeer+1 : (typename T::s_l3*)&self()->lstPeer;
+		uint8_t lo = self()->l3->ctValLo, hi = self()->l3->ctValHi, hit;
+
+		switch (fsmCt(curStat)) {
+			case 0:  hit = (msgVal >= lo);                     break;						// geLo - X GE COND_VALUE_LO
+			case 1:  hit = (msgVal >= hi);                     break;						// geHi - X GE COND_VALUE_HI
+			case 2:  hit = (msgVal <  lo);                     break;						// ltLo - X LT COND_VALUE_LO
+			case 3:  hit = (msgVal <  hi);                     break;						// ltHi - X LT COND_VALUE_HI
+			case 4:  hit = (msgVal >= lo) && (msgVal <  hi);   break;						// betW - COND_VALUE_LO LE X LT COND_VALUE_HIGH
+			case 5:  hit = (msgVal <  lo) || (msgVal >= hi);   break;						// outS - X LT COND_VALUE_LO OR X GE COND_VALUE_HIGH
+			default: hit = 0;
+		}
+		if (hit) trigger40(isLng, msgCnt);
+	}
+
+  //- mandatory functions for every new module to communicate within AS protocol stack ------------------------------------
+	uint8_t   modStat;																		// module status byte, needed for list3 modules to answer status requests
+	uint8_t   modDUL;																		// module down up low battery byte
+	uint8_t   regCnl;																		// holds the channel for the module
+
+	AS       *hm;																			// pointer to HM class instance
+
+	void      regInHM(uint8_t cnl, uint8_t lst, AS *instPtr) {								// register this module in HM on the specific channel
+		hm = instPtr;																		// set pointer to the HM module
+		regCnl = cnl;																		// stores the channel we are responsible fore
+		hm->rg.regInAS(cnl, lst, s_mod_dlgt(self(), &T::hmEventCol), (uint8_t*)&self()->lstCnl, (uint8_t*)&self()->lstPeer);
+	}
+};
+
+#endif
@@ -28,6 +28,9 @@ void cmBlind::config(void Init(uint8_t), void Switch(uint8_t, uint8_t)) {
 	// send the initial status info
 	sendStat = 2;
 	msgTmr.set(msgDelay);
+
+	l3 = (s_l3*)&lstPeer;																	// set pointer to something useful
+	l3->actionType = 0;																		// and secure that no action will happened in polling function
 }
 
 void cmBlind::trigger11(uint8_t setValue, uint8_t *rampTime, uint8_t *duraTime) {
@@ -63,34 +66,15 @@ void cmBlind::trigger11(uint8_t setValue, uint8_t *rampTime, uint8_t *duraTime)
 	dbg << F("RL:trigger11, val:") << setValue << F(", rampT:") << intTimeCvt(rampTme) << F(", duraT:") << intTimeCvt(duraTme) << '\n';
 }
 
-void cmBlind::trigger40(uint8_t msgLng, uint8_t msgCnt) {
-	// some sanity
+void cmBlind::fsmStop(void) {
 	activeOffDlyBlink = 0;																	// got a new key press, off delay blink is not needed
-	delayTmr.set(0);																		// also delay timer is not needed any more
-	
-	// check for multi execute flag
-	if (( msgLng) && (!lstPeer.lgMultiExec) && (cnt == msgCnt)) return;						// trigger was long, but we have no multi execute
-	cnt = msgCnt;																			// remember message counter
-
-	// set short or long
-	l3 = (msgLng)?(s_l3*)&lstPeer+1 :(s_l3*)&lstPeer;
-
-
-	// check against action type	
-	if        (l3->actionType == 0) {		// off
-
-	} else if (l3->actionType == 1) {		// jmpToTarget
+}
+void cmBlind::fsmAction(uint8_t type, uint8_t msgCnt) {
 
-		// SwJtOn {no=>0, dlyOn=>1, rampOn=>2, on=>3, dlyOff=>4, rampOff=>5, off=>6}
-		if      (curStat == 1) nxtStat = l3->jtDlyOn;										// delay on
-		else if (curStat == 2) nxtStat = l3->jtRampOn;										// ramp on
-		else if (curStat == 3) nxtStat = l3->jtOn;											// on
-		else if (curStat == 4) nxtStat = l3->jtDlyOff;										// delay off
-		else if (curStat == 5) nxtStat = l3->jtRampOff;										// ramp off
-		else if (curStat == 6) nxtStat = l3->jtOff;											// currently off
-		delayTmr.set(0);																	// set timer to 0 for avoiding delays
+	// check against action type, jmpToTarget is done by cmActor
+	if        (type == 0) {		// off
 
-	} else if (l3->actionType == 2) {		// toogleToCounter
+	} else if (type == 2) {		// toogleToCounter
 		l3->actionType = 0;
 
 		if (msgCnt%2) {
@@ -103,7 +87,7 @@ void cmBlind::trigger40(uint8_t msgLng, uint8_t msgCnt) {
 			
 		}
 		
-	} else if (l3->actionType == 3) {		// toogleInversToCounter
+	} else if (type == 3) {		// toogleInversToCounter
 		l3->actionType = 0;
 
 		if (msgCnt%2) {
@@ -117,7 +101,7 @@ void cmBlind::trigger40(uint8_t msgLng, uint8_t msgCnt) {
 		}
 
 
-	} else if (l3->actionType == 4) {		// upDim
+	} else if (type == 4) {		// upDim
 		upDim();
 
 		if ((l3->onTime) && (l3->onTime != 255)) {											// check onTimer, if set then set jump table accordingly
@@ -125,17 +109,17 @@ void cmBlind::trigger40(uint8_t msgLng, uint8_t msgCnt) {
 		} else l3->actionType = 0;
 
 
-	} else if (l3->actionType == 5) {		// downDim
+	} else if (type == 5) {		// downDim
 		downDim();
 		l3->actionType = 0;
 
 		
-	} else if (l3->actionType == 6) {		// toogleDim
+	} else if (type == 6) {		// toogleDim
 		toggleDim();																		// jump into toggle dim function, direction is given there
 		l3->actionType = 0;																	// no further action required
 
 
-	} else if (l3->actionType == 7) {		// toogleDimToCounter
+	} else if (type == 7) {		// toogleDimToCounter
 		// check for even or odd, if even set onMinLvl 
 		if (msgCnt % 2) {																	// odd - blind on
 
@@ -156,7 +140,7 @@ void cmBlind::trigger40(uint8_t msgLng, uint8_t msgCnt) {
 		}
 
 		
-	} else if (l3->actionType == 8) {		// toogleDimInversToCounter
+	} else if (type == 8) {		// toogleDimInversToCounter
 		// same as 7, but changed order
 		if (msgCnt % 2) {																	// odd - blind off
 
@@ -182,40 +166,6 @@ void cmBlind::trigger40(uint8_t msgLng, uint8_t msgCnt) {
 //	dbg << "a: " << l3->actionType << ", c: " << curStat << ", n: " << nxtStat << '\n';	// some debug again
 }
 
-void cmBlind::trigger41(uint8_t msgBLL, uint8_t msgCnt, uint8_t msgVal) {
-	uint8_t isLng = (msgBLL & 0x40)?1:0;													// is it a long message?
-	uint8_t ctTbl;
-
-	// set short or long
-	l3 = (isLng)?(s_l3*)&lstPeer+1 :(s_l3*)&lstPeer;										// set pointer to the right part of the list3, short or long
-
-	
-	// SwJtOn {no=>0, dlyOn=>1, rampOn=>2, on=>3, dlyOff=>4, rampOff=>5, off=>6}
-	if      (curStat == 1) ctTbl = l3->ctDlyOn;												// delay on
-	else if (curStat == 2) ctTbl = l3->ctRampOn;											// ramp on
-	else if (curStat == 3) ctTbl = l3->ctOn;												// on
-	else if (curStat == 4) ctTbl = l3->ctDlyOff;											// delay off
-	else if (curStat == 5) ctTbl = l3->ctRampOff;											// ramp off
-	else if (curStat == 6) ctTbl = l3->ctOff;												// currently off
-	
-	// X GE COND_VALUE_LO                         - geLo -  > low           - 0
-	// X GE COND_VALUE_HI                         - geHi -  > high          - 1
-	// X LT COND_VALUE_LO                         - ltLo -  < low           - 2
-	// X LT COND_VALUE_HI                         - ltHi -  < high          - 3
-	// COND_VALUE_LO LE X LT COND_VALUE_HIGH      - betW -  low <> high     - 4
-	// X LT COND_VALUE_LO OR X GE COND_VALUE_HIGH - outS -  < low or > high - 5
-
-	//dbg << "curStat: " << curStat  << ", isLng: " << isLng << ", val: " << msgVal  << ", cond: " << ctTbl << '\n';
-
-	if      (ctTbl == 0) if (msgVal > l3->ctValLo) trigger40(isLng, msgCnt);
-	else if (ctTbl == 1) if (msgVal > l3->ctValHi) trigger40(isLng, msgCnt);
-	else if (ctTbl == 2) if (msgVal < l3->ctValLo) trigger40(isLng, msgCnt);
-	else if (ctTbl == 3) if (msgVal < l3->ctValHi) trigger40(isLng, msgCnt);
-	else if (ctTbl == 4) if ((msgVal > l3->ctValLo) && (msgVal < l3->ctValHi)) trigger40(isLng, msgCnt);
-	else if (ctTbl == 5) if ((msgVal < l3->ctValLo) && (msgVal > l3->ctValHi)) trigger40(isLng, msgCnt);
-
-}
-
 void cmBlind::toggleDim(void) {
 	dbg << F("toggleDim") << '\n';
 
@@ -279,33 +229,6 @@ void cmBlind::adjPWM(void) {
 	adjTmr.set(adjDlyPWM);																	// set timer for next action
 }
 
-void cmBlind::sendStatus(void) {
-
-	if (!sendStat) return;																	// nothing to do
-	if (!msgTmr.done()) return;																// not the right time
-		
-	// prepare message; UP 0x10, DOWN 0x20, ERROR 0x30, DELAY 0x40, LOWBAT �0x80�
-	if      (modStat == setStat) modDUL  = 0;
-	else if (modStat <  setStat) modDUL  = 0x10;
-	else if (modStat >  setStat) modDUL  = 0x20;
-	if (!delayTmr.done() )       modDUL |= 0x40;
-		
-	// check which type has to be send - if it is an ACK and modDUL != 0, then set timer for sending a actuator status
-	if      (sendStat == 1) hm->sendACK_STATUS(regCnl, modStat, modDUL);					// send ACK
-	else if (sendStat == 2) hm->sendINFO_ACTUATOR_STATUS(regCnl, modStat, modDUL);			// send status
-
-	// check if it is a stable status, otherwise schedule next info message
-	if (modDUL >= 0x40) {																	// status is currently changing
-		sendStat = 2;																		// send next time a info status message
-		msgTmr.set(delayTmr.remain()+5);
-
-	} else if (modDUL) {
-		sendStat = 2;																		// send next time a info status message
-		msgTmr.set(msgDelay);
-
-	} else sendStat = 0;																	// no need for next time
-}
-
 void cmBlind::poll(void) {
 	
 	adjPWM();																				// check if something is to be set on the PWM channel
@@ -330,112 +253,22 @@ void cmBlind::poll(void) {
 		rampTme = duraTme = 0;																// no further action required
 	}
 	
-	// - jump table section, only
-	if (l3->actionType != 1) return;														// only valid for jump table
-	if (curStat == nxtStat) return;															// no status change expected
-	activeOffDlyBlink = 0;	
-
-	// check the different status changes, {no=>0, dlyOn=>1, rampOn=>2, on=>3, dlyOff=>4, rampOff=>5, off=>6}
-	if        (nxtStat == 1) {		// dlyOn
-		#ifdef BL_DBG
-		dbg << F("dlyOn\n");
-		#endif 
-		
-		curStat = nxtStat;																	// remember current status
-		nxtStat = l3->jtDlyOn;																// get next status from jump table
-		
-		if (l3->onDly) {																	// check if there is something in the duration timer, set next status accordingly
-			delayTmr.set(byteTimeCvt(l3->onDly));											// activate the timer and set next status
-		}
-		
-
-	} else if (nxtStat == 2) {		// rampOn
-		#ifdef BL_DBG
-		dbg << F("rampOn\n");
-		#endif
-		
-		// check modStat against onLevel, if not compare, set the right values
-		if (modStat != l3->onLevel)	{														// modStat not set, so first time
-			modStat	= l3->onLevel;															// set module status accordingly settings
-			adjDlyPWM = byteTimeCvt(l3->rampOnTime);										// get the ramp on time
-			delayTmr.set(adjDlyPWM);														// set the ramp time to poll delay, otherwise we will every time end here
-			adjDlyPWM /= 200;																// break down the ramp time to smaller slices for adjusting PWM
-		}
-		
-		// check if ramp on is done, set next status
-		if (modStat == setStat) {															// ramp on is done
-			curStat = nxtStat;																// set current status accordingly
-			nxtStat = l3->jtRampOn;															// set next status accordingly the jump table
-		}
-
-		
-	} else if (nxtStat == 3) {		// on
-		#ifdef BL_DBG
-		dbg << F("on\n");
-		#endif
-		
-		curStat = nxtStat;																	// remember current status, when timer not set, we stay here for ever
-		
-		if ((l3->onTime) && (l3->onTime != 255)) {											// check if there is something in the duration timer, set next status accordingly
-			delayTmr.set(byteTimeCvt(l3->onTime));											// activate the timer and set next status
-
-			// nxtStat = l3->jtOn; seems to be wrong here, because original device goes to rampOff and stays in off, so refill jumptable
-			nxtStat = 5;																	// go to ramp off
-			l3->jtRampOff = 6;																// jump from rampOff to off
-			l3->jtOff = 6;																	// stay in off mode
-		} //else nxtStat = l3->jtOn;														// not sure in which scenario it is needed
-
-
-	} else if (nxtStat == 4) {		// dlyOff
-		#ifdef BL_DBG
-		dbg << F("dlyOff\n");
-		#endif
-
-		curStat = nxtStat;																	// remember current status
-		nxtStat = l3->jtDlyOff;																// get jump table for next status
-
-		if (l3->offDly) {																	// check if there is something in the duration timer, set next status accordingly
-			delayTmr.set(byteTimeCvt(l3->offDly));											// activate the timer and set next status
-			if (l3->offDlyBlink) activeOffDlyBlink = 1;
-		}
-
-
-	} else if (nxtStat == 5) {		// rampOff
-		#ifdef BL_DBG
-		dbg << F("rampOff\n");
-		#endif
-		
-		// check modStat against offLevel, if not similar, set the right values
-		if (modStat != l3->offLevel) {														// check for first time and set the correct values
-			modStat	= l3->offLevel;															// set the PWM to the right value
-			adjDlyPWM = byteTimeCvt(l3->rampOffTime);										// get the ramp off time
-			delayTmr.set(adjDlyPWM);														// set ramp off time to the poll timer, other wise we will check every ms again
-			adjDlyPWM /= 200;																// split PWN timer to slices for smooth dimming
-		}
-		
-		// check if ramp on is done, set next status
-		if (modStat == setStat) {															// check if ramp off is done
-			curStat = nxtStat;																// remember the current status
-			nxtStat = l3->jtRampOff;														// get the next status from jump table
-		}
-
-
-	} else if (nxtStat == 6) {		// off
-		#ifdef BL_DBG
-		dbg << F("off\n");
-		#endif
-
-		curStat = nxtStat;																	// remember the current status
-		//nxtStat = l3->jtOff;																// get the next status from jump table
-
-		if ((l3->offTime) && (l3->offTime != 255)) {										// check if there is something in the duration timer, set next status accordingly
-			delayTmr.set(byteTimeCvt(l3->offTime));											// activate the timer and set next status
-			// refill jumptable
-
-		}
-
+	fsmPoll();																				// jump table section
+}
+void cmBlind::fsmEnter(uint8_t stat) {
+	activeOffDlyBlink = 0;																	// a new state ends the blinking
+	if ((stat == 4) && (l3->offDly) && (l3->offDlyBlink)) activeOffDlyBlink = 1;			// dlyOff with blinking led
+}
+uint8_t cmBlind::fsmRampTo(uint8_t stat) {
+	// check modStat against onLevel or offLevel, if not compare, set the right values
+	uint8_t lvl = (stat == 2) ? l3->onLevel : l3->offLevel;
+	if (modStat != lvl) {																	// modStat not set, so first time
+		modStat = lvl;																		// set module status accordingly settings
+		adjDlyPWM = byteTimeCvt((stat == 2) ? l3->rampOnTime : l3->rampOffTime);			// get the ramp time
+		delayTmr.set(adjDlyPWM);															// set the ramp time to poll delay, otherwise we will every time end here
+		adjDlyPWM /= 200;																	// break down the ramp time to smaller slices for adjusting PWM
 	}
-
+	return (modStat == setStat);															// ramp is done
 }
 
   //- helpers defined functions -------------------------------------------------------------------------------------------
@@ -552,11 +385,6 @@ void cmBlind::peerMsgEvent(uint8_t type, uint8_t *data, uint8_t len) {
 //-------------------------------------------------------------------------------------------------------------------------
 //- predefined, no reason to touch -
 //-------------------------------------------------------------------------------------------------------------------------
-void cmBlind::regInHM(uint8_t cnl, uint8_t lst, AS *instPtr) {
-	hm = instPtr;																			// set pointer to the HM module
-	hm->rg.regInAS(cnl, lst, s_mod_dlgt(this,&cmBlind::hmEventCol), (uint8_t*)&lstCnl,(uint8_t*)&lstPeer);
-	regCnl = cnl;																			// stores the channel we are responsible fore
-}
 void cmBlind::hmEventCol(uint8_t by3, uint8_t by10, uint8_t by11, uint8_t *data, uint8_t len) {
 	// dbg << "by3:" << by3 << " by10:" << by10 << " d:" << pHex(data, len) << '\n'; _delay_ms(100);
 	if      ((by3 == 0x00) && (by10 == 0x00)) poll();
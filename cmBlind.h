@@ -11,6 +11,7 @@
 
 #include "AS.h"
 #include "HAL.h"
+#include "cmActor.h"
 
 // default settings for list3 or list4
 
@@ -64,7 +65,9 @@ const uint8_t peerSingle[] = {
 };
 
 
-class cmBlind {
+class cmBlind : public cmActor<cmBlind> {
+	friend class cmActor<cmBlind>;
+
   //- user code here ------------------------------------------------------------------------------------------------------
   public://----------------------------------------------------------------------------------------------------------------
   protected://-------------------------------------------------------------------------------------------------------------
@@ -244,11 +247,6 @@ class cmBlind {
 	void (*fInit)(uint8_t);																	// pointer to init function in main sketch
 	void (*fSwitch)(uint8_t, uint8_t);														// pointer to switch function (PWM) in main sketch, first value is PWM level, second the characteristics
 	
-	uint8_t   sendStat :2;																	// is there a status to be send, 1 indicates an ACK, 2 a status message 
-	uint16_t  msgDelay;
-	waitTimer msgTmr;																		// message timer for sending status
-
-	waitTimer delayTmr;																		// delay timer for on,off and delay time
 	uint16_t  rampTme, duraTme;																// time store for trigger 11
 
 	uint8_t   setStat;																		// status to set on the PWM channel
@@ -261,17 +259,12 @@ class cmBlind {
 	uint8_t   statusOffDlyBlink :1;															// remember led off cycle
 	uint8_t   directionDim :1;																// used in toogleDim function
 
-	uint8_t   cnt;																			// message counter for type 40 message
-	uint8_t   curStat:4, nxtStat:4;															// current state and next state
-
   public://----------------------------------------------------------------------------------------------------------------
   //- user defined functions ----------------------------------------------------------------------------------------------
 
 	void     config(void Init(uint8_t), void Switch(uint8_t, uint8_t));						// configures the module, jump addresses, etc
 
 	void     trigger11(uint8_t setValue, uint8_t *rampTime, uint8_t *duraTime);				// messages coming from master
-	void     trigger40(uint8_t msgLng, uint8_t msgCnt);										// messages coming from switch
-	void     trigger41(uint8_t msgBLL, uint8_t msgCnt, uint8_t msgVal);						// messages coming from sensor
 
   private://---------------------------------------------------------------------------------------------------------------
 	void     toggleDim(void);																// dim up or down with one key
@@ -279,8 +272,13 @@ class cmBlind {
 	void     downDim(void);																	// down dim procedure
 
 	void     adjPWM(void);																	// adjusts PWM value in a regular manner
-	void     sendStatus(void);																// send status function
 	void     poll(void);																	// blind polling function
+
+	enum { fsmRamp = 1 };																	// the motor runs in rampOn and rampOff
+	void     fsmStop(void);																	// hooks of the state machine, see cmActor.h
+	void     fsmAction(uint8_t type, uint8_t msgCnt);
+	void     fsmEnter(uint8_t stat);
+	uint8_t  fsmRampTo(uint8_t stat);
 	
   //- helpers defined functions -------------------------------------------------------------------------------------------
 	void     showStruct(void);
@@ -288,12 +286,6 @@ class cmBlind {
 	
   public://----------------------------------------------------------------------------------------------------------------
   //- mandatory functions for every new module to communicate within AS protocol stack ------------------------------------
-	uint8_t  modStat;																		// module status byte, needed for list3 modules to answer status requests
-	uint8_t  modDUL;																		// module down up low battery byte
-	uint8_t  regCnl;																		// holds the channel for the module
-
-	AS       *hm;																			// pointer to HM class instance
-
 	void     setToggle(void);																// toggle the module initiated by config button
 	void     configCngEvent(void);															// list1 on registered channel had changed
 	void     pairSetEvent(uint8_t *data, uint8_t len);										// pair message to specific channel, handover information for value, ramp time and so on
@@ -301,7 +293,6 @@ class cmBlind {
 	void     peerMsgEvent(uint8_t type, uint8_t *data, uint8_t len);						// peer message was received on the registered channel, handover the message bytes and length
 
 	//- predefined, no reason to touch ------------------------------------------------------------------------------------
-	void     regInHM(uint8_t cnl, uint8_t lst, AS *instPtr);								// register this module in HM on the specific channel
 	void     hmEventCol(uint8_t by3, uint8_t by10, uint8_t by11, uint8_t *data, uint8_t len);// call back address for HM for informing on events
 	void     peerAddEvent(uint8_t *data, uint8_t len);										// peer was added to the specific channel, 1st and 2nd byte shows peer channel, third and fourth byte shows peer index
 	void     firstStart(void);																// first start detection, to write list1
@@ -9,6 +9,30 @@
 //#define DI_DBG																			// debug message flag
 #include "cmDimmer.h"
 
+// quadratic characteristic, 16 bit PWM value of the status 0 to 200, x*x*65535/40000. the ramp interpolates between two
+// entries with the fraction of its 8.8 level
+static const uint16_t dimCurve[201] PROGMEM = {
+	0x0000,0x0001,0x0006,0x000e,0x001a,0x0028,0x003a,0x0050,0x0068,0x0084,0x00a3,0x00c6,
+	0x00eb,0x0114,0x0141,0x0170,0x01a3,0x01d9,0x0212,0x024f,0x028f,0x02d2,0x0318,0x0362,
+	0x03af,0x03ff,0x0453,0x04aa,0x0504,0x0561,0x05c2,0x0626,0x068d,0x06f8,0x0765,0x07d7,
+	0x084b,0x08c2,0x093d,0x09bb,0x0a3d,0x0ac2,0x0b4a,0x0bd5,0x0c63,0x0cf5,0x0d8a,0x0e23,
+	0x0ebe,0x0f5d,0x0fff,0x10a5,0x114e,0x11fa,0x12a9,0x135c,0x1411,0x14cb,0x1587,0x1647,
+	0x170a,0x17d0,0x1899,0x1966,0x1a36,0x1b0a,0x1be0,0x1cba,0x1d97,0x1e78,0x1f5c,0x2043,
+	0x212d,0x221a,0x230b,0x23ff,0x24f7,0x25f1,0x26ef,0x27f1,0x28f5,0x29fd,0x2b08,0x2c16,
+	0x2d28,0x2e3d,0x2f55,0x3070,0x318f,0x32b1,0x33d6,0x34ff,0x362b,0x375a,0x388c,0x39c2,
+	0x3afb,0x3c37,0x3d76,0x3eb9,0x3fff,0x4149,0x4295,0x43e5,0x4538,0x468f,0x47e8,0x4945,
+	0x4aa6,0x4c09,0x4d70,0x4eda,0x5047,0x51b8,0x532c,0x54a3,0x561d,0x579b,0x591c,0x5aa1,
+	0x5c28,0x5db3,0x5f41,0x60d2,0x6267,0x63ff,0x659a,0x6739,0x68db,0x6a80,0x6c28,0x6dd4,
+	0x6f83,0x7135,0x72ea,0x74a3,0x765f,0x781e,0x79e1,0x7ba7,0x7d70,0x7f3c,0x810c,0x82df,
+	0x84b5,0x868e,0x886b,0x8a4b,0x8c2e,0x8e15,0x8fff,0x91ec,0x93dd,0x95d0,0x97c7,0x99c1,
+	0x9bbf,0x9dc0,0x9fc4,0xa1cb,0xa3d6,0xa5e4,0xa7f5,0xaa09,0xac21,0xae3c,0xb05b,0xb27c,
+	0xb4a1,0xb6c9,0xb8f5,0xbb23,0xbd55,0xbf8a,0xc1c3,0xc3ff,0xc63e,0xc880,0xcac6,0xcd0f,
+	0xcf5b,0xd1aa,0xd3fd,0xd653,0xd8ac,0xdb09,0xdd69,0xdfcc,0xe232,0xe49c,0xe709,0xe979,
+	0xebed,0xee63,0xf0dd,0xf35b,0xf5db,0xf85f,0xfae6,0xfd71,0xffff
+};
+
+cmDimmer *cmDimmer::firstDim;
+
 
 //-------------------------------------------------------------------------------------------------------------------------
 //- user defined functions -
@@ -17,6 +41,7 @@ void cmDimmer::config(void Init(uint8_t), void xSwitch(uint8_t, uint8_t,uint8_t)
 
 	fInit = Init;
 	fSwitch = xSwitch;
+	fPWM = NULL;
 	if (temperature) pTemp = temperature;
 	
 	// set output pins
@@ -29,6 +54,25 @@ void cmDimmer::config(void Init(uint8_t), void xSwitch(uint8_t, uint8_t,uint8_t)
 	// send the initial status info
 	sendStat = 2;
 	msgTmr.set(msgDelay);
+
+	l3 = (s_l3*)&lstPeer;																	// set pointer to something useful
+	l3->actionType = 0;																		// and secure that no action will happened in polling function
+
+	// hook the ramp into the timer interrupt, one hook steps all dimmer channels. a second config keeps the channel where
+	// it is in the list
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		ramp.cur = ramp.tgt = 0;
+		cmDimmer *d = firstDim;
+		while ((d) && (d != this)) d = d->nextDim;
+		if (!d) {
+			nextDim = firstDim;
+			firstDim = this;
+		}
+	}
+	setMsTick(rampTick);
+}
+void cmDimmer::configPWM(void xPWM(uint8_t,uint16_t)) {
+	fPWM = xPWM;
 }
 
 void cmDimmer::trigger11(uint8_t setValue, uint8_t *rampTime, uint8_t *duraTime) {
@@ -51,7 +95,6 @@ void cmDimmer::trigger11(uint8_t setValue, uint8_t *rampTime, uint8_t *duraTime)
 
 	adjDlyPWM = intTimeCvt(rampTme);														// get the ramp on time
 	delayTmr.set(adjDlyPWM);																// set the ramp time to poll delay, otherwise we will every time end here
-	adjDlyPWM /= 200;																		// break down the ramp time to smaller slices for adjusting PWM
 
 	if ((duraTme) && (setValue)) {															// duration time makes only sense if the led is on, default after duration is led off
 		delayTmr.set(0);
@@ -63,62 +106,42 @@ void cmDimmer::trigger11(uint8_t setValue, uint8_t *rampTime, uint8_t *duraTime)
 	}
 	//dbg << F("RL:trigger11, val:") << setValue << F(", rampT:") << intTimeCvt(rampTme) << F(", duraT:") << intTimeCvt(duraTme) << '\n';
 }
-void cmDimmer::trigger40(uint8_t msgLng, uint8_t msgCnt) {
-
-	// some sanity
+void cmDimmer::fsmStop(void) {
 	activeOffDlyBlink = 0;																	// got a new key press, off delay blink is not needed
-	delayTmr.set(0);																		// also delay timer is not needed any more
-	
-	// check for multi execute flag
-	if (( msgLng) && (!lstPeer.lgMultiExec) && (cnt == msgCnt)) return;						// trigger was long, but we have no multi execute
-	cnt = msgCnt;																			// remember message counter
-
-	// set short or long
-	l3 = (msgLng)?(s_l3*)&lstPeer+1 :(s_l3*)&lstPeer;
-
-
-	// check against action type	
-	if        (l3->actionType == 0) {		// off
-
-	} else if (l3->actionType == 1) {		// jmpToTarget
+}
+void cmDimmer::fsmAction(uint8_t type, uint8_t msgCnt) {
 
-		// SwJtOn {no=>0, dlyOn=>1, rampOn=>2, on=>3, dlyOff=>4, rampOff=>5, off=>6}
-		if      (curStat == 1) nxtStat = l3->jtDlyOn;										// delay on
-		else if (curStat == 2) nxtStat = l3->jtRampOn;										// ramp on
-		else if (curStat == 3) nxtStat = l3->jtOn;											// on
-		else if (curStat == 4) nxtStat = l3->jtDlyOff;										// delay off
-		else if (curStat == 5) nxtStat = l3->jtRampOff;										// ramp off
-		else if (curStat == 6) nxtStat = l3->jtOff;											// currently off
-		delayTmr.set(0);																	// set timer to 0 for avoiding delays
+	// check against action type, jmpToTarget is done by cmActor
+	if        (type == 0) {		// off
 
-	} else if (l3->actionType == 2) {		// toogleToCounter
+	} else if (type == 2) {		// toogleToCounter
 		l3->actionType = 0;
 
 		if (msgCnt%2) {
 			modStat = 200;
-			adjDlyPWM = byteTimeCvt(l3->rampOnTime) / 200;
+			adjDlyPWM = byteTimeCvt(l3->rampOnTime);
 			
 		} else {
 			modStat = 0;
-			adjDlyPWM = byteTimeCvt(l3->rampOffTime) / 200;
+			adjDlyPWM = byteTimeCvt(l3->rampOffTime);
 			
 		}
 		
-	} else if (l3->actionType == 3) {		// toogleInversToCounter
+	} else if (type == 3) {		// toogleInversToCounter
 		l3->actionType = 0;
 
 		if (msgCnt%2) {
 			modStat = 0;
-			adjDlyPWM = byteTimeCvt(l3->rampOffTime) / 200;
+			adjDlyPWM = byteTimeCvt(l3->rampOffTime);
 			
 			} else {
 			modStat = 200;
-			adjDlyPWM = byteTimeCvt(l3->rampOnTime) / 200;
+			adjDlyPWM = byteTimeCvt(l3->rampOnTime);
 			
 		}
 
 
-	} else if (l3->actionType == 4) {		// upDim
+	} else if (type == 4) {		// upDim
 		upDim();
 
 		if ((l3->onTime) && (l3->onTime != 255)) {											// check onTimer, if set then set jump table accordingly
@@ -126,45 +149,42 @@ void cmDimmer::trigger40(uint8_t msgLng, uint8_t msgCnt) {
 		} else l3->actionType = 0;
 
 
-	} else if (l3->actionType == 5) {		// downDim
+	} else if (type == 5) {		// downDim
 		downDim();
 		l3->actionType = 0;
 
 		
-	} else if (l3->actionType == 6) {		// toogleDim
+	} else if (type == 6) {		// toogleDim
 		toggleDim();																		// jump into toggle dim function, direction is given there
 		l3->actionType = 0;																	// no further action required
 
 
-	} else if (l3->actionType == 7) {		// toogleDimToCounter
+	} else if (type == 7) {		// toogleDimToCounter
 		// check for even or odd, if even set onMinLvl 
 		if (msgCnt % 2) {																	// odd - dimmer on
 
 			if (modStat < l3->onMinLevel) {													// minimum level already set?
 				modStat = l3->onMinLevel;													// if not, set to minimum level
 				adjDlyPWM = byteTimeCvt(l3->rampOnTime);									// take rampTime in consideration
-				adjDlyPWM /= (modStat - l3->onMinLevel);									// divide adjustment time in small slices
-			}																				// to dim smooth
+			}
 
 		} else {																			// even - dimmer off
 			
 			if (modStat > l3->offLevel) {													// check if dimmer is already off
 				modStat = l3->offLevel;														// if not, set to off level
 				adjDlyPWM = byteTimeCvt(l3->rampOffTime);									// take rampOff Time in consideration
-				adjDlyPWM /= (modStat - l3->offLevel);										// divide it to small slices to dim smoothly
 			}
 			
 		}
 
 		
-	} else if (l3->actionType == 8) {		// toogleDimInversToCounter
+	} else if (type == 8) {		// toogleDimInversToCounter
 		// same as 7, but changed order
 		if (msgCnt % 2) {																	// odd - dimmer off
 
 			if (modStat > l3->offLevel) {													// see action type 7, even
 				modStat = l3->offLevel;
 				adjDlyPWM = byteTimeCvt(l3->rampOffTime);
-				adjDlyPWM /= (modStat - l3->offLevel);
 			}
 
 		} else {																			// even - dimmer on
@@ -172,7 +192,6 @@ void cmDimmer::trigger40(uint8_t msgLng, uint8_t msgCnt) {
 			if (modStat < l3->onMinLevel) {													// see action type 7, odd
 				modStat = l3->onMinLevel;
 				adjDlyPWM = byteTimeCvt(l3->rampOnTime);
-				adjDlyPWM /= (modStat - l3->onMinLevel);
 			}
 			
 		}
@@ -182,41 +201,6 @@ void cmDimmer::trigger40(uint8_t msgLng, uint8_t msgCnt) {
 	//showStruct();																			// some debug messages
 	//dbg << "a: " << l3->actionType << ", c: " << curStat << ", n: " << nxtStat << '\n';	// some debug again
 }
-void cmDimmer::trigger41(uint8_t msgBLL, uint8_t msgCnt, uint8_t msgVal) {
-
-	uint8_t isLng = (msgBLL & 0x40)?1:0;													// is it a long message?
-	uint8_t ctTbl;
-
-	// set short or long
-	l3 = (isLng)?(s_l3*)&lstPeer+1 :(s_l3*)&lstPeer;										// set pointer to the right part of the list3, short or long
-
-	
-	// SwJtOn {no=>0, dlyOn=>1, rampOn=>2, on=>3, dlyOff=>4, rampOff=>5, off=>6}
-	if      (curStat == 1) ctTbl = l3->ctDlyOn;												// delay on
-	else if (curStat == 2) ctTbl = l3->ctRampOn;											// ramp on
-	else if (curStat == 3) ctTbl = l3->ctOn;												// on
-	else if (curStat == 4) ctTbl = l3->ctDlyOff;											// delay off
-	else if (curStat == 5) ctTbl = l3->ctRampOff;											// ramp off
-	else if (curStat == 6) ctTbl = l3->ctOff;												// currently off
-	
-	// X GE COND_VALUE_LO                         - geLo -  > low           - 0
-	// X GE COND_VALUE_HI                         - geHi -  > high          - 1
-	// X LT COND_VALUE_LO                         - ltLo -  < low           - 2
-	// X LT COND_VALUE_HI                         - ltHi -  < high          - 3
-	// COND_VALUE_LO LE X LT COND_VALUE_HIGH      - betW -  low <> high     - 4
-	// X LT COND_VALUE_LO OR X GE COND_VALUE_HIGH - outS -  < low or > high - 5
-
-	//dbg << "curStat: " << curStat  << ", isLng: " << isLng << ", val: " << msgVal  << ", cond: " << ctTbl << '\n';
-
-	if      (ctTbl == 0) if (msgVal > l3->ctValLo) trigger40(isLng, msgCnt);
-	else if (ctTbl == 1) if (msgVal > l3->ctValHi) trigger40(isLng, msgCnt);
-	else if (ctTbl == 2) if (msgVal < l3->ctValLo) trigger40(isLng, msgCnt);
-	else if (ctTbl == 3) if (msgVal < l3->ctValHi) trigger40(isLng, msgCnt);
-	else if (ctTbl == 4) if ((msgVal > l3->ctValLo) && (msgVal < l3->ctValHi)) trigger40(isLng, msgCnt);
-	else if (ctTbl == 5) if ((msgVal < l3->ctValLo) && (msgVal > l3->ctValHi)) trigger40(isLng, msgCnt);
-
-}
-
 void cmDimmer::toggleDim(void) {
 	if (modStat == 0)   directionDim = 1;													// remember the direction , down or up
 	if (modStat == 200) directionDim = 0;
@@ -233,7 +217,7 @@ void cmDimmer::upDim(void) {
 	curStat = 3;																			// dimmer is on, important for on button setting
 	
 	// new value will be set by polling function, time for increase has to be set manually
-	adjDlyPWM = 1;																			// do the adjustment in 1ms steps
+	adjDlyPWM = 200;																		// do the adjustment in 1ms steps
 }
 void cmDimmer::downDim(void) {
 
@@ -246,33 +230,78 @@ void cmDimmer::downDim(void) {
 	modStat -= l3->dimStep;																	// lower the value
 	
 	// new value will be set by polling function, time for increase has to be set manually
-	adjDlyPWM = 1;																			// do the adjustment in 1ms steps
+	adjDlyPWM = 200;																		// do the adjustment in 1ms steps
 }
 
 void cmDimmer::adjPWM(void) {
 
-	// something to do?
-	if (setStat == modStat) return;															// nothing to do
-	if (!adjTmr.done()) return;																// timer not done, wait until then
+	// something to do? the ramp runs in the timer interrupt, here it only gets a new target
+	uint16_t tgt = (uint16_t)modStat << 8;
+	if (ramp.tgt == tgt) return;															// ramp runs already to modStat
 	//dbg << "m" << modStat << " s" << setStat << '\n';
-	
+
+	// step period and 8.8 increment out of the ramp time for 0 to 200, a step is at least 1/4 of a status unit, like
+	// that long ramps end on time as well
+	uint16_t per = 1, inc = 0xffff;															// no ramp time, jump with the next tick
+	if (adjDlyPWM) {
+		uint32_t p = adjDlyPWM / 800 + 1;
+		if (p > 0xffff) p = 0xffff;
+		per = p;
+		p = (51200UL * per) / adjDlyPWM;
+		inc = (p) ? ((p > 0xffff) ? 0xffff : p) : 1;
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		ramp.tgt = tgt;
+		ramp.inc = inc;
+		ramp.per = per;
+		ramp.tick = 1;																		// first step with the next tick
+	}
+}
+void cmDimmer::rampStep(void) {
+	if (activeOffDlyBlink) return;															// blinkOffDly owns the outputs, the ramp waits
+	if (ramp.cur == ramp.tgt) return;														// nothing to do
+	if (--ramp.tick) return;																// wait for the next step
+	ramp.tick = ramp.per;
+
 	// calculate next step
-	if (modStat > setStat) setStat++;														// do we have to go up
-	else setStat--;																			// or down
-	
-	// set value on PWM channel and timer for next adjustment
+	uint16_t cur = ramp.cur;
+	if (cur < ramp.tgt) {																	// do we have to go up
+		cur = (ramp.tgt - cur > ramp.inc) ? cur + ramp.inc : ramp.tgt;
+	} else {																				// or down
+		cur = (cur - ramp.tgt > ramp.inc) ? cur - ramp.inc : ramp.tgt;
+	}
+	ramp.cur = cur;
+
+	// 16 bit value on every step, the main sketch callback only if the status has changed
+	if (fPWM) fPWM(regCnl, pwmValue(cur));
+	if ((cur >> 8) == setStat) return;
+	setStat = cur >> 8;
+	switchStat(setStat);
+}
+uint16_t cmDimmer::pwmValue(uint16_t lvl) {
+	if (!lstCnl.characteristic) return (uint32_t)lvl * 83886 >> 16;							// linear, 200.0 is 65535
+
+	uint8_t  i = lvl >> 8, f = lvl;															// quadratic, interpolated between two table values
+	uint16_t x = pgm_read_word(&dimCurve[i]);
+	if (f) x += (uint32_t)(pgm_read_word(&dimCurve[i + 1]) - x) * f >> 8;
+	return x;
+}
+void cmDimmer::switchStat(uint8_t stat) {
+	// set value on PWM channel
 	if (lstCnl.characteristic) {															// check if we should use quadratic approach
 
-		characteristicStat = setStat * setStat;												// recalculate the value
-		characteristicStat /= 200;															// divide it by 200
-		if ((setStat) && (!characteristicStat)) characteristicStat = 1;						// till 15 it is below 1
-		fSwitch(regCnl, characteristicStat, lstCnl.characteristic);									// set accordingly
+		characteristicStat = (uint16_t)stat * stat / 200;									// recalculate the value
+		if ((stat) && (!characteristicStat)) characteristicStat = 1;						// till 15 it is below 1
+		fSwitch(regCnl, characteristicStat, lstCnl.characteristic);							// set accordingly
 
 	} else {
-		fSwitch(regCnl, setStat, lstCnl.characteristic);									// set accordingly
+		fSwitch(regCnl, stat, lstCnl.characteristic);										// set accordingly
 
 	}
-	adjTmr.set(adjDlyPWM);																	// set timer for next action
+}
+void cmDimmer::rampTick(void) {
+	for (cmDimmer *d = firstDim; d; d = d->nextDim) d->rampStep();
 }
 void cmDimmer::blinkOffDly(void) {
 
@@ -287,40 +316,20 @@ void cmDimmer::blinkOffDly(void) {
 		statusOffDlyBlink = 0;																// switch led on next time
 		adjTmr.set(10);																		// off for 30 ms
 		fSwitch(regCnl, 1, lstCnl.characteristic);											// set led to minimum
+		if (fPWM) fPWM(regCnl, pwmValue(1 << 8));
 		
 	} else {
 		statusOffDlyBlink = 1;																// switch led off next time
 		adjTmr.set(500);																	// on for 500 ms
 		if (lstCnl.characteristic) fSwitch(regCnl, characteristicStat, lstCnl.characteristic);	// take the quadratic value
 		else fSwitch(regCnl, modStat,lstCnl.characteristic);								// restore origin value
+		uint16_t cur;
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			cur = ramp.cur;																	// 16 bit, written by the timer interrupt
+		}
+		if (fPWM) fPWM(regCnl, pwmValue(cur));
 	}
 }
-void cmDimmer::sendStatus(void) {
-
-	if (!sendStat) return;																	// nothing to do
-	if (!msgTmr.done()) return;																// not the right time
-		
-	// prepare message; UP 0x10, DOWN 0x20, ERROR 0x30, DELAY 0x40, LOWBAT 0x80
-	if      (modStat == setStat) modDUL  = 0;
-	else if (modStat <  setStat) modDUL  = 0x10;
-	else if (modStat >  setStat) modDUL  = 0x20;
-	if (!delayTmr.done() )       modDUL |= 0x40;
-		
-	// check which type has to be send - if it is an ACK and modDUL != 0, then set timer for sending a actuator status
-	if      (sendStat == 1) hm->sendACK_STATUS(regCnl, modStat, modDUL);					// send ACK
-	else if (sendStat == 2) hm->sendINFO_ACTUATOR_STATUS(regCnl, modStat, modDUL);			// send status
-
-	// check if it is a stable status, otherwise schedule next info message
-	if (modDUL >= 0x40) {																	// status is currently changing
-		sendStat = 2;																		// send next time a info status message
-		msgTmr.set(delayTmr.remain()+5);
-
-	} else if (modDUL) {
-		sendStat = 2;																		// send next time a info status message
-		msgTmr.set(msgDelay);
-
-	} else sendStat = 0;																	// no need for next time
-}
 void cmDimmer::dimPoll(void) {
 	
 	adjPWM();																				// check if something is to be set on the PWM channel
@@ -337,7 +346,7 @@ void cmDimmer::dimPoll(void) {
 	// upDim, check if onTimer was running
 	if (l3->actionType == 4)  {
 		modStat = l3->offLevel;
-		adjDlyPWM = 1;																		// do the adjustment in 1ms steps
+		adjDlyPWM = 200;																	// do the adjustment in 1ms steps
 		l3->actionType = 0;																	// no further action required
 	}
 
@@ -345,116 +354,30 @@ void cmDimmer::dimPoll(void) {
 	if (duraTme)  {
 		modStat = 0;
 		adjDlyPWM = intTimeCvt(rampTme);													// get the ramp on time
-		adjDlyPWM /= 200;																	// break down the ramp time to smaller slices for adjusting PWM
 		rampTme = duraTme = 0;																// no further action required
 	}
 	
-	// - jump table section, only
-	if (l3->actionType != 1) return;														// only valid for jump table
-	if (curStat == nxtStat) return;															// no status change expected
-	activeOffDlyBlink = 0;	
-
-	// check the different status changes, {no=>0, dlyOn=>1, rampOn=>2, on=>3, dlyOff=>4, rampOff=>5, off=>6}
-	if        (nxtStat == 1) {		// dlyOn
-		#ifdef DI_DBG
-		dbg << F("dlyOn\n");
-		#endif 
-		
-		curStat = nxtStat;																	// remember current status
-		nxtStat = l3->jtDlyOn;																// get next status from jump table
-		
-		if (l3->onDly) {																	// check if there is something in the duration timer, set next status accordingly
-			delayTmr.set(byteTimeCvt(l3->onDly));											// activate the timer and set next status
-		}
-		
-
-	} else if (nxtStat == 2) {		// rampOn
-		#ifdef DI_DBG
-		dbg << F("rampOn\n");
-		#endif
-		
-		// check modStat against onLevel, if not compare, set the right values
-		if (modStat != l3->onLevel)	{														// modStat not set, so first time
-			modStat	= l3->onLevel;															// set module status accordingly settings
-			adjDlyPWM = byteTimeCvt(l3->rampOnTime);										// get the ramp on time
-			delayTmr.set(adjDlyPWM);														// set the ramp time to poll delay, otherwise we will every time end here
-			adjDlyPWM /= 200;																// break down the ramp time to smaller slices for adjusting PWM
-		}
-		
-		// check if ramp on is done, set next status
-		if (modStat == setStat) {															// ramp on is done
-			curStat = nxtStat;																// set current status accordingly
-			nxtStat = l3->jtRampOn;															// set next status accordingly the jump table
-		}
-
-		
-	} else if (nxtStat == 3) {		// on
-		#ifdef DI_DBG
-		dbg << F("on\n");
-		#endif
-		
-		curStat = nxtStat;																	// remember current status, when timer not set, we stay here for ever
-		
-		if ((l3->onTime) && (l3->onTime != 255)) {											// check if there is something in the duration timer, set next status accordingly
-			delayTmr.set(byteTimeCvt(l3->onTime));											// activate the timer and set next status
-
-			// nxtStat = l3->jtOn; seems to be wrong here, because original device goes to rampOff and stays in off, so refill jumptable
-			nxtStat = 5;																	// go to ramp off
-			l3->jtRampOff = 6;																// jump from rampOff to off
-			l3->jtOff = 6;																	// stay in off mode
-		} //else nxtStat = l3->jtOn;														// not sure in which scenario it is needed
-
-
-	} else if (nxtStat == 4) {		// dlyOff
-		#ifdef DI_DBG
-		dbg << F("dlyOff\n");
-		#endif
-
-		curStat = nxtStat;																	// remember current status
-		nxtStat = l3->jtDlyOff;																// get jump table for next status
-
-		if (l3->offDly) {																	// check if there is something in the duration timer, set next status accordingly
-			delayTmr.set(byteTimeCvt(l3->offDly));											// activate the timer and set next status
-			if (l3->offDlyBlink) activeOffDlyBlink = 1;
-		}
-
-
-	} else if (nxtStat == 5) {		// rampOff
-		#ifdef DI_DBG
-		dbg << F("rampOff\n");
-		#endif
-		
-		// check modStat against offLevel, if not similar, set the right values
-		if (modStat != l3->offLevel) {														// check for first time and set the correct values
-			modStat	= l3->offLevel;															// set the PWM to the right value
-			adjDlyPWM = byteTimeCvt(l3->rampOffTime);										// get the ramp off time
-			delayTmr.set(adjDlyPWM);														// set ramp off time to the poll timer, other wise we will check every ms again
-			adjDlyPWM /= 200;																// split PWN timer to slices for smooth dimming
-		}
-		
-		// check if ramp on is done, set next status
-		if (modStat == setStat) {															// check if ramp off is done
-			curStat = nxtStat;																// remember the current status
-			nxtStat = l3->jtRampOff;														// get the next status from jump table
-		}
-
-
-	} else if (nxtStat == 6) {		// off
-		#ifdef DI_DBG
-		dbg << F("off\n");
-		#endif
-
-		curStat = nxtStat;																	// remember the current status
-		//nxtStat = l3->jtOff;																// get the next status from jump table
-
-		if ((l3->offTime) && (l3->offTime != 255)) {										// check if there is something in the duration timer, set next status accordingly
-			delayTmr.set(byteTimeCvt(l3->offTime));											// activate the timer and set next status
-			// refill jumptable
-
-		}
-
+	fsmPoll();																				// jump table section
+}
+void cmDimmer::fsmEnter(uint8_t stat) {
+	activeOffDlyBlink = 0;																	// a new state ends the blinking
+	if ((stat == 4) && (l3->offDly) && (l3->offDlyBlink)) activeOffDlyBlink = 1;			// dlyOff with blinking led
+}
+uint8_t cmDimmer::fsmRampTo(uint8_t stat) {
+	// check modStat against onLevel or offLevel, if not compare, set the right values
+	uint8_t lvl = (stat == 2) ? l3->onLevel : l3->offLevel;
+	if (modStat != lvl) {																	// modStat not set, so first time
+		modStat = lvl;																		// set module status accordingly settings
+		adjDlyPWM = byteTimeCvt((stat == 2) ? l3->rampOnTime : l3->rampOffTime);			// get the ramp time
+		delayTmr.set(adjDlyPWM);															// set the ramp time to poll delay, otherwise we will every time end here
 	}
-
+	return (modStat == setStat);															// ramp is done
+}
+uint32_t cmDimmer::fsmNext(void) {
+	if (ramp.tgt != (uint16_t)modStat << 8) return 0;										// adjPWM has a new target
+	if ((!delayTmr.running()) && ((l3->actionType == 4) || (duraTme))) return 0;			// upDim or trigger11 time is over
+	if (activeOffDlyBlink) return adjTmr.remain();											// next blink
+	return 0xffffffff;
 }
 
   //- helpers defined functions -------------------------------------------------------------------------------------------
@@ -566,18 +489,15 @@ void cmDimmer::peerMsgEvent(uint8_t type, uint8_t *data, uint8_t len) {
 
 void cmDimmer::poll(void) {
 	dimPoll();
+	hm->rg.setDue(regCnl, fsmDue());														// sleep until a timer runs out or an event comes
 }
 
 //-------------------------------------------------------------------------------------------------------------------------
 //- predefined, no reason to touch -
 //-------------------------------------------------------------------------------------------------------------------------
-void cmDimmer::regInHM(uint8_t cnl, uint8_t lst, AS *instPtr) {
-	hm = instPtr;																			// set pointer to the HM module
-	hm->rg.regInAS(cnl, lst, s_mod_dlgt(this,&cmDimmer::hmEventCol), (uint8_t*)&lstCnl,(uint8_t*)&lstPeer);
-	regCnl = cnl;																			// stores the channel we are responsible fore
-}
 void cmDimmer::hmEventCol(uint8_t by3, uint8_t by10, uint8_t by11, uint8_t *data, uint8_t len) {
 	// dbg << "by3:" << by3 << " by10:" << by10 << " d:" << pHex(data, len) << '\n'; _delay_ms(100);
+	if ((by3) || (by10)) hm->rg.setDue(regCnl, 0);											// an event, poll with the next loop
 	if      ((by3 == 0x00) && (by10 == 0x00)) poll();
 	else if ((by3 == 0x00) && (by10 == 0x01)) setToggle();
 	else if ((by3 == 0x00) && (by10 == 0x02)) firstStart();
@@ -11,6 +11,7 @@
 
 #include "AS.h"
 #include "HAL.h"
+#include "cmActor.h"
 
 // default settings for list3 or list4
 
@@ -64,7 +65,9 @@ const uint8_t peerSingle[] = {
 };
 
 
-class cmDimmer {
+class cmDimmer : public cmActor<cmDimmer> {
+	friend class cmActor<cmDimmer>;
+
   //- user code here ------------------------------------------------------------------------------------------------------
   public://----------------------------------------------------------------------------------------------------------------
   protected://-------------------------------------------------------------------------------------------------------------
@@ -243,47 +246,59 @@ class cmDimmer {
 	
 	void (*fInit)(uint8_t);																	// pointer to init function in main sketch
 	void (*fSwitch)(uint8_t,uint8_t,uint8_t);												// pointer to switch function (PWM) in main sketch, first value is PWM level, second the characteristics
+	void (*fPWM)(uint8_t,uint16_t);															// optional, 16 bit PWM value with the characteristic already applied
 
 	uint8_t  *pTemp;																		// pointer to temperature byte in main sketch
 	
-	uint8_t   sendStat :2;																	// is there a status to be send, 1 indicates an ACK, 2 a status message 
-	uint16_t  msgDelay;
-	waitTimer msgTmr;																		// message timer for sending status
-
-	waitTimer delayTmr;																		// delay timer for on,off and delay time
 	uint16_t  rampTme, duraTme;																// time store for trigger 11
 
-	uint8_t   setStat;																		// status to set on the PWM channel
-	uint32_t  adjDlyPWM;																	// timer to follow in adjPWM function
-	uint16_t  characteristicStat;															// depends on list1 characteristic setting
-	waitTimer adjTmr;																		// timer for adjustment of PWM
+	volatile uint8_t setStat;																// status on the PWM channel, follows the ramp
+	uint32_t  adjDlyPWM;																	// ramp time in ms for the full range 0 to 200, 0 jumps
+	volatile uint8_t characteristicStat;													// depends on list1 characteristic setting
+	waitTimer adjTmr;																		// timer for the off delay blinking
+
+	struct s_ramp {																			// - ramp generator, stepped by the 1ms timer interrupt
+		volatile uint16_t cur;																// current level, 8.8 fixed point
+		uint16_t  tgt;																		// level the ramp runs to, 8.8
+		uint16_t  inc;																		// 8.8 increment of one step
+		uint16_t  per;																		// ms between two steps
+		uint16_t  tick;																		// ms until the next step
+	} ramp;
+	cmDimmer  *nextDim;																		// next dimmer channel the interrupt steps
+	static cmDimmer *firstDim;
 
 	//uint8_t   oldStat;																	// remember modStat in delay off blink function
-	uint8_t   activeOffDlyBlink :1;															// activate off delay blinking
+	uint8_t   activeOffDlyBlink :1;															// activate off delay blinking, holds the ramp meanwhile
 	uint8_t   statusOffDlyBlink :1;															// remember led off cycle
 	uint8_t   directionDim :1;																// used in toogleDim function
 
-	uint8_t   cnt;																			// message counter for type 40 message
-	uint8_t   curStat:4, nxtStat:4;															// current state and next state
-
   public://----------------------------------------------------------------------------------------------------------------
   //- user defined functions ----------------------------------------------------------------------------------------------
 
 	void     config(void Init(uint8_t), void xSwitch(uint8_t,uint8_t,uint8_t), uint8_t *temperature);// configures the module, jump addresses, etc
+	void     configPWM(void xPWM(uint8_t,uint16_t));										// optional 16 bit PWM output, called on every step of the ramp
 
 	void     trigger11(uint8_t setValue, uint8_t *rampTime, uint8_t *duraTime);				// messages coming from master
-	void     trigger40(uint8_t msgLng, uint8_t msgCnt);										// messages coming from switch
-	void     trigger41(uint8_t msgBLL, uint8_t msgCnt, uint8_t msgVal);						// messages coming from sensor
 
   private://---------------------------------------------------------------------------------------------------------------
 	void     toggleDim(void);																// dim up or down with one key
 	void     upDim(void);																	// up dim procedure
 	void     downDim(void);																	// down dim procedure
 
-	void     adjPWM(void);																	// adjusts PWM value in a regular manner
+	void     adjPWM(void);																	// starts the ramp if modStat has changed
+	void     rampStep(void);																// one ms of the ramp, interrupt context
+	uint16_t pwmValue(uint16_t lvl);														// 16 bit PWM value of an 8.8 level, with the characteristic
+	void     switchStat(uint8_t stat);														// status to the callbacks of the main sketch
+	static void rampTick(void);																// ms hook of the timer interrupt, steps all dimmers
 	void     blinkOffDly(void);																// polling function to blink led while in off delay
-	void     sendStatus(void);																// send status function
 	void     dimPoll(void);																	// dimmer polling function
+
+	enum { fsmRamp = 1 };																	// dimmer has rampOn and rampOff
+	void     fsmStop(void);																	// hooks of the state machine, see cmActor.h
+	void     fsmAction(uint8_t type, uint8_t msgCnt);
+	void     fsmEnter(uint8_t stat);
+	uint8_t  fsmRampTo(uint8_t stat);
+	uint32_t fsmNext(void);
 	
   //- helpers defined functions -------------------------------------------------------------------------------------------
 	void     showStruct(void);
@@ -291,12 +306,6 @@ class cmDimmer {
 	
   public://----------------------------------------------------------------------------------------------------------------
   //- mandatory functions for every new module to communicate within AS protocol stack ------------------------------------
-	uint8_t  modStat;																		// module status byte, needed for list3 modules to answer status requests
-	uint8_t  modDUL;																		// module down up low battery byte
-	uint8_t  regCnl;																		// holds the channel for the module
-
-	AS       *hm;																			// pointer to HM class instance
-
 	void     setToggle(void);																// toggle the module initiated by config button
 	void     configCngEvent(void);															// list1 on registered channel had changed
 	void     pairSetEvent(uint8_t *data, uint8_t len);										// pair message to specific channel, handover information for value, ramp time and so on
@@ -306,7 +315,6 @@ class cmDimmer {
 	void     poll(void);																	// poll function, driven by HM loop
 
 	//- predefined, no reason to touch ------------------------------------------------------------------------------------
-	void     regInHM(uint8_t cnl, uint8_t lst, AS *instPtr);								// register this module in HM on the specific channel
 	void     hmEventCol(uint8_t by3, uint8_t by10, uint8_t by11, uint8_t *data, uint8_t len);// call back address for HM for informing on events
 	void     peerAddEvent(uint8_t *data, uint8_t len);										// peer was added to the specific channel, 1st and 2nd byte shows peer channel, third and fourth byte shows peer index
 	void     firstStart(void);																// first start detection, to write list1
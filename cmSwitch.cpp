@@ -62,73 +62,35 @@ void cmSwitch::trigger11(uint8_t setValue, uint8_t *rampTime, uint8_t *duraTime)
 	if (duraTme) tr11 = 1;																	// indicate we are coming from trigger11
 	//dbg << F("RL:trigger11, val:") << setValue << F(", rampT:") << intTimeCvt(rampTme) << F(", duraT:") << intTimeCvt(duraTme) << '\n';
 }
-void cmSwitch::trigger40(uint8_t msgLng, uint8_t msgCnt) {
-
-	// some sanity
-	delayTmr.set(0);																		// also delay timer is not needed any more
-	rampTme = duraTme = 0;
-	
-	// check for multi execute flag
-	if (( msgLng) && (!lstPeer.lgMultiExec) && (cnt == msgCnt)) return;						// trigger was long, but we have no multi execute
-	cnt = msgCnt;																			// remember message counter
-
-	// set short or long
-	l3 = (msgLng)?(s_l3*)&lstPeer+1 :(s_l3*)&lstPeer;
+void cmSwitch::fsmStop(void) {
+	rampTme = duraTme = 0;																	// a peer trigger ends trigger11
+}
+void cmSwitch::fsmAction(uint8_t type, uint8_t msgCnt) {
 
 	// check against action type
-	if        (l3->actionType == 0) {		// off
-
-	} else if (l3->actionType == 1) {		// jmpToTarget
+	if        (type == 0) {		// off
 
-		// SwJtOn {no=>0, dlyOn=>1, rampOn=>2, on=>3, dlyOff=>4, rampOff=>5, off=>6}
-		if      (curStat == 1) nxtStat = l3->jtDlyOn;										// delay on
-		else if (curStat == 3) nxtStat = l3->jtOn;											// on
-		else if (curStat == 4) nxtStat = l3->jtDlyOff;										// delay off
-		else if (curStat == 6) nxtStat = l3->jtOff;											// currently off
-		delayTmr.set(0);																	// set timer to 0 for avoiding delays
-
-	} else if (l3->actionType == 2) {		// toogleToCounter
+	} else if (type == 2) {		// toogleToCounter
 
 		modStat = (msgCnt%2)?200:0;															// odd
 
-	} else if (l3->actionType == 3) {		// toogleInversToCounter
+	} else if (type == 3) {		// toogleInversToCounter
 
 		modStat = (msgCnt%2)?0:200;															// odd
 
 	}
 	//dbg << "a: " << l3->actionType << ", c: " << curStat << ", n: " << nxtStat << ", onDly: " << _HEXB(l3->onDly) << ", onTime: " << _HEXB(l3->onTime) << ", offDly: " << _HEXB(l3->offDly) << ", offTime: " << _HEXB(l3->offTime) << '\n';
 }
-void cmSwitch::trigger41(uint8_t msgBLL, uint8_t msgCnt, uint8_t msgVal) {
-
-	uint8_t isLng = (msgBLL & 0x40)?1:0;													// is it a long message?
-	uint8_t ctTbl;
-	
-	// set short or long
-	l3 = (isLng)?(s_l3*)&lstPeer+1 :(s_l3*)&lstPeer;										// set pointer to the right part of the list3, short or long
-
-
-	// SwJtOn {no=>0, dlyOn=>1, rampOn=>2, on=>3, dlyOff=>4, rampOff=>5, off=>6}
-	if      (curStat == 1) ctTbl = l3->ctDlyOn;												// delay on
-	else if (curStat == 3) ctTbl = l3->ctOn;												// on
-	else if (curStat == 4) ctTbl = l3->ctDlyOff;											// delay off
-	else if (curStat == 6) ctTbl = l3->ctOff;												// currently off
-	
-	// X GE COND_VALUE_LO                         - geLo -  > low           - 0
-	// X GE COND_VALUE_HI                         - geHi -  > high          - 1
-	// X LT COND_VALUE_LO                         - ltLo -  < low           - 2
-	// X LT COND_VALUE_HI                         - ltHi -  < high          - 3
-	// COND_VALUE_LO LE X LT COND_VALUE_HIGH      - betW -  low <> high     - 4
-	// X LT COND_VALUE_LO OR X GE COND_VALUE_HIGH - outS -  < low or > high - 5
-
-	//dbg << "curStat: " << curStat  << ", isLng: " << isLng << ", val: " << msgVal  << ", cond: " << ctTbl << '\n';
-
-	if      (ctTbl == 0) if (msgVal > l3->ctValLo) trigger40(isLng, msgCnt);
-	else if (ctTbl == 1) if (msgVal > l3->ctValHi) trigger40(isLng, msgCnt);
-	else if (ctTbl == 2) if (msgVal < l3->ctValLo) trigger40(isLng, msgCnt);
-	else if (ctTbl == 3) if (msgVal < l3->ctValHi) trigger40(isLng, msgCnt);
-	else if (ctTbl == 4) if ((msgVal > l3->ctValLo) && (msgVal < l3->ctValHi)) trigger40(isLng, msgCnt);
-	else if (ctTbl == 5) if ((msgVal < l3->ctValLo) && (msgVal > l3->ctValHi)) trigger40(isLng, msgCnt);
-
+void cmSwitch::fsmEnter(uint8_t stat) {
+	// the relay follows the jump table in on and off as well, on and off switch the relay
+	if ((stat != 3) && (stat != 6)) return;
+	nxtStat = fsmJt(stat);																	// get next status from jump table
+	modStat = (stat == 3) ? 200 : 0;														// switch relay on or off
+}
+uint32_t cmSwitch::fsmNext(void) {
+	if (setStat != modStat) return 0;														// adjRly has to follow
+	if ((tr11) && (!delayTmr.running())) return 0;											// trigger11 goes on
+	return 0xffffffff;
 }
 void cmSwitch::adjRly(void) {
 
@@ -143,28 +105,6 @@ void cmSwitch::adjRly(void) {
 	
 	msgTmr.set(0);
 }
-void cmSwitch::sendStatus(void) {
-
-	if (!sendStat) return;																	// nothing to do
-	if (!msgTmr.done()) return;																// not the right time
-	
-	// prepare message; UP 0x10, DOWN 0x20, ERROR 0x30, DELAY 0x40, LOWBAT 0x80
-	if      (modStat == setStat) modDUL  = 0;
-	//else if (modStat <  setStat) modDUL  = 0x10;
-	//else if (modStat >  setStat) modDUL  = 0x20;
-	if (!delayTmr.done() )       modDUL |= 0x40;
-	
-	// check which type has to be send - if it is an ACK and modDUL != 0, then set timer for sending a actuator status
-	if      (sendStat == 1) hm->sendACK_STATUS(regCnl, modStat, modDUL);					// send ACK
-	else if (sendStat == 2) hm->sendINFO_ACTUATOR_STATUS(regCnl, modStat, modDUL);			// send status
-
-	// check if it is a stable status, otherwise schedule next info message
-	if (modDUL)  {																			// status is currently changing
-		sendStat = 2;																		// send next time a info status message
-		msgTmr.set(delayTmr.remain()+5);
-	} else sendStat = 0;																	// no need for next time
-	//sendStat = 0;
-}
 
 void cmSwitch::rlyPoll(void) {
 
@@ -194,67 +134,7 @@ void cmSwitch::rlyPoll(void) {
 	}
 	
 
-	// - jump table section, only
-	if (l3->actionType != 1) return;														// only valid for jump table
-	if (curStat == nxtStat) return;															// no status change expected
-
-	// check the different status changes, {no=>0, dlyOn=>1, rampOn=>2, on=>3, dlyOff=>4, rampOff=>5, off=>6}
-	if        (nxtStat == 1) {		// dlyOn
-		#ifdef RL_DBG
-		dbg << F("dlyOn\n");
-		#endif
-		
-		curStat = nxtStat;																	// remember current status
-		nxtStat = l3->jtDlyOn;																// get next status from jump table
-		
-		if (l3->onDly) {																	// check if there is something in the duration timer, set next status accordingly
-			delayTmr.set(byteTimeCvt(l3->onDly));											// activate the timer and set next status
-		}
-		
-
-	} else if (nxtStat == 3) {		// on
-		#ifdef RL_DBG
-		dbg << F("on\n");
-		#endif
-		
-		curStat = nxtStat;																	// remember current status, when timer not set, we stay here for ever
-		nxtStat = l3->jtOn;																	// get next status from jump table
-		modStat = 200;																		// switch relay on
-		
-		if ((l3->onTime) && (l3->onTime != 255)) {											// check if there is something in the duration timer, set next status accordingly
-			delayTmr.set(byteTimeCvt(l3->onTime));											// activate the timer and set next status
-			nxtStat = 6;																	// go to off
-			l3->jtOff = 6;																	// stay in off mode
-		} 
-
-	} else if (nxtStat == 4) {		// dlyOff
-		#ifdef RL_DBG
-		dbg << F("dlyOff\n");
-		#endif
-
-		curStat = nxtStat;																	// remember current status
-		nxtStat = l3->jtDlyOff;																// get jump table for next status
-
-		if (l3->offDly) {																	// check if there is something in the duration timer, set next status accordingly
-			delayTmr.set(byteTimeCvt(l3->offDly));											// activate the timer and set next status
-		}
-
-
-	} else if (nxtStat == 6) {		// off
-		#ifdef RL_DBG
-		dbg << F("off\n");
-		#endif
-
-		curStat = nxtStat;																	// remember the current status
-		nxtStat = l3->jtOff;																// get the next status from jump table
-		modStat = 0;																		// switch off relay
-
-		if ((l3->offTime) && (l3->offTime != 255)) {										// check if there is something in the duration timer, set next status accordingly
-			delayTmr.set(byteTimeCvt(l3->offTime));											// activate the timer and set next status
-			nxtStat = 3;																	// go to on
-			l3->jtOn = 3;																	// stay in on mode
-		}
-	}
+	fsmPoll();																				// jump table section
 }
 
 
@@ -329,19 +209,16 @@ void cmSwitch::peerMsgEvent(uint8_t type, uint8_t *data, uint8_t len) {
 
 void cmSwitch::poll(void) {
 	rlyPoll();
+	hm->rg.setDue(regCnl, fsmDue());														// sleep until a timer runs out or an event comes
 }
 
 
 //-------------------------------------------------------------------------------------------------------------------------
 //- predefined, no reason to touch -
 //-------------------------------------------------------------------------------------------------------------------------
-void cmSwitch::regInHM(uint8_t cnl, uint8_t lst, AS *instPtr) {
-	hm = instPtr;																			// set pointer to the HM module
-	hm->rg.regInAS(cnl, lst, s_mod_dlgt(this,&cmSwitch::hmEventCol), (uint8_t*)&lstCnl,(uint8_t*)&lstPeer);
-	regCnl = cnl;																			// stores the channel we are responsible fore
-}
 void cmSwitch::hmEventCol(uint8_t by3, uint8_t by10, uint8_t by11, uint8_t *data, uint8_t len) {
 	// dbg << "by3:" << by3 << " by10:" << by10 << " d:" << pHex(data, len) << '\n'; _delay_ms(100);
+	if ((by3) || (by10)) hm->rg.setDue(regCnl, 0);											// an event, poll with the next loop
 	if      ((by3 == 0x00) && (by10 == 0x00)) poll();
 	else if ((by3 == 0x00) && (by10 == 0x01)) setToggle();
 	else if ((by3 == 0x01) && (by11 == 0x06)) configCngEvent();
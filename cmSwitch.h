@@ -11,6 +11,7 @@
 
 #include "AS.h"
 #include "HAL.h"
+#include "cmActor.h"
 
 // default settings for list3 or list4
 const uint8_t peerOdd[] =    {		// cnl 2, 4, 6
@@ -33,7 +34,9 @@ const uint8_t peerSingle[] = {
 };
 
 
-class cmSwitch {
+class cmSwitch : public cmActor<cmSwitch> {
+	friend class cmActor<cmSwitch>;
+
   //- user code here ------------------------------------------------------------------------------------------------------
   public://----------------------------------------------------------------------------------------------------------------
   protected://-------------------------------------------------------------------------------------------------------------
@@ -115,15 +118,6 @@ class cmSwitch {
 	void (*fInit)(uint8_t);																	// pointer to init function in main sketch
 	void (*fSwitch)(uint8_t,uint8_t);														// pointer to switch function in main sketch
 
-	waitTimer delayTmr;																		// delay timer for relay
-
-	uint8_t   cnt;																			// message counter for type 40 message
-	uint8_t   curStat:4, nxtStat:4;															// current state and next state
-
-	waitTimer msgTmr;																		// message timer for sending status
-	uint16_t  msgDelay;																		// delay for sending initial status
-	uint8_t	  sendStat  :2;																	// indicator for sendStatus function
-
 	uint8_t   tr11      :1;																	// trigger 11 active
 	uint8_t   tr11Value;																	// trigger 11 set value
 	uint16_t  rampTme, duraTme;																// time store for trigger 11
@@ -133,22 +127,22 @@ class cmSwitch {
 	void      config(void Init(uint8_t), void xSwitch(uint8_t,uint8_t));					// handover for jump addresses
 
 	void      trigger11(uint8_t value, uint8_t *rampTime, uint8_t *duraTime);				// what happens while a trigger11 message arrive
-	void      trigger40(uint8_t msgLng, uint8_t msgCnt);									// same for peer messages
-	void      trigger41(uint8_t msgBLL, uint8_t msgCnt, uint8_t msgVal);					// same for sensor messages
 
 	void      adjRly(void);																	// setting of relay status
-	void      sendStatus(void);																// help function to send status messages
 
 	void      rlyPoll(void);																// polling function
 
 
-  //- mandatory functions for every new module to communicate within AS protocol stack ------------------------------------
-	uint8_t modStat;																		// module status byte, needed for list3 modules to answer status requests
-	uint8_t modDUL;																			// module down up low battery byte
-	uint8_t regCnl;																			// holds the channel for the module
+  private://---------------------------------------------------------------------------------------------------------------
+	enum { fsmL3Reg = 2 };																	// s_l3 starts with register 0x02
 
-	AS      *hm;																			// pointer to HM class instance
+	void      fsmStop(void);																// hooks of the state machine, see cmActor.h
+	void      fsmAction(uint8_t type, uint8_t msgCnt);
+	void      fsmEnter(uint8_t stat);
+	uint32_t  fsmNext(void);
 
+  public://----------------------------------------------------------------------------------------------------------------
+  //- mandatory functions for every new module to communicate within AS protocol stack ------------------------------------
 	void    setToggle(void);																// toggle the module initiated by config button
 	void    configCngEvent(void);															// list1 on registered channel had changed
 	void    pairSetEvent(uint8_t *data, uint8_t len);										// pair message to specific channel, handover information for value, ramp time and so on
@@ -158,7 +152,6 @@ class cmSwitch {
 	void    poll(void);																		// poll function, driven by HM loop
 
 	//- predefined, no reason to touch ------------------------------------------------------------------------------------
-	void    regInHM(uint8_t cnl, uint8_t lst, AS *instPtr);									// register this module in HM on the specific channel
 	void    hmEventCol(uint8_t by3, uint8_t by10, uint8_t by11, uint8_t *data, uint8_t len);// call back address for HM for informing on events
 	void    peerAddEvent(uint8_t *data, uint8_t len);										// peer was added to the specific channel, 1st and 2nd byte shows peer channel, third and fourth byte shows peer index
 };
@@ -4,7 +4,9 @@ use XML::LibXML;
 
 
 ## --------------import constants----------------------------------------------------------------------------
+use FindBin; use lib $FindBin::Bin;
 use devDefinition;
+use eeLayout;
 
 my %cType             =usrRegs::usr_getHash("configType");
 
@@ -203,88 +205,36 @@ foreach my $test (sort keys %cnlTypeA) {														# some debug
 #}
 
 
-# -- cleanup the array and remember start address and length
-my $slcIdx = 0; my $slcLen = 0; my $phyAddr = 31;
-foreach my $test (sort keys %cnlType) {
-	$slcLen = scalar(@{ $cnlType{$test}{'regSet'} });
-
-	my $peers = 1;
-	$peers = $rL{$cnlType{$test}{'cnl'}}{'peers'}    if( ( $cnlType{$test}{'cnl'} > 0 ) && ( $cnlType{$test}{'lst'} >= 3 ) && ( $cnlType{$test}{'lst'} <= 4 ) );
-	
-	$cnlType{$test}{'slcIdx'}  = $slcIdx;
-	$cnlType{$test}{'slcLen'}  = $slcLen;
-	$cnlType{$test}{'phyAddr'} = $phyAddr;
-	$cnlType{$test}{'peers'}   = $peers;
-
-	# check if hidden flag is set
-	my $hidden = 0;
-	$hidden = $rL{$cnlType{$test}{'cnl'}}{'hidden'}          if ($cnlType{$test}{'cnl'} > 0);
-	$cnlType{$test}{'hidden'} = $hidden;
-
-	$phyAddr += $peers * $slcLen;
-	$slcIdx  += $slcLen;
-	
-	#print "$test: @{ $cnlType{$test}{'regSet'} }\n";											# some debug
-	#print "cnl, lst, sIdx, sLen, pAddr\n";
-	#print sprintf("%.1d, %.1d, 0x%.2x, %.1d, 0x%.4x,", $cnlType{$test}{'cnl'}, $cnlType{$test}{'lst'}, $cnlType{$test}{'slcIdx'}, $cnlType{$test}{'slcLen'}, $cnlType{$test}{'phyAddr'} ) ."\n";
-}
 # prefil cnlType with list1's
 foreach my $rLKey (sort keys %rL) {	
 	my $test = sprintf("%.2d %.2d", $rLKey, 1);
-	
-	if (!$cnlType{$test}) {
-		$cnlType{$test}{'cnl'} = $rLKey;
-		$cnlType{$test}{'lst'} = 1;
-		$cnlType{$test}{'slcIdx'} = 0;
-		$cnlType{$test}{'slcLen'} = 0;
-		$cnlType{$test}{'phyAddr'} = 0;
-		$cnlType{$test}{'hidden'} = $rL{$rLKey}{'hidden'};	
-		
-		#my @x=();
-		#$cnlType{$test}{'regSet'} = @x;
-		#print "nicht vorhanden\n";
-
-	}
-
-	
-
-		
-	#print "x:  $rL{$rLKey}{'type'}     $rLKey    $test\n";
-	
-	#$peers = $rL{$cnlType{$test}{'cnl'}}{'peers'}    if( ( $cnlType{$test}{'cnl'} > 0 ) && ( $cnlType{$test}{'lst'} >= 3 ) && ( $cnlType{$test}{'lst'} <= 4 ) );
-	
-	#$cnlType{$test}{'slcIdx'}  = $slcIdx;
-	#$cnlType{$test}{'slcLen'}  = $slcLen;
-	#$cnlType{$test}{'phyAddr'} = $phyAddr;
-	#$cnlType{$test}{'peers'}   = $peers;
-
+	next          if ($cnlType{$test});
+	$cnlType{$test}{'cnl'} = $rLKey;
+	$cnlType{$test}{'lst'} = 1;
+	$cnlType{$test}{'regSet'} = [];
 }
 
+# -- eeprom layout, identical register sets share their slice in cnlAddr, the lists are packed without gaps
+# key and peers start behind the magic byte, HMID and serial, the key at 15 to 30 is used if HMKEY is empty
+my %lists = (); my %peers = ();
+foreach my $test (keys %cnlType) {
+	$lists{$test} = { 'cnl' => $cnlType{$test}{'cnl'}, 'lst' => $cnlType{$test}{'lst'}, 'regs' => $cnlType{$test}{'regSet'} };
+}
+foreach my $rLKey (keys %rL) {
+	$peers{$rLKey} = $rL{$rLKey}{'peers'};
+}
+my $eeSize = $cType{'eeSize'} || 1024;
+my $eeLay = eeLayout::pack(\%lists, \%peers, 31, $eeSize, eeLayout::slotMax($eeSize, $cType{'eeExt'}));
 
-# -- cleanup the channel array, find dublicates and reshape the addressing - fix the peers physical address, while phyAddr is at max from earlier function
 foreach my $test (sort keys %cnlType) {
-	if ( $cnlType{$test}{'lst'} == (3 || 4) ) {
-		$cnlType{$test}{'phyAddrPeers'} = $phyAddr;
-		$phyAddr += $cnlType{$test}{'peers'} * 4;
-		#print "xxx\n";
-	}
-
-	next          if ( !$cnlType{$test}{'regSet'} );  
-	next          if (!"@{ $cnlType{$test}{'regSet'}}");										# skip empty regSets
-	
-	foreach my $rest (sort {$b cmp $a} keys %cnlType) {
-		next      if ( !$cnlType{$rest}{'regSet'} );  
-		next      if ( ($test eq $rest) || (!"@{ $cnlType{$rest}{'regSet'}}") );				# comparsion of same regset makes no sense
-		
-		#print "search in $rest: @{ $cnlType{$rest}{'regSet'} } \n";							# some debug
-		#print "fits!! test:$test, rest:$rest \n"   if ( "@{$cnlType{$test}{'regSet'}}"  eq "@{$cnlType{$rest}{'regSet'}}" ) ;
-		if ( "@{$cnlType{$test}{'regSet'}}"  eq "@{$cnlType{$rest}{'regSet'}}" ) {				# found a similarity, work on the cnlType set
-			@{$cnlType{$rest}{'regSet'}} = ();													# content of regSet not needed any more
-			$cnlType{$rest}{'slcIdx'} = $cnlType{$test}{'slcIdx'};								# set the slice index
-		}
-	}	
+	my $cnl = $cnlType{$test}{'cnl'};
+	$cnlType{$test}{'regSet'}  = $lists{$test}{'regs'};
+	$cnlType{$test}{'slcIdx'}  = $lists{$test}{'sIdx'};
+	$cnlType{$test}{'slcLen'}  = $lists{$test}{'sLen'};
+	$cnlType{$test}{'phyAddr'} = $lists{$test}{'sLen'} ? $lists{$test}{'pAddr'} : 0;
+	$cnlType{$test}{'hidden'}  = ($cnl > 0) ? $rL{$cnl}{'hidden'} : 0;
+	#print sprintf("%.1d, %.1d, 0x%.2x, %.1d, 0x%.4x,", $cnl, $cnlType{$test}{'lst'}, $cnlType{$test}{'slcIdx'}, $cnlType{$test}{'slcLen'}, $cnlType{$test}{'phyAddr'} ) ."\n";
 }
-
 # -- prepare the reglist object with the details of the user module, which library to load and so on
 	# step through the modules definition, find dublicates by sort and comparsion with the former statement 
 	# eliminate the xml appreviation and print it with the include statement
@@ -359,6 +309,7 @@ printPeerDeviceListTable(\%cnlType);
 printDevDeviceListTable(\%cnlType);
 printModuleTable(\%cnlType);
 printStartFunctions();
+print "$_\n" foreach (eeLayout::report(\%lists, $eeLay));
 
 #print $cType{'battValue'};
 
@@ -510,11 +461,11 @@ sub printChannelSliceTable {
 	print "//- channel slice address definition -------------------------------------------------------------------------------------\n";
 	print "const uint8_t cnlAddr[] PROGMEM = {\n";
 	
-	foreach my $test (sort keys %dT) {
-		next    if ( !$cnlType{$test}{'regSet'} );  
-		next    if(!"@{$dT{$test}{'regSet'}}");	
-		print "    " .sprintf( "0x%.2x," x @{$dT{$test}{'regSet'}}, @{$dT{$test}{'regSet'}} )."\n";
-		$cnt += scalar(@{$dT{$test}{'regSet'}});
+	foreach my $slc (@{$eeLay->{'slices'}}) {
+		my @regs = @{$slc->{'regs'}};
+		print sprintf("    // 0x%.2x, %s - %s\n", $slc->{'sIdx'}, join(' ', map { sprintf("cnl %d list %d", $lists{$_}{'cnl'}, $lists{$_}{'lst'}) } sort @{$slc->{'users'}}), eeLayout::offsetMap(\@regs));
+		print "    " .sprintf( "0x%.2x," x @regs, @regs )."\n";
+		$cnt += scalar(@regs);
 	}
 	print "};  // $cnt byte\n\n"; 
 }
@@ -538,10 +489,9 @@ sub printPeerDeviceListTable {
 	print "//- peer device list table -----------------------------------------------------------------------------------------------\n";
 	print "EE::s_peerTbl peerTbl[] = {\n";
 	print "    // cnl, pMax, pAddr;\n";
-	foreach my $test (sort keys %dT) {
-		next    if ( $dT{$test}{'lst'} != (3 || 4) );
-		#	{1, 6, 0x001a}              //  6 * 4 =  24 (0x18)
-		print sprintf("    { %.1d, %.1d, 0x%.4x, },\n", $dT{$test}{'cnl'}, $dT{$test}{'peers'}, $dT{$test}{'phyAddrPeers'} );
+	foreach my $cnl (sort { $a <=> $b } keys %{$eeLay->{'peerTbl'}}) {
+		my $p = $eeLay->{'peerTbl'}{$cnl};
+		print sprintf("    { %.1d, %.1d, 0x%.4x, },\n", $cnl, $p->{'pMax'}, $p->{'pAddr'} );
 		$cnt += 4;
 	}
 	print "};  // $cnt byte\n\n";
@@ -552,10 +502,7 @@ sub printDevDeviceListTable {
 
 	my $nLsIt = scalar keys %dT;																	# get amount of list items
 
-	my $nCnlC = 0;																					# get amount of user channels
-	foreach my $test (sort keys %dT) {
-		$nCnlC += 1    if ( $dT{$test}{'lst'} == (3 || 4) );
-	}
+	my $nCnlC = scalar keys %{$eeLay->{'peerTbl'}};												# get amount of user channels
 	
 	print "//- handover to AskSin lib -----------------------------------------------------------------------------------------------\n";
 	print "EE::s_devDef devDef = {\n";
@@ -566,10 +513,7 @@ sub printDevDeviceListTable {
 sub printModuleTable {
 	my %dT = %{shift()}; my $cnt = 0;
 
-	my $nCnlC = 0;																					# get amount of user channels
-	foreach my $test (sort keys %dT) {
-		$nCnlC += 1    if ( $dT{$test}{'lst'} == (3 || 4) );
-	}
+	my $nCnlC = scalar keys %{$eeLay->{'peerTbl'}};												# get amount of user channels
 	print "//- module registrar -----------------------------------------------------------------------------------------------------\n";
 	print "RG::s_modTable modTbl[$nCnlC];\n\n";
 }
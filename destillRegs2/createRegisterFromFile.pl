@@ -2,29 +2,24 @@ use strict;
 use warnings;
 use diagnostics;
 use XML::LibXML;
+use FindBin; use lib $FindBin::Bin;
+use eeLayout;
 
 my $dir = 'devicetypes';																					# directory with the HM device files
 
-#-- some functions -------------------------------------------------------------------------------------
-# @array=&del_double(@array);
-sub del_double {
-	my %all=();
-	@all{@_}=1;
-	return (sort { $a cmp $b } keys %all);
-}
-
-
 #-------------------------------------------------------------------------------------------------------
 #-- quit unless we have the correct number of command-line args ----------------------------------------
 my $num_args = $#ARGV + 1;
-if ($num_args != 2) {
-    print "\nUsage: createRegisterFromFile.pl rf_file dev_id\n";
+if (($num_args < 2) || ($num_args > 3)) {
+    print "\nUsage: createRegisterFromFile.pl rf_file dev_id [ee_size]\n";
+    print "  ee_size - eeprom size in byte, default 1024, the peers are checked against it and 'max' peers fill it\n";
     exit;
 }
  
 #-- we got two command line args, so assume they are the rf_file and dev_id ----------------------------
 my $rf_file=$ARGV[0];
 my $dev_id=$ARGV[1];
+my $ee_size=($num_args == 3) ? eval($ARGV[2]) : 1024;
 
 
 #-- create parser object -------------------------------------------------------------------------------
@@ -283,14 +278,11 @@ foreach my $item (sort{$a <=> $b}(keys %cnlConf)) {
 
 #-------------------------------------------------------------------------------------------------------
 #-- creation of channel table --------------------------------------------------------------------------
-my $tempPhyAddr = 15;																						# starts at 15 while in front of the magic number, the serial and the HMID
-my %cnlAddr = ();																							# holds the slice string
+my %lists = ();																								# register sets per cnl/lst for eeLayout
+my %peers = ();																								# wanted peers per channel
 my %cnlTbl = ();																							# the channel table
 my %peerTbl = ();																							# the peer table
 
-my @tempSlcArray = ();
-
-
 #stepping through the table
 foreach my $item ( sort { $a cmp $b } keys %cnlTypeA) {
 	my $h = $cnlTypeA{$item};
@@ -298,71 +290,36 @@ foreach my $item ( sort { $a cmp $b } keys %cnlTypeA) {
 	my $cnlTblID = sprintf('%.2x %.2x', $h->{'cnl'}, $h->{'lst'} );											# generating id for the hash
 
 	#check if cnl/lst combination still exist, if not add it and collect the different regs in an array
-	push ( @{ $cnlAddr{$cnlTblID} }, sprintf('0x%.2x,', $h->{'reg'}) );										# writing all regs in the respective array	
-
-	#prepare the channel table
-	$cnlTbl{ $cnlTblID } = {'cnl' => $h->{'cnl'}, 'lst' => $h->{'lst'}, 'sIdx' => 0, 'sLen' => 0, 'pAddr' => 0, 'peer' => 0  };
-
+	$lists{$cnlTblID} = { 'cnl' => $h->{'cnl'}, 'lst' => $h->{'lst'}, 'regs' => [] }	if (!$lists{$cnlTblID});
+	push ( @{ $lists{$cnlTblID}{'regs'} }, $h->{'reg'} );													# writing all regs in the respective array, eeLayout drops the doubles
 }
 
-#-- cleanout doubles in channel table arrays and further prepare of channel table
-foreach my $item ( sort { $a cmp $b } keys %cnlAddr) {														# stepping through the hash of arrays
-	my $h = $cnlAddr{$item};																				# setting pointer
-	@{ $h } = del_double(@{ $h });																			# deleting doubles
-	
-	$cnlTbl{$item}{'sLen'} = scalar @{ $h };																# calculating and storing slice len
-
-	# shorten the slice table while slices are doubled
-	my $t = 1+index( "@tempSlcArray", "@{$h}" );															# find the index in the slice string
-	if ($t > 0) {$t -= 1; $t /= 6;}																			# divide it by 6 because of length of one element
-	#print "$t, \n";
-
-	if ($t > 0) {																							# while already in the index
-		$cnlTbl{$item}{'sIdx'} = $t;																		# remember the index
-		delete $cnlAddr{$item};																				# item not needed any more
-				
-	} else {																								# not in the index
-		$cnlTbl{$item}{'sIdx'} = scalar @tempSlcArray;														# remember the index
-		push (@tempSlcArray, @{ $h });																		# add current state to slice array but only if cnl/lst slice was not found
-	}
-	
-	# getting the amount of peers
-	if (($cnlTbl{$item}{'lst'} == 3) || ($cnlTbl{$item}{'lst'} == 4)) {
-		print "Please enter the amount of peers you wish for channel: $cnlTbl{$item}{'cnl'}, list: $cnlTbl{$item}{'lst'}\n";
-		print "# Peers: ";
-
-		my $peers = 6;
-		chomp ($peers = <STDIN>);
-		$cnlTbl{$item}{'peer'} = $peers;
-		
-		print "\n";
-	} 
+#-- getting the amount of peers, only valid for list 3 or 4
+foreach my $item ( sort { $a cmp $b } keys %lists) {
+	my $h = $lists{$item};
+	next if ((($h->{'lst'} != 3) && ($h->{'lst'} != 4)) || (defined $peers{$h->{'cnl'}}));
 
-	# calculating the addresses in channel table
-	$cnlTbl{$item}{'pAddr'} = $tempPhyAddr;																	# adding the new start address to the channel table item
+	print "Please enter the amount of peers you wish for channel: $h->{'cnl'}, list: $h->{'lst'}, 'max' fills the eeprom\n";
+	print "# Peers: ";
 
-	if ( ($cnlTbl{$item}{'peer'}) > 0) {																	# calculation is different when peer is 0
-		$tempPhyAddr += ($cnlTbl{$item}{'sLen'} * $cnlTbl{$item}{'peer'});									# length of string multiplied by amount of peers
-		#print ">0  $tempPhyAddr \n";
+	my $peers = 6;
+	chomp ($peers = <STDIN>);
+	$peers{$h->{'cnl'}} = $peers;
 
-		# creating peer table, because only valid for list 3 or 4
-		$peerTbl{$item} = { 'cnl' => $cnlTbl{$item}{'cnl'}, 'peer' => $cnlTbl{$item}{'peer'}, 'pAddr' => 0 };
-		
-	} else {
-		$tempPhyAddr += $cnlTbl{$item}{'sLen'};																# adding only the length
-		#print "=0  $tempPhyAddr \n";
-		
-	}
+	print "\n";
 }
 
+#-- packing of slices and eeprom, starts at 15 while in front of the magic number, the serial and the HMID
+my $eeLay = eeLayout::pack(\%lists, \%peers, 15, $ee_size, eeLayout::slotMax($ee_size));
 
-#-- calculating peer addresses in eeprom ---------------------------------------------------------------
-foreach my $item ( sort { $a cmp $b } keys %peerTbl) {
-	my $h = $peerTbl{$item};
-
-	$h->{'pAddr'} = $tempPhyAddr;
-	$tempPhyAddr += ($h->{'peer'} * 4);																		# every peer needs 4 bytes
-
+foreach my $item ( sort { $a cmp $b } keys %lists) {
+	my $h = $lists{$item};
+	my $p = $eeLay->{'peerTbl'}{$h->{'cnl'}};
+	$cnlTbl{$item} = {'cnl' => $h->{'cnl'}, 'lst' => $h->{'lst'}, 'sIdx' => $h->{'sIdx'}, 'sLen' => $h->{'sLen'}, 'pAddr' => $h->{'pAddr'}, 'peer' => $p ? $p->{'pMax'} : 0 };
+}
+foreach my $cnl (sort { $a <=> $b } keys %{$eeLay->{'peerTbl'}}) {
+	my $p = $eeLay->{'peerTbl'}{$cnl};
+	$peerTbl{sprintf('%.2x', $cnl)} = { 'cnl' => $cnl, 'peer' => $p->{'pMax'}, 'pAddr' => $p->{'pAddr'} };
 }
 
 
@@ -428,9 +385,11 @@ print "//- ---------------------------------------------------------------------
 print "//- channel slice address definition -------------------------------------------------------------------------------------\n";
 print "const uint8_t cnlAddr[] PROGMEM = {\n";
 my $xSize = 0;
-foreach my $item ( sort { $a cmp $b } keys %cnlAddr) {
-	print "    @{$cnlAddr{$item}}\n";
-	$xSize += scalar @{$cnlAddr{$item}};
+foreach my $slc (@{$eeLay->{'slices'}}) {																	# one line per slice, shared slices only once
+	my @regs = @{$slc->{'regs'}};
+	print sprintf("    // 0x%.2x, %s - %s\n", $slc->{'sIdx'}, join(' ', map { sprintf("cnl %d list %d", $lists{$_}{'cnl'}, $lists{$_}{'lst'}) } sort @{$slc->{'users'}}), eeLayout::offsetMap(\@regs));
+	print "    " .sprintf("0x%.2x, " x @regs, @regs) ."\n";
+	$xSize += scalar @regs;
 }
 print "};  // $xSize byte\n\n";
 
@@ -467,6 +426,9 @@ print "};  // 10 byte\n\n";
 print "//- module registrar -----------------------------------------------------------------------------------------------------\n";
 print "RG::s_modTable modTbl[" .scalar(keys %peerTbl) ."];\n\n";
 
+print "//- eeprom layout --------------------------------------------------------------------------------------------------------\n";
+print "$_\n" foreach (eeLayout::report(\%lists, $eeLay));
+
 
 print "\n\n//- ----------------------------------------------------------------------------------------------------------------------\n";
 print "//- only if needed -------------------------------------------------------------------------------------------------------\n";
@@ -498,9 +460,8 @@ foreach my $item ( sort { $a cmp $b } keys %cnlTypeA) {
 		$lastBte = 0;																						# no former byte to fill
 		$cnlLstCnt = 0;
 
-		my $x = $cnlTbl{ sprintf('%.2x %.2x', $h->{'cnl'}, $h->{'lst'} ) };									# generating id for the hash
-		my $sStr = substr("@tempSlcArray", $x->{'sIdx'} * 6, $x->{'sLen'} * 6 );
-		print "// $sStr\n";
+		my $x = $lists{ sprintf('%.2x %.2x', $h->{'cnl'}, $h->{'lst'} ) };									# generating id for the hash
+		print "// " .eeLayout::offsetMap($x->{'regs'}) ."\n";
 
 	}
 	$lastCnl = $h->{'cnl'};																					# remember the current channel and list
@@ -48,6 +48,9 @@ my %confType = (
     battVisib   => 0,                                      # battery flag visible in registers of channel 0
     battChkDura => 3600000,	                               # the time between two measurements, value in milli seconds
 
+    eeSize      => 1024,                                   # eeprom size in byte (E2END + 1), the lists and peers have to fit in
+    eeExt       => 0,                                      # 1 for an external i2c eeprom (EE_EXT), allows up to 254 peers per channel
+
 	powerMode   => 0,                                      # there are 5 power modes available, which could be choosed to get the best ratio between power consumption and availablity
                                                            # 0, now power saving - 19.9ma
                                                            # 1, wake up every 250ms, check for wakeup signal on air and stay awake accordingly, timer gets updated every 256ms
@@ -60,6 +63,7 @@ my %confType = (
 ## -- channel config ----------------------------------------------------------------------------------------
 ## predefined type in linkset.xml choose xmlDimmer, xmlSwitch, xmlKey, xmlWeather - more to come
 ## peers reflects the amount of possible peers, hidden makes a channel hidden for the config software, but will still work
+## peers => 'max' gives the channel as many peers as fit into eeSize
 ## with linked you can link channels together, e.g. key to dimmer
 ## todo: linked
 
@@ -0,0 +1,161 @@
+## -- eeprom layout of register.h ---------------------------------------------------------------------------
+## shared by createReg.pl and createRegisterFromFile.pl. takes the channel lists with their register addresses and the
+## wanted peers per channel and computes cnlAddr, sIdx, sLen and pAddr of cnlTbl and the peer table.
+## - a register set which is already part of cnlAddr (same set on another channel, or a run of a longer set) is not
+##   stored again, the list points into the existing slice
+## - the eeprom regions follow each other without gaps, the lists in cnlTbl order, then the peer tables
+## - 'max' instead of an amount of peers gives the channel as many peers as fit into the eeprom budget, channels with
+##   'max' share the free bytes evenly
+use strict; package eeLayout;
+
+
+## slotMax($eeSize, $eeExt)
+##   peer slots a channel may have at most, maxPeerSlots in EEprom.h: 254 with EE_EXT, 64 with the internal eeprom. an
+##   eeprom above the 4096 byte of the biggest avr is an external one, also without $eeExt
+sub slotMax {
+	my ($eeSize, $eeExt) = @_;
+	return (($eeExt) || ($eeSize > 4096)) ? 254 : 64;
+}
+
+## pack(\%lists, \%peers, $base, $budget, $slotMax)
+##   %lists   - key => { cnl, lst, regs => [register addresses] }, keys sort in cnlTbl order
+##   %peers   - cnl => amount of peers or 'max', only channels with list 3 or 4 get a peer table
+##   $base    - first eeprom address after the header (magic byte, HMID, serial and maybe the key)
+##   $budget  - eeprom size in byte, E2END + 1
+##   $slotMax - peer slots a channel may have at most, see slotMax
+## fills sIdx, sLen and pAddr into the list entries, returns a hash with
+##   slices   - [ { sIdx, regs => [...], users => [list keys] } ], the lines of cnlAddr
+##   peerTbl  - { cnl => { pMax, pAddr, perPeer } }
+##   used, budget, base, free, slotMax
+sub pack {
+	my ($lists, $peers, $base, $budget, $slotMax) = @_;
+	$slotMax = 64 if (!$slotMax);
+	$slotMax = 254 if ($slotMax > 254);															# pMax is a byte, 0xff marks the end of a cursor
+
+	# -- cnlAddr in cnlTbl order, sets which are a run of a longer one wait until the longer one is placed
+	my @cnlAddr = (); my @slices = ();
+	foreach my $key (keys %{$lists}) {
+		my $l = $lists->{$key};
+		my @regs = sort { $a <=> $b } keys %{{ map { $_ => 1 } @{$l->{'regs'}} }};				# ascending and without doubles, getRegOffset relies on it
+		$l->{'regs'} = \@regs;
+		$l->{'sLen'} = scalar @regs;
+		$l->{'sIdx'} = 0;
+	}
+	my @order = grep { $lists->{$_}{'sLen'} } sort keys %{$lists};									# empty lists need no slice
+	my @inner = grep { my $k = $_; grep { ($lists->{$_}{'sLen'} > $lists->{$k}{'sLen'}) && (findRun($lists->{$_}{'regs'}, $lists->{$k}{'regs'}) >= 0) } @order } @order;
+	my %inner = map { $_ => 1 } @inner;
+	foreach my $key ((grep { !$inner{$_} } @order), @inner) {
+		my $l = $lists->{$key};
+		my $at = findRun(\@cnlAddr, $l->{'regs'});
+		if ($at < 0) {																				# new slice
+			$at = scalar @cnlAddr;
+			push @cnlAddr, @{$l->{'regs'}};
+			push @slices, { 'sIdx' => $at, 'regs' => [ @{$l->{'regs'}} ], 'users' => [] };
+		}
+		$l->{'sIdx'} = $at;
+		foreach my $s (@slices) {																	# remember who uses the slice
+			push @{$s->{'users'}}, $key if (($at >= $s->{'sIdx'}) && ($at < $s->{'sIdx'} + scalar(@{$s->{'regs'}})));
+		}
+	}
+	die "cnlAddr has " .scalar(@cnlAddr) ." byte, sIdx is a byte\n" if (scalar(@cnlAddr) > 256);
+
+	# -- bytes per peer and fixed bytes
+	my %perPeer = (); my $fixed = $base;
+	foreach my $key (sort keys %{$lists}) {
+		my $l = $lists->{$key};
+		if ((($l->{'lst'} == 3) || ($l->{'lst'} == 4)) && ($l->{'cnl'} > 0)) {
+			$perPeer{$l->{'cnl'}} = 4 if (!$perPeer{$l->{'cnl'}});									# the peer itself
+			$perPeer{$l->{'cnl'}} += $l->{'sLen'};
+		} else {
+			$fixed += $l->{'sLen'};
+		}
+	}
+
+	# -- amount of peers, 'max' channels share what is left
+	my %pMax = (); my $maxSum = 0;
+	foreach my $cnl (sort { $a <=> $b } keys %perPeer) {
+		my $p = defined($peers->{$cnl}) ? $peers->{$cnl} : 1;
+		if ($p eq 'max') { $maxSum += $perPeer{$cnl}; next; }
+		die "channel $cnl: $p peers, maxPeerSlots is $slotMax\n" if ($p > $slotMax);
+		$pMax{$cnl} = $p;
+		$fixed += $p * $perPeer{$cnl};
+	}
+	if ($maxSum) {
+		my $n = int(($budget - $fixed) / $maxSum);
+		$n = $slotMax if ($n > $slotMax);
+		die "no eeprom left for the 'max' channels, $fixed of $budget byte are used already\n" if ($n < 1);
+		foreach my $cnl (keys %perPeer) {
+			$pMax{$cnl} = $n if (!defined($pMax{$cnl}));
+		}
+	}
+
+	# -- eeprom addresses, lists in cnlTbl order, then the peer tables
+	my $addr = $base;
+	foreach my $key (sort keys %{$lists}) {
+		my $l = $lists->{$key};
+		$l->{'pAddr'} = $addr;
+		$addr += $l->{'sLen'} * ((defined($pMax{$l->{'cnl'}}) && (($l->{'lst'} == 3) || ($l->{'lst'} == 4))) ? $pMax{$l->{'cnl'}} : 1);
+	}
+	my %peerTbl = ();
+	foreach my $cnl (sort { $a <=> $b } keys %pMax) {
+		$peerTbl{$cnl} = { 'pMax' => $pMax{$cnl}, 'pAddr' => $addr, 'perPeer' => $perPeer{$cnl} };
+		$addr += $pMax{$cnl} * 4;
+	}
+	die "eeprom layout needs $addr byte, budget is $budget\n" if ($addr > $budget);
+
+	return { 'slices' => \@slices, 'peerTbl' => \%peerTbl, 'used' => $addr, 'budget' => $budget, 'base' => $base, 'free' => $budget - $addr, 'slotMax' => $slotMax };
+}
+
+## index of the run @$regs within @$arr or -1
+sub findRun {
+	my ($arr, $regs) = @_;
+	my $n = scalar @{$regs};
+	for (my $i = 0; $i + $n <= scalar @{$arr}; $i++) {
+		my $j = 0;
+		$j++ while (($j < $n) && ($arr->[$i + $j] == $regs->[$j]));
+		return $i if ($j == $n);
+	}
+	return -1;
+}
+
+## register offset map of a slice, the runs of ascending addresses with their byte offset in the list, like
+## "0x01-0x1a +0, 0x26-0x29 +26". a run is one INFO_PARAM_RESPONSE_SEQ frame of up to 15 registers
+sub offsetMap {
+	my @regs = @{shift()};
+	my @runs = (); my $i = 0;
+	while ($i < scalar @regs) {
+		my $n = 1;
+		$n++ while (($i + $n < scalar @regs) && ($regs[$i + $n] == $regs[$i] + $n));
+		push @runs, ($n > 1) ? sprintf("0x%.2x-0x%.2x +%d", $regs[$i], $regs[$i + $n - 1], $i) : sprintf("0x%.2x +%d", $regs[$i], $i);
+		$i += $n;
+	}
+	return join(', ', @runs);
+}
+
+## report of the layout as comment lines for register.h
+sub report {
+	my ($lists, $lay) = @_;
+	my @r = ();
+	push @r, sprintf("//- eeprom: %d of %d byte used, %d byte free", $lay->{'used'}, $lay->{'budget'}, $lay->{'free'});
+	push @r, sprintf("//-   header       %5d byte", $lay->{'base'});
+	foreach my $key (sort keys %{$lists}) {
+		my $l = $lists->{$key};
+		next if (!$l->{'sLen'});
+		my $p = $lay->{'peerTbl'}{$l->{'cnl'}};
+		my $n = ((($l->{'lst'} == 3) || ($l->{'lst'} == 4)) && ($p)) ? $p->{'pMax'} : 1;
+		push @r, sprintf("//-   cnl %d list %d %5d byte at 0x%.4x (%d x %d)", $l->{'cnl'}, $l->{'lst'}, $l->{'sLen'} * $n, $l->{'pAddr'}, $n, $l->{'sLen'});
+	}
+	foreach my $cnl (sort { $a <=> $b } keys %{$lay->{'peerTbl'}}) {
+		my $p = $lay->{'peerTbl'}{$cnl};
+		push @r, sprintf("//-   cnl %d peers  %5d byte at 0x%.4x (%d x 4)", $cnl, $p->{'pMax'} * 4, $p->{'pAddr'}, $p->{'pMax'});
+	}
+	foreach my $cnl (sort { $a <=> $b } keys %{$lay->{'peerTbl'}}) {
+		my $p = $lay->{'peerTbl'}{$cnl};
+		my $more = int($lay->{'free'} / $p->{'perPeer'});
+		$more = $lay->{'slotMax'} - $p->{'pMax'} if ($p->{'pMax'} + $more > $lay->{'slotMax'});
+		push @r, sprintf("//- cnl %d: %d peers, %d byte per peer, the free bytes take %d more", $cnl, $p->{'pMax'}, $p->{'perPeer'}, $more);
+	}
+	return @r;
+}
+
+1;
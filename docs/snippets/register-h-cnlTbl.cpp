@@ -1,4 +1,4 @@
-EE::s_cnlTbl cnlTbl[] = {
+EE_CONST EE::s_cnlTbl cnlTbl[] = {
     // cnl, lst, sIdx, sLen, pAddr;
     {  0,  0, 0x00, 10,  0x000f }, // Channel0/List0, 10 bytes at sIdx 0x00, Addr 0x000f
     {  1,  4, 0x0a,  1,  0x0019 }, // Channel1/List4,  1 byte  at sIdx 0x0a, Addr 0x0019
@@ -190,7 +190,7 @@ void serialEvent(void) {
 		uint8_t inChar = (uint8_t)Serial.read();											// read a byte
 		if (inChar == '\n') {																// send to receive routine
 			i = 0;
-			hm.sn.active = 1;
+			hm.sn.push(sndPrioConfig);
 		}
 		
 		if      ((inChar>96) && (inChar<103)) inChar-=87;									// a - f
@@ -24,28 +24,29 @@ const uint8_t devIdnt[] PROGMEM = {
 
 //- ----------------------------------------------------------------------------------------------------------------------
 //- channel slice address definition -------------------------------------------------------------------------------------
-const uint8_t cnlAddr[] PROGMEM = {
+EE_CONST uint8_t cnlAddr[] PROGMEM = {
 	0x01,0x02,0x0a,0x0b,0x0c,
 	0x01,
 }; // 6 byte
 
 //- channel device list table --------------------------------------------------------------------------------------------
-EE::s_cnlTbl cnlTbl[] = {
+EE_CONST EE::s_cnlTbl cnlTbl[] = {
 	// cnl, lst, sIdx, sLen, pAddr;
 	{0, 0, 0x00,  5, 0x000f},
 	{1, 4, 0x05,  1, 0x0014},   //  1 *  6 =   6 (0x0006)
 }; // 12 byte
 
 //- peer device list table -----------------------------------------------------------------------------------------------
-EE::s_peerTbl peerTbl[] = {
+EE_CONST EE::s_peerTbl peerTbl[] = {
 	// cnl, pMax, pAddr;
 	{1, 6, 0x001a}              //  6 * 4 =  24 (0x18)
 }; // 4 byte
 
 //- handover to AskSin lib -----------------------------------------------------------------------------------------------
-EE::s_devDef devDef = {
+EE_CONST EE::s_devDef devDef = {
 	1, 2, devIdnt, cnlAddr,
 }; // 6 byte
+EE_CHECK_TABLES();                                                      // let the compiler check the tables above
 
 //- module registrar -----------------------------------------------------------------------------------------------------
 RG::s_modTable modTbl[1];
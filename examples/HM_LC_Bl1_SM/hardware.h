@@ -103,6 +103,11 @@
 		#define BATT_MEASURE_PORT      PORTF
 		#define BATT_MEASURE_PIN       PORTF7
 
+	#elif defined(__linux__)
+		//- linux host, cc1101, led's and pins are simulated by HAL_linux -----------------------------------------------
+		#define CONFIG_KEY_PCIE        0										// pin change interrupt port bit
+		#define CONFIG_KEY_INT         0										// pin interrupt
+
 	#else
 		#error "Error: cc1100 CS and GDO0 not defined for your hardware in hardware.h!"
 	#endif
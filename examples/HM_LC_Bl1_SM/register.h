@@ -34,14 +34,14 @@ const uint8_t devIdnt[] PROGMEM = {
 
 //- ----------------------------------------------------------------------------------------------------------------------
 //- channel slice address definition -------------------------------------------------------------------------------------
-const uint8_t cnlAddr[] PROGMEM = {
+EE_CONST uint8_t cnlAddr[] PROGMEM = {
     0x02,0x0a,0x0b,0x0c,0x12,0x18,
     0x0b,0x0d,0x0f,0x10,
     0x01,0x02,0x03,0x04,0x05,0x06,0x07,0x08,0x09,0x0a,0x0b,0x0c,0x0d,0x0f,0x11,0x1c,0x1d,0x1e,0x1f,0x81,0x82,0x83,0x84,0x85,0x86,0x87,0x88,0x89,0x8a,0x8b,0x8c,0x8d,0x8f,0x91,0x9c,0x9d,0x9e,0x9f,
 };  // 48 byte
 
 //- channel device list table --------------------------------------------------------------------------------------------
-EE::s_cnlTbl cnlTbl[] = {
+EE_CONST EE::s_cnlTbl cnlTbl[] = {
     // cnl, lst, sIdx, sLen, pAddr, hidden
     { 0, 0, 0x00,  6, 0x001f, 0, },
     { 1, 1, 0x06,  4, 0x0025, 0, },
@@ -49,15 +49,16 @@ EE::s_cnlTbl cnlTbl[] = {
 };  // 21 byte
 
 //- peer device list table -----------------------------------------------------------------------------------------------
-EE::s_peerTbl peerTbl[] = {
+EE_CONST EE::s_peerTbl peerTbl[] = {
     // cnl, pMax, pAddr;
     { 1, 6, 0x010d, },
 };  // 4 byte
 
 //- handover to AskSin lib -----------------------------------------------------------------------------------------------
-EE::s_devDef devDef = {
+EE_CONST EE::s_devDef devDef = {
     1, 3, devIdnt, cnlAddr,
 };  // 6 byte
+EE_CHECK_TABLES();                                                      // let the compiler check the tables above
 
 //- module registrar -----------------------------------------------------------------------------------------------------
 RG::s_modTable modTbl[1];
@@ -76,10 +76,7 @@ void initDim(uint8_t channel) {
 
 }
 void switchDim(uint8_t channel, uint8_t status, uint8_t characteristic) {
-	#ifdef SER_DBG
-		dbg << F("switchDim: ") << channel << ", " << status << ", " << characteristic << "\n";
-	#endif
-
+	// called out of the timer interrupt while the dimmer ramps, so no debug output here
 	uint16_t x = status*255;
 	x /= 200;																				// status = 0 to 200, but PWM needs 255 as maximum
 	OCR2B = x;																				// set the PWM value to the pin
@@ -97,7 +94,7 @@ void serialEvent() {
 		uint8_t inChar = (uint8_t)Serial.read();											// read a byte
 		if (inChar == '\n') {																// send to receive routine
 			i = 0;
-			hm.sn.active = 1;
+			hm.sn.push(sndPrioConfig);
 		}
 		
 		if      ((inChar>96) && (inChar<103)) inChar-=87;									// a - f
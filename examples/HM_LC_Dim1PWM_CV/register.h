@@ -36,14 +36,36 @@ const uint8_t devIdnt[] PROGMEM = {
 
 //- ----------------------------------------------------------------------------------------------------------------------
 //- channel slice address definition -------------------------------------------------------------------------------------
-const uint8_t cnlAddr[] PROGMEM = {
+EE_CONST uint8_t cnlAddr[] PROGMEM = {
 	0x02,0x0a,0x0b,0x0c,0x12,0x18,
 	0x30,0x32,0x34,0x35,0x56,0x57,0x58,0x59,
 	0x01,0x02,0x03,0x04,0x05,0x06,0x07,0x08,0x09,0x0a,0x0b,0x0c,0x0d,0x0e,0x0f,0x10,0x11,0x12,0x13,0x14,0x15,0x16,0x17,0x18,0x19,0x1a,0x26,0x27,0x28,0x29,0x81,0x82,0x83,0x84,0x85,0x86,0x87,0x88,0x89,0x8a,0x8b,0x8c,0x8d,0x8e,0x8f,0x90,0x91,0x92,0x93,0x94,0x95,0x96,0x97,0x98,0x99,0x9a,0xa6,0xa7,0xa8,0xa9,
 };  // 74 byte
 
 //- channel device list table --------------------------------------------------------------------------------------------
-EE::s_cnlTbl cnlTbl[] = {
+#ifdef EE_EXT
+// external i2c eeprom, see HAL.h, room for 200 peers on channel 1
+EE_CONST EE::s_cnlTbl cnlTbl[] = {
+	// cnl, lst, sIdx, sLen, pAddr, hidden
+	{ 0, 0, 0x00,  6, 0x000f, 0, },
+	{ 1, 1, 0x06,  8, 0x0015, 0, },
+	{ 1, 3, 0x0e, 60, 0x001d, 0, },
+	{ 2, 1, 0x06,  8, 0x2efd, 0, },
+	{ 2, 3, 0x0e, 60, 0x2f05, 0, },
+	{ 3, 1, 0x06,  8, 0x2f41, 0, },
+	{ 3, 3, 0x0e, 60, 0x2f49, 0, },
+};  // 49 byte
+
+//- peer device list table -----------------------------------------------------------------------------------------------
+EE_CONST EE::s_peerTbl peerTbl[] = {
+	// cnl, pMax, pAddr;
+	{ 1, 200, 0x2f85, },
+	{ 2, 1, 0x32a5, },
+	{ 3, 1, 0x32a9, },
+};  // 12 byte
+#else
+//- channel device list table --------------------------------------------------------------------------------------------
+EE_CONST EE::s_cnlTbl cnlTbl[] = {
 	// cnl, lst, sIdx, sLen, pAddr, hidden
 	{ 0, 0, 0x00,  6, 0x000f, 0, },
 	{ 1, 1, 0x06,  8, 0x0015, 0, },
@@ -55,17 +77,19 @@ EE::s_cnlTbl cnlTbl[] = {
 };  // 49 byte
 
 //- peer device list table -----------------------------------------------------------------------------------------------
-EE::s_peerTbl peerTbl[] = {
+EE_CONST EE::s_peerTbl peerTbl[] = {
 	// cnl, pMax, pAddr;
 	{ 1, 6, 0x020d, },
 	{ 2, 1, 0x0225, },
 	{ 3, 1, 0x0229, },
 };  // 12 byte
+#endif
 
 //- handover to AskSin lib -----------------------------------------------------------------------------------------------
-EE::s_devDef devDef = {
+EE_CONST EE::s_devDef devDef = {
 	3, 7, devIdnt, cnlAddr,
 };  // 6 byte
+EE_CHECK_TABLES();                                                      // let the compiler check the tables above
 
 //- module registrar -----------------------------------------------------------------------------------------------------
 RG::s_modTable modTbl[3];
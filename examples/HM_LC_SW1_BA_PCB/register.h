@@ -34,29 +34,31 @@ const uint8_t devIdnt[] PROGMEM = {
 
 //- ----------------------------------------------------------------------------------------------------------------------
 //- channel slice address definition -------------------------------------------------------------------------------------
-const uint8_t cnlAddr[] PROGMEM = {
+EE_CONST uint8_t cnlAddr[] PROGMEM = {
 	0x02,0x0a,0x0b,0x0c,0x12,0x18,
+	0x08,
 	0x02,0x03,0x04,0x05,0x06,0x07,0x08,0x09,0x0a,0x0b,0x0c,0x82,0x83,0x84,0x85,0x86,0x87,0x88,0x89,0x8a,0x8b,0x8c,
-};  // 28 byte
+};  // 29 byte
 
 //- channel device list table --------------------------------------------------------------------------------------------
-EE::s_cnlTbl cnlTbl[] = {
+EE_CONST EE::s_cnlTbl cnlTbl[] = {
 	// cnl, lst, sIdx, sLen, pAddr, hidden
 	{ 0, 0, 0x00,  6, 0x000f, 0, },
-	{ 1, 1, 0x00,  0, 0x0000, 0, },
-	{ 1, 3, 0x06, 22, 0x0015, 0, },
+	{ 1, 1, 0x06,  1, 0x0015, 0, },
+	{ 1, 3, 0x07, 22, 0x0016, 0, },
 };  // 21 byte
 
 //- peer device list table -----------------------------------------------------------------------------------------------
-EE::s_peerTbl peerTbl[] = {
+EE_CONST EE::s_peerTbl peerTbl[] = {
 	// cnl, pMax, pAddr;
-	{ 1, 6, 0x0099, },
+	{ 1, 6, 0x009a, },
 };  // 4 byte
 
 //- handover to AskSin lib -----------------------------------------------------------------------------------------------
-EE::s_devDef devDef = {
+EE_CONST EE::s_devDef devDef = {
 	1, 3, devIdnt, cnlAddr,
 };  // 6 byte
+EE_CHECK_TABLES();                                                      // let the compiler check the tables above
 
 //- module registrar -----------------------------------------------------------------------------------------------------
 RG::s_modTable modTbl[1];
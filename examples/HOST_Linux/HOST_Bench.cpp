@@ -0,0 +1,403 @@
+//- -----------------------------------------------------------------------------------------------------------------------
+// AskSin driver implementation
+// 2013-08-03 <trilu@gmx.de> Creative Commons - http://creativecommons.org/licenses/by-nc-sa/3.0/de/
+//- -----------------------------------------------------------------------------------------------------------------------
+//- AskSin host benchmark, drives the protocol hot paths of a device from the examples folder ----------------------------
+//- -----------------------------------------------------------------------------------------------------------------------
+//- usage: HOST_Bench [-n calls]
+//-   every benchmark prints one json line with the cpu time, the raw eeprom reads, the eeprom bytes read and written,
+//-   the spi bytes, the aes key expansions and blocks and the module polls and idle loops of RG per call. the counters
+//-   don't depend on the host, compare them to catch regressions. the time is only a hint, it moves with the machine and
+//-   the compiler
+//-   the aes functions are checked against the FIPS-197 vectors and a signature round trip first, exit code 1 on failure
+//- -----------------------------------------------------------------------------------------------------------------------
+
+#include <time.h>
+#include <AS.h>																				// the asksin framework
+#include "register.h"																		// configuration sheet of the device, see Makefile
+
+#ifndef DEVICE_NAME
+	#define DEVICE_NAME "unknown"
+#endif
+
+//- hardware.cpp replacement ----------------------------------------------------------------------------------------------
+void    initWakeupPin(void) {
+}
+uint8_t checkWakeupPin(void) {
+	return 0;																				// normal operation
+}
+
+//- user functions of the examples, silent --------------------------------------------------------------------------------
+void initDim(uint8_t channel) {
+}
+void switchDim(uint8_t channel, uint8_t status, uint8_t characteristic) {
+}
+void initRly(uint8_t channel) {
+}
+void switchRly(uint8_t channel, uint8_t status) {
+}
+void initBlind(uint8_t channel) {
+}
+void switchBlind(uint8_t channel, uint8_t status) {
+}
+static void txNone(uint8_t *buf, uint8_t burst) {
+}
+
+//- benchmarks ------------------------------------------------------------------------------------------------------------
+// the hot paths are protected members of AS. BM derives from AS only to name them, it is never instantiated, the member
+// pointers taken through BM are applied to hm
+class BM : public AS {
+  public:
+	static uint8_t buf[MaxDataLen+1];
+	static uint8_t plain[MaxDataLen+1];
+	static uint8_t coded[MaxDataLen+1];
+	static uint32_t cnt;
+
+	static void setup(void);
+
+	static s_aes &aesState(void) {															// signature state of hm
+		return hm.*(&BM::aes);
+	}
+	static void   run(void (AS::*fn)(void)) {												// a protected function of hm
+		(hm.*fn)();
+	}
+
+	static void decode(void) {
+		memcpy(buf, coded, coded[0]+1);
+		hm.decode(buf);
+	}
+	static void encode(void) {
+		memcpy(buf, plain, plain[0]+1);
+		hm.encode(buf);
+	}
+
+	static void intendMaster(void) {
+		static uint8_t re[] = {0x63,0x19,0x63}, pe[] = {0x63,0x19,0x63,0x01};
+		hm.ee.getIntend(re, HMID, pe);
+	}
+	static void intendPeer(void) {
+		static uint8_t re[] = {0x11,0x22,0x34}, pe[] = {0x11,0x22,0x34,0x01};
+		hm.ee.getIntend(re, HMID, pe);
+	}
+	static void intendUnknown(void) {
+		static uint8_t re[] = {0x44,0x55,0x66}, pe[] = {0x44,0x55,0x66,0x01};
+		hm.ee.getIntend(re, HMID, pe);
+	}
+	static void intendForeign(void) {
+		static uint8_t re[] = {0x44,0x55,0x66}, to[] = {0x01,0x02,0x03}, pe[] = {0x44,0x55,0x66,0x01};
+		hm.ee.getIntend(re, to, pe);
+	}
+
+	static void idxByPeerHit(void) {
+		static uint8_t pe[] = {0x11,0x22,0x34,0x01};										// last used slot
+		hm.ee.getIdxByPeer(1, pe);
+	}
+	static void idxByPeerMiss(void) {
+		static uint8_t pe[] = {0x44,0x55,0x66,0x01};
+		hm.ee.getIdxByPeer(1, pe);
+	}
+
+	static void regListSlc(uint8_t lst) {													// all slices of a list, like a CONFIG_PARAM_REQ
+		uint8_t pos = 0;
+		while (pos != 0xff) hm.ee.getRegListSlc(1, lst, 0, &pos, buf);
+	}
+	static void regListSlc1(void) {
+		regListSlc(1);
+	}
+	static void regListSlc3(void) {
+		regListSlc(3);
+	}
+	static void peerList3(void) {															// list3 of a peer event, see AS::recvMessage
+		hm.ee.getList(1, 3, 0, buf);
+	}
+	static void peerListSlc(void) {															// all slices of the peer list, like a CONFIG_PEER_LIST_REQ
+		uint8_t pos = 0;
+		while (pos != 0xff) hm.ee.getPeerListSlc(1, &pos, buf);
+	}
+
+	static void dispatch(const uint8_t *frame) {											// dispatch a decoded frame, the answer is not sent
+		memcpy(hm.rv.buf, frame, frame[0]+1);
+		run(&BM::recvMessage);
+		(hm.*(&BM::stcSlice)).active = 0;
+	}
+	static void recvParamReq(void) {
+		static const uint8_t f[] = {0x10,0x04,0x80,0x01,0x63,0x19,0x63,0xAC,0xAF,0xFF,0x01,0x04,0x11,0x22,0x30,0x01,0x03};
+		dispatch(f);
+	}
+	static void recvPeerListReq(void) {
+		static const uint8_t f[] = {0x0B,0x05,0x80,0x01,0x63,0x19,0x63,0xAC,0xAF,0xFF,0x01,0x03};
+		dispatch(f);
+	}
+	static void recvUnknown(void) {
+		static const uint8_t f[] = {0x0B,0x06,0x80,0x05,0x63,0x19,0x63,0xAC,0xAF,0xFF,0x00,0x00};
+		dispatch(f);
+	}
+
+	static uint8_t rfOurs[MaxDataLen+1];
+	static uint8_t rfForeign[MaxDataLen+1];
+	static void rcvFrame(uint8_t *frame) {													// over the air, through the fifo and the ring
+		hostRadioRcv(frame, 0x20, 0x30);
+		addMillis(30);																		// air time, the GDO0 interrupt reads the fifo
+		hm.poll();
+	}
+	static void rcvOurs(void) {
+		rcvFrame(rfOurs);
+	}
+	static void rcvForeign(void) {
+		rcvFrame(rfForeign);
+	}
+
+	static uint8_t rk[aesKeyLen];
+	static uint8_t aesCmd[MaxDataLen+1];													// a SET to channel 1, waits for the signature
+	static uint8_t aesRpl[MaxDataLen+1];													// the answer of the central to the challenge
+	static uint8_t vectors(void);
+	static void aesSetup(void);
+	static void aesReply(uint8_t *chl, uint8_t wrong);
+	static void aesExpand(void) {
+		aesKey(HMKEY, rk);
+	}
+	static void aesEncryptBlock(void) {
+		aesEncrypt(rk, buf);
+	}
+	static void aesDecryptBlock(void) {
+		aesDecrypt(rk, buf);
+	}
+	static void aesChallenge(void) {														// command in, challenge out, temp key kept
+		memcpy(hm.rv.buf, aesCmd, aesCmd[0]+1);
+		run(&BM::sendAES_REQ);
+	}
+	static void aesVerify(void) {															// answer in, checked, command dispatched
+		aesState().active = 1;
+		aesState().time = getMillis();
+		memcpy(hm.rv.buf, aesRpl, aesRpl[0]+1);
+		run(&BM::recvAES_REPLY);
+		aesState().signd = 0;
+	}
+
+	static void loopIdle(void) {															// the main loop of a device with nothing to do
+		hm.poll();
+		addMillis(1);
+	}
+
+	#ifdef _cmDimmer_H
+	static void loopRamp(void) {															// main loop while channel 1 ramps like dimPoll_ramp
+		static uint8_t ramp[] = {0x02,0x80};
+		if ((cnt % 2000) == 0) {
+			cmDimmer[1].trigger11(((cnt / 2000) & 1) ? 0 : 200, ramp, NULL);
+			hm.rg.setDue(1, 0);																// like an event through hmEventCol
+		}
+		cnt++;
+		hm.poll();
+		addMillis(1);
+	}
+	static void dimPollIdle(void) {
+		cmDimmer[1].poll();
+	}
+	static void dimPollRamp(void) {															// ramps up and down over 2 seconds, 1ms per call
+		static uint8_t ramp[] = {0x02,0x80};												// 2s in the ramp time format
+		if ((cnt % 2000) == 0) cmDimmer[1].trigger11(((cnt / 2000) & 1) ? 0 : 200, ramp, NULL);
+		cnt++;
+		cmDimmer[1].poll();
+		addMillis(1);
+	}
+	#endif
+	#ifdef _cmSwitch_H
+	static void rlyPollIdle(void) {
+		cmSwitch[0].poll();
+	}
+	#endif
+};
+uint8_t  BM::buf[MaxDataLen+1];
+uint8_t  BM::plain[MaxDataLen+1];
+uint8_t  BM::coded[MaxDataLen+1];
+uint32_t BM::cnt;
+uint8_t  BM::rfOurs[MaxDataLen+1];
+uint8_t  BM::rfForeign[MaxDataLen+1];
+uint8_t  BM::rk[aesKeyLen];
+uint8_t  BM::aesCmd[MaxDataLen+1];
+uint8_t  BM::aesRpl[MaxDataLen+1];
+
+void BM::aesReply(uint8_t *chl, uint8_t wrong) {
+	// answer of the central to the challenge, see AS::recvAES_REPLY
+	uint8_t tKey[aesBlockLen], p[aesBlockLen];
+	memcpy(tKey, HMKEY, aesBlockLen);
+	for (uint8_t i = 0; i < 6; i++) tKey[i] ^= chl[i];
+	if (wrong) tKey[0] ^= 0x80;
+	aesKey(tKey, rk);
+
+	static const uint8_t own[] = {0xDE,0xAD,0xBE,0xEF,0x12,0x34};
+	memcpy(p, own, 6);
+	memcpy(p+6, aesCmd+1, 10);
+	aesEncrypt(rk, p);
+	for (uint8_t i = 0; i < aesBlockLen; i++) {
+		if ((11+i) <= aesCmd[0]) p[i] ^= aesCmd[11+i];
+	}
+	aesEncrypt(rk, p);
+
+	static const uint8_t h[] = {0x19,0x30,0xA0,0x03,0x63,0x19,0x63};
+	memcpy(aesRpl, h, sizeof(h));
+	memcpy(aesRpl+7, HMID, 3);
+	memcpy(aesRpl+10, p, aesBlockLen);
+}
+uint8_t BM::vectors(void) {
+	// FIPS-197 appendix A.1 (last round key), B and C.1, then a challenge and its answer through AS
+	static const uint8_t k1[] = {0x2b,0x7e,0x15,0x16,0x28,0xae,0xd2,0xa6,0xab,0xf7,0x15,0x88,0x09,0xcf,0x4f,0x3c};
+	static const uint8_t r1[] = {0xd0,0x14,0xf9,0xa8,0xc9,0xee,0x25,0x89,0xe1,0x3f,0x0c,0xc8,0xb6,0x63,0x0c,0xa6};
+	static const uint8_t p1[] = {0x32,0x43,0xf6,0xa8,0x88,0x5a,0x30,0x8d,0x31,0x31,0x98,0xa2,0xe0,0x37,0x07,0x34};
+	static const uint8_t c1[] = {0x39,0x25,0x84,0x1d,0x02,0xdc,0x09,0xfb,0xdc,0x11,0x85,0x97,0x19,0x6a,0x0b,0x32};
+	static const uint8_t k2[] = {0x00,0x01,0x02,0x03,0x04,0x05,0x06,0x07,0x08,0x09,0x0a,0x0b,0x0c,0x0d,0x0e,0x0f};
+	static const uint8_t p2[] = {0x00,0x11,0x22,0x33,0x44,0x55,0x66,0x77,0x88,0x99,0xaa,0xbb,0xcc,0xdd,0xee,0xff};
+	static const uint8_t c2[] = {0x69,0xc4,0xe0,0xd8,0x6a,0x7b,0x04,0x30,0xd8,0xcd,0xb7,0x80,0x70,0xb4,0xc5,0x5a};
+	uint8_t b[aesBlockLen], ok = 1;
+
+	aesKey(k1, rk);
+	if (memcmp(rk+160, r1, aesBlockLen)) ok = 0;
+	memcpy(b, p1, aesBlockLen);
+	aesEncrypt(rk, b);
+	if (memcmp(b, c1, aesBlockLen)) ok = 0;
+	aesDecrypt(rk, b);
+	if (memcmp(b, p1, aesBlockLen)) ok = 0;
+
+	aesKey(k2, rk);
+	memcpy(b, p2, aesBlockLen);
+	aesEncrypt(rk, b);
+	if (memcmp(b, c2, aesBlockLen)) ok = 0;
+	aesDecrypt(rk, b);
+	if (memcmp(b, p2, aesBlockLen)) ok = 0;
+	printf("{\"device\":\"%s\",\"check\":\"fips197\",\"ok\":%u}\n", DEVICE_NAME, ok);
+
+	// the device has to take the right answer with the auth bytes and refuse a wrong one
+	uint8_t sig = 1;
+	for (uint8_t wrong = 0; wrong < 2; wrong++) {
+		aesChallenge();
+		aesReply(hm.sn.buf+11, wrong);
+		aesState().active = 1;
+		memcpy(hm.rv.buf, aesRpl, aesRpl[0]+1);
+		run(&BM::recvAES_REPLY);
+		if (aesState().signd != !wrong) sig = 0;
+		if ((!wrong) && (memcmp(aesState().auth, "\xDE\xAD\xBE\xEF", 4))) sig = 0;
+		aesState().signd = 0;
+	}
+	printf("{\"device\":\"%s\",\"check\":\"signature\",\"ok\":%u}\n", DEVICE_NAME, sig);
+	return ok && sig;
+}
+
+void BM::setup(void) {
+	// a paired device with all but one peer slot of channel 1 in use
+	uint8_t l0[] = {0x0a,0x63, 0x0b,0x19, 0x0c,0x63};
+	hm.ee.setListArray(0, 0, 0, sizeof(l0), l0);
+	hm.ee.getMasterID();
+
+	uint8_t slots = hm.ee.getPeerSlots(1);
+	for (uint8_t i = 0; (i+1) < slots; i++) {
+		uint8_t pe[8] = {0x11,0x22,(uint8_t)(0x30+i),0x01,0x00,};
+		hm.ee.addPeer(1, pe);
+	}
+	flushEEProm(1);
+
+	// a DEVICE_INFO sized frame for decode and encode
+	static const uint8_t f[] = {0x1A,0x01,0x84,0x00,0xAC,0xAF,0xFF,0x63,0x19,0x63,0x15,0x00,0x6C,'X','M','S','2','3','4','5','6','7','8',0x10,0x41,0x01,0x00};
+	memcpy(plain, f, sizeof(f));
+	memcpy(coded, f, sizeof(f));
+	hm.encode(coded);
+
+	// a frame of an unknown sender to us and one to somebody else, both encoded like on air
+	static const uint8_t x[] = {0x0B,0x07,0xA0,0x01,0x44,0x55,0x66,0x11,0x22,0x33,0x01,0x0E};
+	memcpy(rfOurs, x, sizeof(x));
+	memcpy(rfOurs+7, HMID, 3);
+	memcpy(rfForeign, x, sizeof(x));
+	hm.encode(rfOurs);
+	hm.encode(rfForeign);
+
+	// a SET which waits for its signature
+	static const uint8_t c[] = {0x0E,0x30,0xA0,0x11,0x63,0x19,0x63,0xAC,0xAF,0xFF,0x02,0x01,0xC8,0x00,0x00};
+	memcpy(aesCmd, c, sizeof(c));
+	memcpy(aesCmd+7, HMID, 3);
+}
+void BM::aesSetup(void) {
+	// the answer fits to the last challenge, like that aesSign_verify passes every time
+	aesChallenge();
+	aesReply(hm.sn.buf+11, 0);
+	aesKey(HMKEY, rk);
+}
+
+struct s_bench {
+	const char *name;
+	void (*fn)(void);
+};
+static const s_bench bench[] = {
+	{ "decode",               BM::decode },
+	{ "encode",               BM::encode },
+	{ "getIntend_master",     BM::intendMaster },
+	{ "getIntend_peer",       BM::intendPeer },
+	{ "getIntend_unknown",    BM::intendUnknown },
+	{ "getIntend_foreign",    BM::intendForeign },
+	{ "getIdxByPeer_hit",     BM::idxByPeerHit },
+	{ "getIdxByPeer_miss",    BM::idxByPeerMiss },
+	{ "getRegListSlc_l1",     BM::regListSlc1 },
+	{ "getRegListSlc_l3",     BM::regListSlc3 },
+	{ "getPeerListSlc",       BM::peerListSlc },
+	{ "getList_l3",           BM::peerList3 },
+	{ "recvMessage_paramReq", BM::recvParamReq },
+	{ "recvMessage_peerList", BM::recvPeerListReq },
+	{ "recvMessage_unknown",  BM::recvUnknown },
+	{ "rcvFrame_ours",        BM::rcvOurs },
+	{ "rcvFrame_foreign",     BM::rcvForeign },
+	{ "aesKey",               BM::aesExpand },
+	{ "aesEncrypt",           BM::aesEncryptBlock },
+	{ "aesDecrypt",           BM::aesDecryptBlock },
+	{ "aesSign_challenge",    BM::aesChallenge },
+	{ "aesSign_verify",       BM::aesVerify },
+	{ "loop_idle",            BM::loopIdle },
+	#ifdef _cmDimmer_H
+	{ "loop_ramp",            BM::loopRamp },
+	{ "dimPoll_idle",         BM::dimPollIdle },
+	{ "dimPoll_ramp",         BM::dimPollRamp },
+	#endif
+	#ifdef _cmSwitch_H
+	{ "rlyPoll_idle",         BM::rlyPollIdle },
+	#endif
+};
+
+static uint64_t nsNow(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int main(int argc, char **argv) {
+	uint32_t calls = 100000;																// calls per benchmark
+
+	for (int i = 1; i < argc; i++) {
+		if ((!strcmp(argv[i], "-n")) && (i+1 < argc)) calls = atol(argv[++i]);
+	}
+	if (!calls) calls = 1;
+
+	Serial.out = NULL;																		// debug output of the library is not wanted here
+	hostRadioTx(txNone);
+	hm.init();																				// init the asksin framework
+	for (uint16_t i = 0; i < 1000; i++) {													// let the start up settle
+		hm.poll();
+		addMillis(1);
+	}
+	BM::setup();
+	if (!BM::vectors()) return 1;
+	BM::aesSetup();
+
+	for (uint8_t b = 0; b < sizeof(bench)/sizeof(bench[0]); b++) {
+		s_hostStat s0 = hostStat;
+		s_aesStat  a0 = aesStat;
+		s_rgStat   r0 = rgStat;
+		uint64_t t = nsNow();
+		for (uint32_t i = 0; i < calls; i++) bench[b].fn();
+		t = nsNow() - t;
+
+		printf("{\"device\":\"%s\",\"bench\":\"%s\",\"calls\":%u,\"ns\":%.1f,\"eeRd\":%.2f,\"eeRdBytes\":%.2f,\"eeWrBytes\":%.2f,\"spiBytes\":%.2f,\"aesKeys\":%.2f,\"aesBlocks\":%.2f,\"modPolls\":%.2f,\"idleLoops\":%.2f}\n",
+			DEVICE_NAME, bench[b].name, calls, (double)t / calls,
+			(double)(hostStat.eeRdCalls - s0.eeRdCalls) / calls, (double)(hostStat.eeRdBytes - s0.eeRdBytes) / calls,
+			(double)(hostStat.eeWrBytes - s0.eeWrBytes) / calls, (double)(hostStat.spiBytes - s0.spiBytes) / calls,
+			(double)(aesStat.keys - a0.keys) / calls, (double)(aesStat.blocks - a0.blocks) / calls,
+			(double)(rgStat.calls - r0.calls) / calls, (double)(rgStat.idle - r0.idle) / calls);
+	}
+	return 0;
+}
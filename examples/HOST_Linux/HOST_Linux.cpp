@@ -0,0 +1,338 @@
+//- -----------------------------------------------------------------------------------------------------------------------
+// AskSin driver implementation
+// 2013-08-03 <trilu@gmx.de> Creative Commons - http://creativecommons.org/licenses/by-nc-sa/3.0/de/
+//- -----------------------------------------------------------------------------------------------------------------------
+//- AskSin host driver, runs a device from the examples folder as linux process -------------------------------------------
+//- -----------------------------------------------------------------------------------------------------------------------
+//- usage: HOST_Linux [-q] [-e eeprom.bin] [-s settle_ms] [-p power_mode] [-n id[/group]].. [-c capture.bin] [-r capture.bin | file]
+//-   frames are read line by line from file or stdin in the format of .test_commands.txt (decoded, length byte first),
+//-   lines starting with '+' let the given amount of ms pass, '//' lines are comments,
+//-   lines starting with '>' hold a frame which is put into the send queue as if the device would send it,
+//-   lines starting with '~' hold a frame which comes with 360ms of burst preamble, like the central wakes up a device
+//-   a line with '*' answers the last AES challenge of the device like the central does it, with HMKEY and the last frame
+//-   of the file. '*!' sends a wrong answer
+//-   a line '!cnl' is a key press on the channel, the device sends a REMOTE to every peer of the channel
+//-   -n adds a simulated node which answers the BIDI frames of the device to its id with an ACK_STATUS. with /group the
+//-   node is member of the group as well and answers frames to the group in its reply slot, the slots are counted in the
+//-   order of the -n options. the air time of the device and of the nodes is part of the statistics
+//-   -c records every frame on air into a binary capture, see RF_CAP in HAL.h. -r replays the received frames of such a
+//-   capture with their original timing, the virtual clock lets a whole night run through at full speed
+//-   the frame debugs on stdout are binary trace records, HOST_Linux file | HOST_Trace turns them into text again
+//- -----------------------------------------------------------------------------------------------------------------------
+
+#include <time.h>
+#include <AS.h>																				// the asksin framework
+#include "register.h"																		// configuration sheet of the device, see Makefile
+
+//- hardware.cpp replacement ----------------------------------------------------------------------------------------------
+void    initWakeupPin(void) {
+}
+uint8_t checkWakeupPin(void) {
+	return 0;																				// normal operation
+}
+
+//- user functions of the examples ----------------------------------------------------------------------------------------
+void initDim(uint8_t channel) {
+}
+void switchDim(uint8_t channel, uint8_t status, uint8_t characteristic) {
+	printf("   switchDim: %d, %d, %d (%u)\n", channel, status, characteristic, getMillis());
+}
+void initRly(uint8_t channel) {
+}
+void switchRly(uint8_t channel, uint8_t status) {
+	printf("   switchRly: %d, %d (%u)\n", channel, status, getMillis());
+}
+void initBlind(uint8_t channel) {
+}
+void switchBlind(uint8_t channel, uint8_t status) {
+	printf("   switchBlind: %d, %d (%u)\n", channel, status, getMillis());
+}
+
+//- host driver -----------------------------------------------------------------------------------------------------------
+struct s_loopStat {
+	uint32_t cnt;																			// loop iterations
+	uint64_t sumNs;																			// cpu time spent in hm.poll()
+	uint64_t maxNs;																			// worst single hm.poll()
+	uint32_t maxStallUs;																	// most virtual time spent within one hm.poll()
+} loopStat;
+
+static uint64_t nsNow(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#define HOST_NODES    8																		// simulated nodes
+#define HOST_TURN     5																		// ms a node needs for its answer
+struct s_node {
+	uint8_t  id[3];
+	uint8_t  grp[3];																		// group the node is member of, 0 for none
+	uint8_t  slot;																			// reply slot in the group
+	uint32_t due;																			// ms when the ACK goes out, 0 for none
+	uint8_t  ack[16];																		// the ACK, decoded
+} node[HOST_NODES];
+uint8_t nodeCnt;
+
+struct s_airStat {
+	uint32_t devUs;																			// air time of the device, frames and burst preambles
+	uint32_t nodeUs;																		// ...and of the simulated nodes
+	uint32_t nodeFrames;
+} airStat;
+
+static uint8_t lastCmd[64];																	// last frame of the file, the central sent it
+static uint8_t lastChl[64];																	// last AES challenge of the device
+
+static void txFrame(uint8_t *buf, uint8_t burst) {
+	uint8_t x[64];
+	memcpy(x, buf, buf[0]+1);
+	AS::decode(x);
+	if ((x[0] == 0x11) && (x[3] == 0x02) && (x[10] == 0x04)) memcpy(lastChl, x, x[0]+1);
+	airStat.devUs += (x[0] + 11) * 800 + (burst ? 360000 : 0);
+
+	for (uint8_t i = 0; (i < nodeCnt) && (x[2] & 0x20); i++) {								// nodes the frame asks for an ACK
+		s_node *n = &node[i];
+		uint32_t wait;
+		if      (!memcmp(x+7, n->id, 3)) wait = HOST_TURN;
+		else if ((!isEmpty(n->grp, 3)) && (!memcmp(x+7, n->grp, 3))) wait = HOST_TURN + n->slot * grpSlotTime;
+		else continue;
+
+		uint8_t a[] = { 0x0E, x[1], 0x80, 0x02, n->id[0], n->id[1], n->id[2], x[4], x[5], x[6], 0x01, (uint8_t)(x[10] & 0x3f), 0xC8, 0x00, 0x40 };
+		memcpy(n->ack, a, sizeof(a));
+		n->due = getMillis() + wait;
+	}
+
+	printf("TX ");
+	for (uint8_t i = 0; i <= x[0]; i++) printf("%02X ", x[i]);
+	printf("(%u)%s\n", getMillis(), burst ? " burst" : "");
+}
+
+static void nodePoll(void) {
+	// the ACKs of the simulated nodes go on air when they are due, the radio model sorts out what the device hears
+	for (uint8_t i = 0; i < nodeCnt; i++) {
+		s_node *n = &node[i];
+		if ((!n->due) || ((int32_t)(getMillis() - n->due) < 0)) continue;
+		n->due = 0;
+
+		printf("RX ");
+		for (uint8_t j = 0; j <= n->ack[0]; j++) printf("%02X ", n->ack[j]);
+		printf("(%u)\n", getMillis());
+
+		airStat.nodeUs += (n->ack[0] + 11) * 800;
+		airStat.nodeFrames++;
+		AS::encode(n->ack);
+		hostRadioRcv(n->ack, 0x20, 0x30);
+	}
+}
+
+static void runLoop(uint32_t ms) {
+	// every loop iteration takes 1ms of virtual time, real cpu time and virtual time (delays, the stall) are measured
+	// around hm.poll()
+	uint32_t end = getMillis() + ms;
+	hostSleepLimit(end);																	// a sleep without watchdog gives the control back at the end
+	while ((int32_t)(end - getMillis()) > 0) {
+		if (nodeCnt) nodePoll();
+		uint64_t t = nsNow();
+		uint32_t v = hostMicros();
+		hm.poll();
+		v = hostMicros() - v;
+		t = nsNow() - t;
+
+		loopStat.cnt++;
+		loopStat.sumNs += t;
+		if (t > loopStat.maxNs) loopStat.maxNs = t;
+		if (v > loopStat.maxStallUs) loopStat.maxStallUs = v;
+		addMillis(1);
+	}
+}
+
+static uint32_t replay(FILE *in, uint32_t *txRec) {
+	// the received frames go through the radio model at the distance they had in the capture. a capture holds the time of
+	// the end of packet, so the frame is queued its air time before. the sent frames of the capture are counted only, the
+	// device sends its own ones
+	uint8_t hdr[8], buf[64];
+	uint32_t rxRec = 0, offset = 0;
+	int c;
+
+	while ((c = fgetc(in)) != EOF) {
+		if (c != CAP_SYNC) continue;														// resync on a broken record
+		hdr[0] = c;
+		if (fread(hdr+1, 1, sizeof(hdr)-1, in) != sizeof(hdr)-1) break;
+		if (fread(buf, 1, 1, in) != 1) break;
+		if ((buf[0] < 9) || (buf[0] >= sizeof(buf)) || (fread(buf+1, 1, buf[0], in) != buf[0])) break;
+
+		uint32_t t = hdr[1] | ((uint32_t)hdr[2] << 8) | ((uint32_t)hdr[3] << 16) | ((uint32_t)hdr[4] << 24);
+		uint32_t air = (((uint32_t)buf[0] + 11) * 800 + 999) / 1000;
+		if (!(rxRec + *txRec)) offset = getMillis() + air - t;								// first record starts now
+		if (hdr[5] & CAP_TX) { (*txRec)++; continue; }
+
+		int32_t wait = (int32_t)(t + offset - air - getMillis());
+		if (wait > 0) runLoop(wait);
+
+		uint8_t x[64];
+		memcpy(x, buf, buf[0]+1);
+		AS::decode(x);
+		printf("RX ");
+		for (uint8_t i = 0; i <= x[0]; i++) printf("%02X ", x[i]);
+		printf("(%u)\n", getMillis());
+
+		uint8_t rssi = (hdr[6] > 72) ? (hdr[6] - 72) * 2 : 0;								// back to the register value of the cc1101
+		hostRadioRcv(buf, rssi, hdr[7] & 0x7F);
+		rxRec++;
+	}
+	return rxRec;
+}
+
+static uint8_t aesReply(uint8_t *buf, uint8_t wrong) {
+	// the part of the central: 6 byte of its own and byte 1 to 10 of the command are encrypted with the temp key, the
+	// payload of the command is xored and the result encrypted again. the 6 byte come back as auth bytes of the ACK
+	if ((!lastChl[0]) || (!lastCmd[0])) return 0;
+
+	uint8_t tKey[aesBlockLen], rk[aesKeyLen], p[aesBlockLen];
+	memcpy(tKey, HMKEY, aesBlockLen);
+	for (uint8_t i = 0; i < 6; i++) tKey[i] ^= lastChl[11+i];
+	if (wrong) tKey[15] ^= 0x01;
+	aesKey(tKey, rk);
+
+	tMillis t = getMillis();
+	memset(p, 0, sizeof(p));
+	memcpy(p, &t, sizeof(t));
+	p[4] = 0xA5; p[5] = 0x5A;
+	memcpy(p+6, lastCmd+1, 10);
+	aesEncrypt(rk, p);
+	for (uint8_t i = 0; i < aesBlockLen; i++) {
+		if ((11+i) <= lastCmd[0]) p[i] ^= lastCmd[11+i];
+	}
+	aesEncrypt(rk, p);
+
+	buf[0] = 0x19;
+	buf[1] = lastCmd[1];
+	buf[2] = 0xA0;
+	buf[3] = 0x03;
+	memcpy(buf+4, lastCmd+4, 6);															// same sender and receiver as the command
+	memcpy(buf+10, p, aesBlockLen);
+	lastChl[0] = 0;
+	return buf[0]+1;
+}
+
+static uint8_t parseLine(char *line, uint8_t *buf) {
+	uint8_t len = 0, nib = 0, hi = 0;
+	for (char *c = line; *c && (len < 64); c++) {
+		uint8_t v;
+		if      ((*c >= '0') && (*c <= '9')) v = *c - '0';
+		else if ((*c >= 'a') && (*c <= 'f')) v = *c - 'a' + 10;
+		else if ((*c >= 'A') && (*c <= 'F')) v = *c - 'A' + 10;
+		else continue;
+
+		if (nib++ % 2 == 0) hi = v << 4;
+		else buf[len++] = hi | v;
+	}
+	return len;
+}
+
+int main(int argc, char **argv) {
+	uint32_t settle = 1000;																	// virtual ms to run after each frame
+	int      pwrMode = -1;																	// keep the one of register.h
+	FILE *in = stdin, *rep = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		if      (!strcmp(argv[i], "-q")) Serial.out = NULL;
+		else if ((!strcmp(argv[i], "-e")) && (i+1 < argc)) hostEEPromFile(argv[++i]);
+		else if ((!strcmp(argv[i], "-s")) && (i+1 < argc)) settle = atol(argv[++i]);
+		else if ((!strcmp(argv[i], "-p")) && (i+1 < argc)) pwrMode = atoi(argv[++i]);
+		else if ((!strcmp(argv[i], "-c")) && (i+1 < argc)) hostCaptureFile(argv[++i]);
+		else if ((!strcmp(argv[i], "-n")) && (i+1 < argc) && (nodeCnt < HOST_NODES)) {
+			s_node *n = &node[nodeCnt++];
+			uint8_t id[64];
+			uint8_t len = parseLine(argv[++i], id);
+			memcpy(n->id, id, 3);
+			if (len < 6) continue;
+			memcpy(n->grp, id+3, 3);
+			for (uint8_t j = 0; j < nodeCnt-1; j++) n->slot += (!memcmp(node[j].grp, n->grp, 3));	// members before this one
+		}
+		else if ((!strcmp(argv[i], "-r")) && (i+1 < argc)) { if (!(rep = fopen(argv[++i], "rb"))) { perror(argv[i]); return 1; } }
+		else if (!(in = fopen(argv[i], "r"))) { perror(argv[i]); return 1; }
+	}
+
+	hostRadioTx(txFrame);
+	hm.init();																				// init the asksin framework
+	if (pwrMode >= 0) hm.pw.setMode(pwrMode);
+	runLoop(settle);
+
+	char line[256];
+	uint8_t buf[64];
+	uint32_t frames = 0;
+	if (rep) {																				// replay a capture instead of reading frames
+		uint32_t txRec = 0;
+		uint64_t t = nsNow();
+		frames = replay(rep, &txRec);
+		runLoop(settle);
+		t = nsNow() - t;
+		fprintf(stderr, "\nreplay: %u rx and %u tx records, cpu %.1f ms, %.0f frames/s\n", frames, txRec, t / 1e6, t ? frames * 1e9 / t : 0.0);
+		in = NULL;
+	}
+	while ((in) && (fgets(line, sizeof(line), in))) {
+		if ((line[0] == '/') || (line[0] == '\n') || (line[0] == '\r')) continue;			// comment or empty line
+		if (line[0] == '+') { runLoop(atol(line+1)); continue; }							// let time pass
+		if (line[0] == '!') {																// key press, the device sends to its peers
+			static uint8_t key[2];
+			key[0]++;																		// key press counter
+			hm.sendREMOTE(atoi(line+1), 0, key);
+			runLoop(settle);
+			continue;
+		}
+
+		uint8_t snd = (line[0] == '>');
+		uint8_t burst = (line[0] == '~');
+		uint8_t len;
+		if (line[0] == '*') {																// answer of the central to the challenge
+			if (!(len = aesReply(buf, line[1] == '!'))) {
+				fprintf(stderr, "skip, no challenge: %s", line);
+				continue;
+			}
+		} else len = parseLine(line + snd + burst, buf);
+		if ((len < 10) || (buf[0] != len-1)) {
+			fprintf(stderr, "skip, length mismatch: %s", line);
+			continue;
+		}
+		if ((!snd) && (buf[3] != 0x03)) memcpy(lastCmd, buf, len);
+
+		if (snd) {																			// device sends, like a key press would do it
+			memcpy(hm.sn.buf, buf, len);
+			hm.sn.push(sndPrioPeer);
+			memset(hm.sn.buf, 0, len);														// flags would stick for the next frames otherwise
+			runLoop(settle);
+			continue;
+		}
+
+		printf("RX ");
+		for (uint8_t i = 0; i < len; i++) printf("%02X ", buf[i]);
+		printf("(%u)%s\n", getMillis(), burst ? " burst" : "");
+
+		AS::encode(buf);
+		hostRadioRcv(buf, 0x20, 0x30, burst);
+		frames++;
+		runLoop(settle);
+	}
+
+	fprintf(stderr, "\nframes in: %u, rx: %u, lost: %u, tx: %u (burst %u)\n", frames, hostStat.rfRxFrames, hostStat.rfRxLost, hostStat.rfTxFrames, hostStat.rfTxBursts);
+	fprintf(stderr, "loops: %u, virtual time: %u ms, sleep: %u ms\n", loopStat.cnt, getMillis(), hostStat.sleepMs);
+	fprintf(stderr, "power: mcu run %llu ms, sleep %llu ms, cc1101 rx %llu ms, tx %llu ms, idle %llu ms, off %llu ms, wor %llu ms\n",
+		hostPower.mcuUs[0] / 1000, (hostPower.mcuUs[1] + hostPower.mcuUs[2]) / 1000, hostPower.ccUs[0] / 1000, hostPower.ccUs[1] / 1000,
+		hostPower.ccUs[2] / 1000, hostPower.ccUs[3] / 1000, hostPower.ccUs[4] / 1000);
+	fprintf(stderr, "wake on radio: %u polls, %u wakes, average current: %.1f uA\n", hostPower.worPolls, hostPower.worWakes, hostPowerAvg());
+	fprintf(stderr, "module polls: %u in %u loops, idle loops: %u\n", rgStat.calls, rgStat.loops, rgStat.idle);
+	fprintf(stderr, "poll avg: %.3f us, max: %.3f us, stall max: %.1f ms\n", loopStat.cnt ? loopStat.sumNs / 1000.0 / loopStat.cnt : 0.0, loopStat.maxNs / 1000.0, loopStat.maxStallUs / 1000.0);
+	fprintf(stderr, "eeprom rd: %u byte, wr: %u byte, spi: %u byte\n", hostStat.eeRdBytes, hostStat.eeWrBytes, hostStat.spiBytes);
+	fprintf(stderr, "eeprom set: %u byte, unchanged: %u byte, written: %u byte, buffer max: %u\n", eeWrStat.setBytes, eeWrStat.skipBytes, eeWrStat.wrBytes, eeWrStat.bufMax);
+	fprintf(stderr, "eeprom write cycles: %u, cache reads: %u, misses: %u, i2c: %u byte\n", hostStat.eeWrCycles, eeRdStat.reads, eeRdStat.misses, hostStat.i2cBytes);
+	fprintf(stderr, "list cache hits: %u, misses: %u\n", lstStat.hits, lstStat.misses);
+	fprintf(stderr, "actuator status: %u reports, %u frames, held back %u times\n", stsStat.in, stsStat.out, stsStat.held);
+	fprintf(stderr, "send queue max: %u, dropped: %u\n", hm.sn.queMax, hm.sn.queDrop);
+	fprintf(stderr, "receive ring max: %u, dropped: %u\n", hm.rv.ringMax, hm.rv.ringOvr);
+	fprintf(stderr, "receive skipped: %u frames, %u spi byte\n", hm.cc.rxSkip, hm.cc.rxSkipBytes);
+	fprintf(stderr, "timers armed: %u (max %u), late: %u (max %u ms)\n", tmrStat.armed, tmrStat.armedMax, tmrStat.late, tmrStat.lateMax);
+	fprintf(stderr, "aes keys: %u, blocks: %u\n", aesStat.keys, aesStat.blocks);
+	fprintf(stderr, "air time: device %u ms, nodes %u ms in %u ACKs\n", (airStat.devUs + 500) / 1000, (airStat.nodeUs + 500) / 1000, airStat.nodeFrames);
+	fprintf(stderr, "trace records: %u, dropped: %u, ring max: %u byte, uart: %u byte\n", trcStat.recs, trcStat.drop, trcStat.fillMax, hostStat.uartBytes);
+	return 0;
+}
@@ -0,0 +1,115 @@
+//- -----------------------------------------------------------------------------------------------------------------------
+// AskSin driver implementation
+// 2013-08-03 <trilu@gmx.de> Creative Commons - http://creativecommons.org/licenses/by-nc-sa/3.0/de/
+//- -----------------------------------------------------------------------------------------------------------------------
+//- AskSin trace decoder, turns the serial output of a device back into the text of the debug messages -------------------
+//- -----------------------------------------------------------------------------------------------------------------------
+//- usage: HOST_Trace [-x] [file]
+//-   reads the serial output from file or stdin, like a log of the serial port or the output of HOST_Linux. text passes
+//-   through, trace records (see Trace.h) are printed as the debug message they stand for. -x adds the explainMessage
+//-   lines to the received frames, like RV_DBG_EX did it
+//- -----------------------------------------------------------------------------------------------------------------------
+
+#include <AS.h>																				// the asksin framework
+#include "register.h"																		// configuration sheet of the device, see Makefile
+
+//- hardware.cpp replacement ----------------------------------------------------------------------------------------------
+void    initWakeupPin(void) {
+}
+uint8_t checkWakeupPin(void) {
+	return 0;																				// normal operation
+}
+
+//- user functions of the examples, never called --------------------------------------------------------------------------
+void initDim(uint8_t channel) {
+}
+void switchDim(uint8_t channel, uint8_t status, uint8_t characteristic) {
+}
+void initRly(uint8_t channel) {
+}
+void switchRly(uint8_t channel, uint8_t status) {
+}
+void initBlind(uint8_t channel) {
+}
+void switchBlind(uint8_t channel, uint8_t status) {
+}
+
+//- decoder ---------------------------------------------------------------------------------------------------------------
+class TD {
+  public:
+	static uint8_t explain;
+
+	static void hex(uint8_t *data, uint8_t len) {											// same as _HEX, plus a mark for shortened frames
+		for (uint8_t i = 0; i < len; i++) printf(i ? " %02X" : "%02X", data[i]);
+		if ((len) && (len < data[0]+1)) printf(" ..");
+	}
+	static void frame(const char *pre, uint8_t *data, uint8_t len, uint32_t t) {
+		printf("%s", pre);
+		hex(data, len);
+		printf(" (%u)\n", t);
+	}
+	static void record(uint8_t *h, uint8_t *data) {
+		uint8_t  evt = h[1], arg = h[2], len = h[7];
+		uint32_t t = h[3] | ((uint32_t)h[4] << 8) | ((uint32_t)h[5] << 16) | ((uint32_t)h[6] << 24);
+		char pre[4] = { (char)arg, '>', ' ', 0 };
+
+		switch (evt) {
+		case TRC_RV_FRAME:
+			frame(pre, data, len, t);
+			if ((explain) && (len) && (len == data[0]+1)) hm.explainMessage(data);			// prints with dbg, which is stdout as well
+			break;
+		case TRC_RV_REPEAT:
+			printf("  repeated message\n");
+			break;
+		case TRC_SN_DROP:
+			frame("<x ", data, len, t);
+			break;
+		case TRC_SN_INT:
+			frame("<i ", data, len, t);
+			break;
+		case TRC_SN_TX:
+			frame("<- ", data, len, t);
+			break;
+		case TRC_SN_TOUT:
+			printf("  timed out (%u)\n", t);
+			break;
+		case TRC_AS_PEER:
+			if (len >= 2) printf("a: %u m %u\n", data[0], data[1]);
+			break;
+		case TRC_AS_SLICE:
+			if (len >= 3) printf("cnl: %u s: %u\ntotSlc: %u\n", data[0], data[1], data[2]);
+			break;
+		case TRC_AS_AES:
+			printf("aes: %s (%u)\n", arg ? "ok" : "failed", t);
+			break;
+		default:
+			printf("?%02X ", evt);
+			frame("", data, len, t);
+		}
+	}
+};
+uint8_t TD::explain;
+
+int main(int argc, char **argv) {
+	FILE *in = stdin;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-x")) TD::explain = 1;
+		else if (!(in = fopen(argv[i], "rb"))) { perror(argv[i]); return 1; }
+	}
+
+	uint8_t h[TRC_REC_HDR], data[256];
+	int c;
+	while ((c = fgetc(in)) != EOF) {
+		if (c != TRC_SYNC) {																// plain text of the dbg messages
+			putchar(c);
+			continue;
+		}
+		h[0] = c;
+		if (fread(h+1, 1, TRC_REC_HDR-1, in) != TRC_REC_HDR-1) break;
+		if (fread(data, 1, h[7], in) != h[7]) break;
+		TD::record(h, data);
+	}
+	fflush(stdout);
+	return 0;
+}